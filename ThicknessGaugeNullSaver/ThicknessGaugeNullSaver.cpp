@@ -1,14 +1,15 @@
 // ThicknessGaugeNullSaver.cpp : Defines the entry point for the console application.
 //
 #include "stdafx.h"
+#include <chrono>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <opencv2/core/mat.hpp>
-#include <opencv2/videoio.hpp>
-#include <opencv2/videoio/videoio_c.h>
 #include <opencv2/imgcodecs.hpp>
+#include "Camera/CaptureSource.h"
 
-void save_null() {
+void save_null(const std::string& source) {
 
     std::string filename;
 
@@ -24,18 +25,52 @@ void save_null() {
     std::cout << "Enter delay in seconds before capture to " << filename << "\n>";
     int t;
     std::cin >> t;
+
+    // same capture backends as the gauge, the full sensor is captured
+    auto cap = capture_source(source);
+
+    if (cap == nullptr) {
+        std::cout << "Unknown capture source " << source << ".\n";
+        return;
+    }
+
+    if (!cap->initialize()) {
+        std::cout << "Capture device " << cap->name() << " could not be initialized.\n";
+        return;
+    }
+
+    if (!cap->open()) {
+        std::cout << "Capture device " << cap->name() << " could not be opened.\n";
+        cap->uninitialize();
+        return;
+    }
+
+    cap->prepare();
+    cap->region(cap->default_roi_full);
+    cap->frame_init();
+    cap->cap_init();
+    cap->aquisition_init();
+
+    std::this_thread::sleep_for(std::chrono::seconds(t));
+
     cv::Mat nullImage;
-    cv::VideoCapture cap;
-    cap.open(CV_CAP_PVAPI);
-    cap >> nullImage;
-    cv::imwrite(filename, nullImage);
-    cap.release();
+    cap->cap_single(nullImage);
+
+    if (nullImage.empty())
+        std::cout << "No frame was captured.\n";
+    else
+        cv::imwrite(filename, nullImage);
+
+    cap->aquisition_end();
+    cap->cap_end();
+    cap->close();
+    cap->uninitialize();
 }
 
-// simple application to generate null image files.
-int main() {
+// simple application to generate null image files, the capture source is the same as the gauge's --capture (default pvapi).
+int main(int argc, char** argv) {
 
-    save_null();
+    save_null(argc > 1 ? argv[1] : "pvapi");
 
     return 0;
 }
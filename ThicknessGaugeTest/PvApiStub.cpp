@@ -0,0 +1,379 @@
+#include "stdafx.h"
+#include "PvApiStub.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <PvApi.h>
+
+namespace {
+
+    struct Queued {
+        tPvFrame* frame;
+        tPvFrameCallback callback;
+    };
+
+    /**
+     * \brief The simulated sensor, runs free and fills the oldest queued buffer each frame period
+     */
+    class Sensor {
+
+        std::mutex mutex_;
+
+        std::condition_variable changed_;
+
+        std::deque<Queued> queue_;
+
+        // frames that completed without a callback, for PvCaptureWaitForFrameDone
+        std::vector<const tPvFrame*> done_;
+
+        std::thread thread_;
+
+        bool stop_ = false;
+
+        // set by configure, frames can be queued from then on
+        bool configured_ = false;
+
+        unsigned long width_ = 0;
+
+        unsigned long height_ = 0;
+
+        std::chrono::microseconds period_{1000};
+
+        std::chrono::steady_clock::time_point started_;
+
+        unsigned long fail_every_ = 0;
+
+        unsigned long frame_count_ = 0;
+
+        std::atomic<unsigned long> completed_{0};
+
+        std::atomic<unsigned long> lost_{0};
+
+        /**
+         * \brief Exposes one frame into the oldest queued buffer, requires the lock, which is released for the transfer
+         */
+        void complete(std::unique_lock<std::mutex>& lock) {
+            auto count = ++frame_count_;
+            auto fail_every = fail_every_;
+            if (queue_.empty()) {
+                ++lost_;
+                return;
+            }
+
+            auto target = queue_.front();
+            queue_.pop_front();
+
+            // the transfer into the buffer happens outside the lock, like the driver does
+            lock.unlock();
+
+            auto frame = target.frame;
+            auto size = width_ * height_;
+            if (size <= frame->ImageBufferSize)
+                std::memset(frame->ImageBuffer, static_cast<int>(count & 0xff), size);
+
+            frame->Width = width_;
+            frame->Height = height_;
+            frame->ImageSize = size;
+            frame->BitDepth = 8;
+            frame->Format = ePvFmtMono8;
+            frame->FrameCount = count;
+            auto stamp = timestamp();
+            frame->TimestampLo = static_cast<unsigned long>(stamp & 0xffffffff);
+            frame->TimestampHi = static_cast<unsigned long>(stamp >> 32);
+            frame->Status = size > frame->ImageBufferSize ? ePvErrDataLost
+                            : fail_every > 0 && count % fail_every == 0 ? ePvErrDataMissing
+                            : ePvErrSuccess;
+
+            ++completed_;
+
+            if (target.callback)
+                target.callback(frame);
+
+            lock.lock();
+            if (!target.callback) {
+                done_.emplace_back(frame);
+                changed_.notify_all();
+            }
+        }
+
+        void run() {
+            auto next = std::chrono::steady_clock::now();
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true) {
+                next += period_;
+                if (changed_.wait_until(lock, next, [this] { return stop_; }))
+                    return;
+                complete(lock);
+            }
+        }
+
+    public:
+
+        ~Sensor() {
+            stop();
+        }
+
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            changed_.notify_all();
+            if (thread_.joinable())
+                thread_.join();
+        }
+
+        void configure(unsigned long width, unsigned long height, std::chrono::microseconds period) {
+            stop();
+            cancel();
+
+            width_ = width;
+            height_ = height;
+            period_ = period;
+            fail_every_ = 0;
+            frame_count_ = 0;
+            completed_ = 0;
+            lost_ = 0;
+            stop_ = false;
+            configured_ = true;
+            done_.clear();
+
+            started_ = std::chrono::steady_clock::now();
+            if (period.count() > 0)
+                thread_ = std::thread(&Sensor::run, this);
+        }
+
+        void expose(unsigned long frames) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (frames-- > 0)
+                complete(lock);
+        }
+
+        void fail_every(unsigned long n) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            fail_every_ = n;
+        }
+
+        tPvErr queue(tPvFrame* frame, tPvFrameCallback callback) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!configured_)
+                return ePvErrBadSequence;
+            queue_.emplace_back(Queued{frame, callback});
+            return ePvErrSuccess;
+        }
+
+        void cancel() {
+            std::deque<Queued> cancelled;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                cancelled.swap(queue_);
+            }
+
+            for (auto& queued : cancelled) {
+                queued.frame->Status = ePvErrCancelled;
+                if (queued.callback)
+                    queued.callback(queued.frame);
+            }
+        }
+
+        tPvErr wait(const tPvFrame* frame, unsigned long timeout) {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            auto found = [this, frame] {
+                for (auto it = done_.begin(); it != done_.end(); ++it) {
+                    if (*it == frame) {
+                        done_.erase(it);
+                        return true;
+                    }
+                }
+                return false;
+            };
+
+            return changed_.wait_for(lock, std::chrono::milliseconds(timeout), found) ? ePvErrSuccess : ePvErrTimeout;
+        }
+
+        unsigned long completed() const {
+            return completed_;
+        }
+
+        unsigned long lost() const {
+            return lost_;
+        }
+
+        uint64_t timestamp() const {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started_).count();
+        }
+
+    };
+
+    Sensor sensor;
+
+    const unsigned long sensor_width = 2448;
+
+    const unsigned long sensor_height = 2040;
+
+    /**
+     * \brief The attribute table of the camera
+     */
+    class Attributes {
+
+        std::mutex mutex_;
+
+        std::map<std::string, unsigned long> values_;
+
+        std::map<std::string, unsigned long> reads_;
+
+        std::map<std::string, unsigned long> writes_;
+
+        std::string failing_;
+
+        bool fits(const std::string& name, unsigned long value) {
+            auto x = name == "RegionX" ? value : values_["RegionX"];
+            auto y = name == "RegionY" ? value : values_["RegionY"];
+            auto width = name == "Width" ? value : values_["Width"];
+            auto height = name == "Height" ? value : values_["Height"];
+            return width > 0 && height > 0 && x + width <= sensor_width && y + height <= sensor_height;
+        }
+
+    public:
+
+        Attributes() {
+            reset();
+        }
+
+        void reset() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            values_ = {
+                { "RegionX", 0 }, { "RegionY", 0 }, { "Width", sensor_width }, { "Height", sensor_height },
+                { "ExposureValue", 10000 }, { "GainValue", 0 }
+            };
+            reads_.clear();
+            writes_.clear();
+            failing_.clear();
+        }
+
+        void fail_writes(const char* name) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            failing_ = name ? name : "";
+        }
+
+        tPvErr get(const char* name, unsigned long* value) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++reads_[name];
+            auto it = values_.find(name);
+            if (it == values_.end())
+                return ePvErrNotFound;
+            *value = it->second;
+            return ePvErrSuccess;
+        }
+
+        tPvErr set(const char* name, unsigned long value) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++writes_[name];
+            if (failing_ == name)
+                return ePvErrCameraFault;
+            if (values_.find(name) == values_.end())
+                return ePvErrNotFound;
+            if (!fits(name, value))
+                return ePvErrOutOfRange;
+            values_[name] = value;
+            return ePvErrSuccess;
+        }
+
+        unsigned long reads(const char* name) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return reads_[name];
+        }
+
+        unsigned long writes(const char* name) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return writes_[name];
+        }
+
+        unsigned long value(const char* name) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return values_[name];
+        }
+
+    };
+
+    Attributes attributes;
+
+}
+
+namespace pvstub {
+
+    void configure(unsigned long width, unsigned long height, std::chrono::microseconds frame_period) {
+        sensor.configure(width, height, frame_period);
+    }
+
+    void fail_every(unsigned long n) {
+        sensor.fail_every(n);
+    }
+
+    void expose(unsigned long frames) {
+        sensor.expose(frames);
+    }
+
+    unsigned long frames_completed() {
+        return sensor.completed();
+    }
+
+    unsigned long frames_lost() {
+        return sensor.lost();
+    }
+
+    uint64_t timestamp() {
+        return sensor.timestamp();
+    }
+
+    void reset_attributes() {
+        attributes.reset();
+    }
+
+    void fail_writes(const char* name) {
+        attributes.fail_writes(name);
+    }
+
+    unsigned long attribute_reads(const char* name) {
+        return attributes.reads(name);
+    }
+
+    unsigned long attribute_writes(const char* name) {
+        return attributes.writes(name);
+    }
+
+    unsigned long attribute(const char* name) {
+        return attributes.value(name);
+    }
+
+}
+
+tPvErr PVDECL PvCaptureQueueFrame(tPvHandle /*Camera*/, tPvFrame* pFrame, tPvFrameCallback Callback) {
+    return sensor.queue(pFrame, Callback);
+}
+
+tPvErr PVDECL PvCaptureQueueClear(tPvHandle /*Camera*/) {
+    sensor.cancel();
+    return ePvErrSuccess;
+}
+
+tPvErr PVDECL PvCaptureWaitForFrameDone(tPvHandle /*Camera*/, const tPvFrame* pFrame, unsigned long Timeout) {
+    return sensor.wait(pFrame, Timeout);
+}
+
+tPvErr PVDECL PvAttrUint32Get(tPvHandle /*Camera*/, const char* Name, tPvUint32* pValue) {
+    return attributes.get(Name, pValue);
+}
+
+tPvErr PVDECL PvAttrUint32Set(tPvHandle /*Camera*/, const char* Name, tPvUint32 Value) {
+    return attributes.set(Name, Value);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+/**
+ * \brief Simulated PvAPI camera for the capture tests, linked instead of the PvAPI library.
+ * Implements the frame queue functions of PvApi.h, the sensor completes one frame every frame period
+ * into the oldest queued buffer, from its own thread, like the driver does.
+ * A frame period without a queued buffer is lost, as it is on the camera.
+ * Frames are stamped with the sensor clock in microseconds when they complete.
+ * The unsigned integer attributes are kept in a table, region writes that do not fit on the 2448 x 2040 sensor
+ * fail with ePvErrOutOfRange like they do on the camera.
+ */
+namespace pvstub {
+
+    /**
+     * \brief Configures the simulated sensor and clears all counters
+     * \param width The frame width
+     * \param height The frame height
+     * \param frame_period The time between two frames, zero only exposes frames on expose()
+     */
+    void configure(unsigned long width, unsigned long height, std::chrono::microseconds frame_period);
+
+    /**
+     * \brief Exposes frames right away on the calling thread, the callbacks have returned when this does
+     */
+    void expose(unsigned long frames);
+
+    /**
+     * \brief Makes every n-th frame complete with ePvErrDataMissing, 0 disables it
+     */
+    void fail_every(unsigned long n);
+
+    /**
+     * \brief The number of frames delivered to a buffer
+     */
+    unsigned long frames_completed();
+
+    /**
+     * \brief The number of frames lost because no buffer was queued
+     */
+    unsigned long frames_lost();
+
+    /**
+     * \brief The sensor clock, microseconds since configure()
+     */
+    uint64_t timestamp();
+
+    /**
+     * \brief Resets the attributes to a full sensor region and clears the attribute counters
+     */
+    void reset_attributes();
+
+    /**
+     * \brief Makes writes of an attribute fail with ePvErrCameraFault, nullptr stops it
+     */
+    void fail_writes(const char* name);
+
+    /**
+     * \brief The number of PvAttrUint32Get calls for an attribute
+     */
+    unsigned long attribute_reads(const char* name);
+
+    /**
+     * \brief The number of PvAttrUint32Set calls for an attribute
+     */
+    unsigned long attribute_writes(const char* name);
+
+    /**
+     * \brief The value of an attribute as the camera has it
+     */
+    unsigned long attribute(const char* name);
+
+}
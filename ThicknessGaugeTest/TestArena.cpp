@@ -0,0 +1,66 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include "../testOpenCV/Util/Arena.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(ARENA_TEST) {
+
+    public:
+
+        TEST_METHOD(AllocationsAreAligned) {
+            Arena arena(256);
+            arena.allocate(1, 1);
+            auto p = arena.allocate(sizeof(double), alignof(double));
+            Assert::AreEqual(static_cast<uintptr_t>(0), reinterpret_cast<uintptr_t>(p) % alignof(double));
+
+            auto large = arena.allocate(1000, 64);
+            Assert::AreEqual(static_cast<uintptr_t>(0), reinterpret_cast<uintptr_t>(large) % 64);
+        }
+
+        TEST_METHOD(ResetMergesBlocks) {
+            Arena arena(256);
+
+            {
+                auto points = make_arena_vector<cv::Point2f>(arena);
+                for (auto i = 0; i < 1000; i++)
+                    points.emplace_back(cv::Point2f(static_cast<float>(i), 0.0f));
+                Assert::AreEqual(999.0f, points.back().x);
+            }
+
+            Assert::IsTrue(arena.blocks() > 1);
+            auto capacity = arena.capacity();
+
+            arena.reset();
+            Assert::AreEqual(static_cast<size_t>(1), arena.blocks());
+            Assert::AreEqual(capacity, arena.capacity());
+            Assert::AreEqual(static_cast<size_t>(0), arena.used());
+
+            // the same work again fits in the merged block
+            {
+                auto points = make_arena_vector<cv::Point2f>(arena);
+                for (auto i = 0; i < 1000; i++)
+                    points.emplace_back(cv::Point2f(static_cast<float>(i), 0.0f));
+            }
+
+            Assert::AreEqual(static_cast<size_t>(1), arena.blocks());
+        }
+
+        TEST_METHOD(PeakKeptUntilResetPeak) {
+            Arena arena(256);
+            arena.allocate(100, 1);
+            arena.reset();
+
+            arena.allocate(10, 1);
+            Assert::AreEqual(static_cast<size_t>(100), arena.peak());
+
+            arena.reset_peak();
+            Assert::AreEqual(static_cast<size_t>(10), arena.peak());
+        }
+
+    };
+}
@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "PvApiStub.h"
+#include "../testOpenCV/Camera/AttributeCache.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(ATTRIBUTE_CACHE_TEST) {
+
+        const tPvHandle camera = reinterpret_cast<tPvHandle>(1);
+
+    public:
+
+        TEST_METHOD(ReadsOnce) {
+            pvstub::reset_attributes();
+            AttributeCache cache(camera);
+
+            unsigned long value = 0;
+            for (auto i = 0; i < 10; i++) {
+                Assert::IsTrue(cache.get("ExposureValue", value) == ePvErrSuccess);
+                Assert::AreEqual(10000ul, value);
+            }
+
+            Assert::AreEqual(1ul, pvstub::attribute_reads("ExposureValue"));
+            Assert::AreEqual(9ul, cache.counts("ExposureValue").hits);
+
+            // unknown attributes are not cached
+            Assert::IsTrue(cache.get("Unknown", value) == ePvErrNotFound);
+            Assert::IsTrue(cache.get("Unknown", value) == ePvErrNotFound);
+            Assert::AreEqual(2ul, pvstub::attribute_reads("Unknown"));
+        }
+
+        TEST_METHOD(WritesThroughOnlyChanges) {
+            pvstub::reset_attributes();
+            AttributeCache cache(camera);
+
+            Assert::IsTrue(cache.set("GainValue", 5) == ePvErrSuccess);
+            Assert::IsTrue(cache.set("GainValue", 5) == ePvErrSuccess);
+            Assert::AreEqual(1ul, pvstub::attribute_writes("GainValue"));
+            Assert::AreEqual(5ul, pvstub::attribute("GainValue"));
+
+            // the written value is served without a read
+            unsigned long value = 0;
+            cache.get("GainValue", value);
+            Assert::AreEqual(5ul, value);
+            Assert::AreEqual(0ul, pvstub::attribute_reads("GainValue"));
+
+            // a failed write is read back next time
+            pvstub::fail_writes("GainValue");
+            Assert::IsFalse(cache.set("GainValue", 7) == ePvErrSuccess);
+            pvstub::fail_writes(nullptr);
+            cache.get("GainValue", value);
+            Assert::AreEqual(5ul, value);
+            Assert::AreEqual(1ul, pvstub::attribute_reads("GainValue"));
+        }
+
+        TEST_METHOD(RegionStaysOnSensor) {
+            pvstub::reset_attributes();
+            AttributeCache cache(camera);
+            size_t written = 0;
+
+            // shrink and move to the far corner, the wrong order would leave the sensor
+            Assert::IsTrue(cache.region(2000, 1800, 400, 200, written) == ePvErrSuccess);
+            Assert::AreEqual(static_cast<size_t>(4), written);
+
+            // grow back from the corner
+            Assert::IsTrue(cache.region(0, 0, 2448, 2040, written) == ePvErrSuccess);
+            Assert::AreEqual(2448ul, pvstub::attribute("Width"));
+
+            // shrink one axis while growing the other
+            Assert::IsTrue(cache.region(0, 1006, 2448, 256, written) == ePvErrSuccess);
+            Assert::IsTrue(cache.region(2000, 0, 400, 2040, written) == ePvErrSuccess);
+            Assert::AreEqual(2000ul, pvstub::attribute("RegionX"));
+            Assert::AreEqual(2040ul, pvstub::attribute("Height"));
+        }
+
+        TEST_METHOD(RegionWritesOnlyChanges) {
+            pvstub::reset_attributes();
+            AttributeCache cache(camera);
+            size_t written = 0;
+
+            Assert::IsTrue(cache.region(0, 1006, 2448, 256, written) == ePvErrSuccess);
+            Assert::AreEqual(static_cast<size_t>(2), written);
+
+            Assert::IsTrue(cache.region(0, 1006, 2448, 256, written) == ePvErrSuccess);
+            Assert::AreEqual(static_cast<size_t>(0), written);
+
+            Assert::AreEqual(0ul, pvstub::attribute_writes("RegionX"));
+            Assert::AreEqual(0ul, pvstub::attribute_writes("Width"));
+            Assert::AreEqual(1ul, pvstub::attribute_writes("RegionY"));
+            Assert::AreEqual(1ul, pvstub::attribute_writes("Height"));
+        }
+
+        TEST_METHOD(FailedRegionIsRolledBack) {
+            pvstub::reset_attributes();
+            AttributeCache cache(camera);
+            size_t written = 0;
+
+            Assert::IsTrue(cache.region(0, 1006, 2448, 256, written) == ePvErrSuccess);
+
+            // the move fails after the width was written, which is undone again
+            pvstub::fail_writes("RegionY");
+            Assert::IsFalse(cache.region(100, 0, 1000, 256, written) == ePvErrSuccess);
+            Assert::AreEqual(static_cast<size_t>(0), written);
+            pvstub::fail_writes(nullptr);
+
+            Assert::AreEqual(0ul, pvstub::attribute("RegionX"));
+            Assert::AreEqual(2448ul, pvstub::attribute("Width"));
+            Assert::AreEqual(1006ul, pvstub::attribute("RegionY"));
+
+            unsigned long value = 0;
+            cache.get("Width", value);
+            Assert::AreEqual(2448ul, value);
+        }
+
+    };
+
+}
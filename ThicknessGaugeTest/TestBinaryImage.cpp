@@ -0,0 +1,68 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <opencv2/opencv.hpp>
+#include "../testOpenCV/CV/BinaryImage.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(BINARY_IMAGE_TEST) {
+
+    public:
+
+        TEST_METHOD(PackUnpack) {
+            cv::Mat image(20, 130, CV_8UC1);
+            cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+            cv::threshold(image, image, 200, 255, cv::THRESH_BINARY);
+
+            BinaryImage packed(image);
+            cv::Mat unpacked;
+            packed.unpack(unpacked);
+
+            Assert::AreEqual(0, cv::countNonZero(image != unpacked));
+            Assert::AreEqual(static_cast<size_t>(cv::countNonZero(image)), packed.count());
+        }
+
+        TEST_METHOD(GradientMatchesMorphologyEx) {
+            cv::Mat image(40, 200, CV_8UC1);
+            cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+            cv::threshold(image, image, 180, 255, cv::THRESH_BINARY);
+
+            for (auto radius = 1; radius <= 3; radius++) {
+                cv::Mat expected;
+                auto element = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(2 * radius + 1, 2 * radius + 1));
+                cv::morphologyEx(image, expected, cv::MORPH_GRADIENT, element);
+
+                BinaryImage packed(image);
+                BinaryImage gradient;
+                packed.gradient(gradient, radius);
+
+                cv::Mat actual;
+                gradient.unpack(actual);
+                Assert::AreEqual(0, cv::countNonZero(expected != actual));
+            }
+        }
+
+        TEST_METHOD(RemoveIslands) {
+            cv::Mat image = cv::Mat::zeros(20, 100, CV_8UC1);
+
+            // isolated pixel and a small island
+            image.at<uchar>(5, 5) = 255;
+            image.at<uchar>(10, 20) = 255;
+            image.at<uchar>(11, 21) = 255;
+
+            // a line is kept
+            cv::line(image, cv::Point(50, 0), cv::Point(50, 19), cv::Scalar::all(255));
+
+            BinaryImage packed(image);
+            packed.remove_islands(packed);
+
+            Assert::AreEqual(static_cast<size_t>(20), packed.count());
+            Assert::IsFalse(packed.at(5, 5));
+            Assert::IsFalse(packed.at(20, 10));
+            Assert::IsTrue(packed.at(50, 10));
+        }
+
+    };
+}
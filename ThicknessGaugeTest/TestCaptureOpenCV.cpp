@@ -0,0 +1,77 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cstdio>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include "../testOpenCV/Camera/CaptureOpenCV.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(CAPTURE_OPENCV_TEST) {
+
+        const std::string sequence = "TestCaptureOpenCV_%02d.png";
+
+        const int frames = 3;
+
+        static int level(int index) {
+            return 10 + index * 50;
+        }
+
+    public:
+
+        // color frames of one gray level each
+        TEST_METHOD_INITIALIZE(WriteSequence) {
+            for (auto i = 0; i < frames; i++)
+                cv::imwrite(cv::format(sequence.c_str(), i), cv::Mat(240, 320, CV_8UC3, cv::Scalar::all(level(i))));
+        }
+
+        TEST_METHOD_CLEANUP(RemoveSequence) {
+            for (auto i = 0; i < frames; i++)
+                std::remove(cv::format(sequence.c_str(), i).c_str());
+        }
+
+        TEST_METHOD(RegionFitsFrames) {
+            CaptureOpenCV capture(sequence);
+            Assert::IsTrue(capture.open());
+
+            // the camera region does not fit, the whole frame is used
+            Assert::IsTrue(capture.region() == cv::Rect_<unsigned long>(0, 0, 320, 240));
+
+            Assert::IsTrue(capture.region(cv::Rect_<unsigned long>(0, 100, 320, 20)));
+            Assert::IsFalse(capture.region(cv::Rect_<unsigned long>(0, 230, 320, 20)));
+            Assert::IsFalse(capture.region(cv::Rect_<unsigned long>(0, 0, 0, 20)));
+        }
+
+        TEST_METHOD(FramesAreGrayAndCut) {
+            CaptureOpenCV capture(sequence);
+            Assert::IsTrue(capture.open());
+
+            cv::Rect_<unsigned long> roi(10, 100, 200, 20);
+            Assert::IsTrue(capture.region(roi));
+
+            cv::Mat frame;
+            unsigned long frame_id = 0;
+            unsigned long long timestamp = 0;
+
+            for (auto i = 0; i < frames; i++) {
+                Assert::IsTrue(capture.cap_single(frame, roi, 100, frame_id, timestamp));
+                Assert::AreEqual(CV_8UC1, frame.type());
+                Assert::AreEqual(20, frame.rows);
+                Assert::AreEqual(200, frame.cols);
+                Assert::AreEqual(level(i), static_cast<int>(frame.at<uchar>(0, 0)));
+            }
+
+            // the sequence starts over
+            Assert::IsTrue(capture.cap_single(frame, roi, 100, frame_id, timestamp));
+            Assert::AreEqual(level(0), static_cast<int>(frame.at<uchar>(0, 0)));
+            Assert::AreEqual(4ul, frame_id);
+
+            // a frame for another region is refused
+            Assert::IsFalse(capture.cap_single(frame, capture.default_roi, 100, frame_id, timestamp));
+        }
+
+    };
+
+}
@@ -0,0 +1,109 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cmath>
+#include <opencv2/core.hpp>
+#include "../testOpenCV/Camera/CaptureSimulated.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(CAPTURE_SIMULATED_TEST) {
+
+        static SimulatedScene quiet_scene() {
+            SimulatedScene scene;
+            scene.noise = 0.0;
+            return scene;
+        }
+
+        // intensity centroid of the laser in a column, the background level is taken from the top row
+        static double laser_centroid(const cv::Mat& frame, int col) {
+            auto background = static_cast<double>(frame.at<uchar>(0, col));
+            auto mass = 0.0;
+            auto moment = 0.0;
+            for (auto r = 0; r < frame.rows; r++) {
+                auto v = frame.at<uchar>(r, col) - background;
+                mass += v;
+                moment += v * r;
+            }
+            return moment / mass;
+        }
+
+    public:
+
+        TEST_METHOD(RegionMustFitSensor) {
+            CaptureSimulated capture(quiet_scene());
+
+            Assert::IsTrue(capture.region(cv::Rect_<unsigned long>(0, 1006, 2448, 256)));
+            Assert::IsFalse(capture.region(cv::Rect_<unsigned long>(2000, 0, 500, 10)));
+            Assert::IsFalse(capture.region(cv::Rect_<unsigned long>(0, 0, 0, 10)));
+
+            cv::Mat frame;
+            capture.cap_single(frame);
+            Assert::AreEqual(256, frame.rows);
+            Assert::AreEqual(2448, frame.cols);
+            Assert::AreEqual(CV_8UC1, frame.type());
+        }
+
+        TEST_METHOD(ExposureScalesAndSaturates) {
+            CaptureSimulated capture(quiet_scene());
+            cv::Mat frame;
+
+            capture.exposure(4000);
+            capture.cap_single(frame);
+            Assert::AreEqual(24, static_cast<int>(frame.at<uchar>(0, 100)));
+            Assert::AreEqual(102, static_cast<int>(frame.at<uchar>(0, 1200)));
+
+            capture.gain(6);
+            capture.cap_single(frame);
+            Assert::AreEqual(48, static_cast<int>(frame.at<uchar>(0, 100)));
+
+            capture.gain(0);
+            capture.exposure(20000);
+            capture.cap_single(frame);
+            Assert::AreEqual(255, static_cast<int>(frame.at<uchar>(0, 1200)));
+        }
+
+        TEST_METHOD(LaserAtGroundTruth) {
+            auto scene = quiet_scene();
+            scene.laser_tilt = 0.002;
+            CaptureSimulated capture(scene);
+
+            cv::Mat frame;
+            capture.cap_single(frame);
+
+            auto top = static_cast<double>(capture.region().y);
+            Assert::AreEqual(capture.laser_y(300) - top, laser_centroid(frame, 300), 0.1);
+            Assert::AreEqual(capture.laser_y(1200) - top, laser_centroid(frame, 1200), 0.1);
+
+            auto truth = capture.truth();
+            Assert::AreEqual(6.0, truth.height);
+            Assert::AreEqual(truth.base_y - truth.height, capture.laser_y(1224.0), 1e-9);
+        }
+
+        TEST_METHOD(FramesCountCameraTime) {
+            CaptureSimulated capture(quiet_scene());
+            std::vector<cv::Mat> frames;
+
+            capture.cap(3, frames);
+            Assert::AreEqual(size_t(3), frames.size());
+            Assert::AreEqual(3ul, capture.frame_count());
+            Assert::AreEqual(3ull * 66666ull, capture.timestamp());
+
+            // exposures longer than the frame period slow the camera down
+            capture.exposure(100000);
+            unsigned long frame_id = 0;
+            unsigned long long timestamp = 0;
+            cv::Mat frame;
+            Assert::IsTrue(capture.cap_single(frame, capture.region(), 1000, frame_id, timestamp));
+            Assert::AreEqual(4ul, frame_id);
+            Assert::AreEqual(3ull * 66666ull + 100000ull, timestamp);
+            Assert::AreEqual(timestamp, capture.timestamp());
+
+            // a frame for another region is refused
+            Assert::IsFalse(capture.cap_single(frame, capture.default_roi_full, 1000, frame_id, timestamp));
+        }
+
+    };
+
+}
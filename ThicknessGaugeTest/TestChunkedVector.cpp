@@ -0,0 +1,99 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <opencv2/core.hpp>
+#include "../testOpenCV/Util/ChunkedVector.h"
+#include "../testOpenCV/Util/Arena.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(CHUNKED_VECTOR_TEST) {
+
+    public:
+
+        TEST_METHOD(AppendKeepsOrderAcrossChunks) {
+            ChunkedVector<cv::Point2f, 4> elements;
+
+            std::vector<cv::Point2f> line;
+            for (auto i = 0; i < 10; i++)
+                line.emplace_back(cv::Point2f(static_cast<float>(i), 1.0f));
+
+            elements.append(line);
+            elements.push_back(cv::Point2f(99.0f, 2.0f));
+            elements.append(line.begin(), line.begin() + 3);
+
+            Assert::AreEqual(static_cast<size_t>(14), elements.size());
+
+            auto flat = elements.flatten();
+            Assert::AreEqual(static_cast<size_t>(14), flat.size());
+            for (auto i = 0; i < 10; i++)
+                Assert::AreEqual(static_cast<float>(i), flat[i].x);
+            Assert::AreEqual(99.0f, flat[10].x);
+            Assert::AreEqual(2.0f, flat[13].x);
+
+            size_t count = 0;
+            for (auto& p : elements)
+                Assert::AreEqual(flat[count++].x, p.x);
+            Assert::AreEqual(flat.size(), count);
+        }
+
+        TEST_METHOD(AddressesAreStable) {
+            ChunkedVector<cv::Point2f, 4> elements;
+            elements.push_back(cv::Point2f(1.0f, 1.0f));
+            auto first = &elements[0];
+
+            std::vector<cv::Point2f> line(100);
+            elements.append(line);
+
+            Assert::IsTrue(first == &elements[0]);
+            Assert::AreEqual(1.0f, elements[0].x);
+        }
+
+        TEST_METHOD(ClearReusesChunks) {
+            ChunkedVector<cv::Point2f, 4> elements;
+            std::vector<cv::Point2f> line(10);
+            elements.append(line);
+            auto first = &elements[0];
+
+            elements.clear();
+            Assert::IsTrue(elements.empty());
+
+            elements.append(line);
+            Assert::IsTrue(first == &elements[0]);
+            Assert::AreEqual(static_cast<size_t>(10), elements.size());
+        }
+
+        TEST_METHOD(ChunksFromArena) {
+            Arena arena(1024);
+            ChunkedVector<cv::Point2f, 4, ArenaAllocator<cv::Point2f>> elements{ArenaAllocator<cv::Point2f>(arena)};
+
+            std::vector<cv::Point2f> line;
+            for (auto i = 0; i < 10; i++)
+                line.emplace_back(cv::Point2f(static_cast<float>(i), 0.0f));
+            elements.append(line);
+
+            Assert::IsTrue(arena.used() >= 10 * sizeof(cv::Point2f));
+
+            auto flat = make_arena_vector<cv::Point2f>(arena);
+            elements.flatten(flat);
+            Assert::AreEqual(static_cast<size_t>(10), flat.size());
+            Assert::AreEqual(9.0f, flat.back().x);
+        }
+
+        TEST_METHOD(ChunkListGrowthIsBounded) {
+            Arena arena(1 << 16);
+            ChunkedVector<int, 4, ArenaAllocator<int>> elements{ArenaAllocator<int>(arena)};
+
+            for (auto i = 0; i < 4000; i++)
+                elements.push_back(i);
+
+            // the chunks plus the chunk lists left behind in the arena as the list grew, at most twice its final size
+            const auto payload = 4000 * sizeof(int);
+            const auto lists = 2 * 1024 * sizeof(int*);
+            Assert::IsTrue(arena.used() <= payload + lists);
+            Assert::AreEqual(3999, elements[3999]);
+        }
+
+    };
+}
@@ -0,0 +1,110 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cmath>
+#include <memory>
+#include <opencv2/core.hpp>
+#include "../testOpenCV/Camera/ExposureSearch.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(EXPOSURE_SEARCH_TEST) {
+
+        const ExposureRange range{1000, 30000, 1000};
+
+        // peaks at 17000, detected from 15000 to 19000
+        static double score(unsigned long exposure) {
+            return 100.0 - std::abs(static_cast<double>(exposure) - 17000.0) / 1000.0;
+        }
+
+        static bool detected(unsigned long exposure) {
+            return exposure >= 15000 && exposure <= 19000;
+        }
+
+    public:
+
+        TEST_METHOD(RangeCount) {
+            Assert::AreEqual(size_t(30), range.count());
+            Assert::AreEqual(30000ul, range.at(29));
+            Assert::AreEqual(size_t(0), ExposureRange{2000, 1000, 1000}.count());
+        }
+
+        TEST_METHOD(LinearTakesFirstDetected) {
+            auto accepts = 0;
+            LinearExposureSearch search;
+
+            auto found = search.search(range, score, [&accepts](unsigned long e) {
+                ++accepts;
+                return detected(e);
+            });
+
+            Assert::AreEqual(15000ul, found);
+            Assert::AreEqual(15, accepts);
+        }
+
+        TEST_METHOD(GoldenSectionFindsPeak) {
+            auto scores = 0;
+            auto accepts = 0;
+            GoldenSectionExposureSearch search;
+
+            auto found = search.search(range, [&scores](unsigned long e) {
+                                           ++scores;
+                                           return score(e);
+                                       }, [&accepts](unsigned long e) {
+                                           ++accepts;
+                                           return detected(e);
+                                       });
+
+            Assert::AreEqual(17000ul, found);
+            Assert::AreEqual(1, accepts);
+            Assert::IsTrue(scores < 12);
+        }
+
+        TEST_METHOD(GoldenSectionWidensAroundPeak) {
+            GoldenSectionExposureSearch search;
+
+            // the best contrast is just outside of what the detection accepts
+            auto found = search.search(range, score, [](unsigned long e) { return e == 15000; });
+
+            Assert::AreEqual(15000ul, found);
+            Assert::AreEqual(0ul, search.search(range, score, [](unsigned long) { return false; }));
+        }
+
+        TEST_METHOD(PredictedTriesLastFirst) {
+            PredictedExposureSearch search(std::make_unique<GoldenSectionExposureSearch>());
+
+            auto scores = 0;
+            auto counted = [&scores](unsigned long e) {
+                ++scores;
+                return score(e);
+            };
+
+            Assert::AreEqual(17000ul, search.search(range, counted, detected));
+            Assert::AreEqual(17000ul, search.last());
+
+            scores = 0;
+            Assert::AreEqual(17000ul, search.search(range, counted, detected));
+            Assert::AreEqual(0, scores);
+
+            // the light changed, the prediction fails and the search starts over
+            search.last(25000);
+            Assert::AreEqual(17000ul, search.search(range, counted, detected));
+            Assert::AreEqual(17000ul, search.last());
+        }
+
+        TEST_METHOD(BorderContrastPeaksBeforeSaturation) {
+            auto frame = [](double level) {
+                cv::Mat image(16, 64, CV_8UC1, cv::Scalar::all(level * 0.25));
+                image.colRange(24, 40).setTo(cv::Scalar::all(level));
+                return image;
+            };
+
+            Assert::AreEqual(0.0, ExposureSearch::border_contrast(cv::Mat(16, 64, CV_8UC1, cv::Scalar::all(0))));
+            Assert::IsTrue(ExposureSearch::border_contrast(frame(100)) < ExposureSearch::border_contrast(frame(200)));
+            Assert::IsTrue(ExposureSearch::border_contrast(frame(255)) < ExposureSearch::border_contrast(frame(200)));
+        }
+
+    };
+
+}
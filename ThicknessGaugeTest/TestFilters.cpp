@@ -0,0 +1,47 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <opencv2/opencv.hpp>
+#include "../testOpenCV/namespaces/filters.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(FILTERS_TEST) {
+
+    public:
+
+        TEST_METHOD(IsBoxKernel) {
+            double scale = 0.0;
+            cv::Mat box = cv::Mat::ones(5, 5, CV_32F) / 25.0f;
+            Assert::IsTrue(filters::is_box_kernel(box, scale));
+            Assert::AreEqual(1.0 / 25.0, scale, 0.0001);
+            Assert::IsFalse(filters::is_box_kernel(filters::kernel_line_left_to_right, scale));
+        }
+
+        TEST_METHOD(BoxFilterMatchesFilter2D) {
+            cv::Mat image(64, 128, CV_8UC1);
+            cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+
+            // use a roi so the border pixels are taken from the surrounding image
+            auto roi = image(cv::Rect(8, 8, 100, 40));
+
+            for (auto size = 3; size <= 31; size += 2) {
+                auto scale = 1.0 / (size * size);
+                cv::Mat kernel = cv::Mat::ones(size, size, CV_32F) * scale;
+
+                cv::Mat expected;
+                cv::Mat actual;
+                cv::filter2D(roi, expected, -1, kernel);
+                filters::box_filter(roi, actual, -1, kernel.size(), cv::Point(-1, -1), scale, 0.0, cv::BORDER_DEFAULT);
+
+                cv::Mat diff;
+                cv::absdiff(expected, actual, diff);
+                double max_diff;
+                cv::minMaxLoc(diff, nullptr, &max_diff);
+                Assert::AreEqual(0.0, max_diff, 1.0);
+            }
+        }
+
+    };
+}
@@ -0,0 +1,88 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <opencv2/opencv.hpp>
+#include "../testOpenCV/Camera/FramePool.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(FRAME_POOL_TEST) {
+
+    public:
+
+        TEST_METHOD(BuffersAreRecycled) {
+            auto pool = FramePool::create();
+            pool->reserve(256, 2448, CV_8UC1, 2);
+            Assert::AreEqual(static_cast<size_t>(2), pool->free_count());
+
+            uchar* first;
+            {
+                auto frame = pool->get(256, 2448, CV_8UC1);
+                first = frame.data;
+                Assert::AreEqual(static_cast<size_t>(1), pool->free_count());
+                Assert::AreEqual(static_cast<size_t>(1), pool->in_use());
+
+                // a shared header keeps the buffer
+                auto copy = frame;
+                frame.release();
+                Assert::AreEqual(static_cast<size_t>(1), pool->in_use());
+            }
+
+            Assert::AreEqual(static_cast<size_t>(2), pool->free_count());
+            Assert::AreEqual(static_cast<size_t>(0), pool->in_use());
+
+            auto again = pool->get(256, 2448, CV_8UC1);
+            Assert::IsTrue(again.data == first);
+        }
+
+        TEST_METHOD(OtherSizesAreNotPooled) {
+            auto pool = FramePool::create();
+            pool->reserve(16, 16, CV_8UC1, 1);
+
+            auto frame = pool->get(8, 8, CV_8UC1);
+            Assert::AreEqual(static_cast<size_t>(1), pool->free_count());
+            Assert::AreEqual(static_cast<size_t>(1), pool->in_use());
+
+            frame.release();
+            Assert::AreEqual(static_cast<size_t>(1), pool->free_count());
+            Assert::AreEqual(static_cast<size_t>(0), pool->in_use());
+        }
+
+        TEST_METHOD(SizeChangesReleaseBuffers) {
+            auto pool = FramePool::create();
+            pool->reserve(16, 16, CV_8UC1, 2);
+
+            // a frame in use keeps its buffer through the size changes, and is pooled again once the size is back
+            auto frame = pool->get(16, 16, CV_8UC1);
+            pool->reserve(8, 8, CV_8UC1, 1);
+            Assert::AreEqual(static_cast<size_t>(1), pool->free_count());
+
+            pool->reserve(16, 16, CV_8UC1, 1);
+            Assert::AreEqual(static_cast<size_t>(1), pool->free_count());
+
+            frame.release();
+            Assert::AreEqual(static_cast<size_t>(2), pool->free_count());
+            Assert::AreEqual(static_cast<size_t>(0), pool->in_use());
+
+            // the returned buffer is handed out again
+            auto again = pool->get(16, 16, CV_8UC1);
+            auto other = pool->get(16, 16, CV_8UC1);
+            Assert::AreEqual(static_cast<size_t>(0), pool->free_count());
+            Assert::IsTrue(again.data != other.data);
+        }
+
+        TEST_METHOD(FramesOutliveThePool) {
+            cv::Mat frame;
+            {
+                auto pool = FramePool::create();
+                pool->reserve(4, 4, CV_8UC1, 1);
+                frame = pool->get(4, 4, CV_8UC1);
+            }
+            frame.setTo(cv::Scalar::all(7));
+            Assert::AreEqual(7 * 16, static_cast<int>(cv::sum(frame)[0]));
+            frame.release();
+        }
+
+    };
+}
@@ -0,0 +1,243 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "../testOpenCV/Camera/CaptureSimulated.h"
+#include "../testOpenCV/Camera/CaptureReplay.h"
+#include "../testOpenCV/Camera/CaptureThread.h"
+#include "../testOpenCV/Camera/FrameRecording.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(FRAME_RECORDING_TEST) {
+
+        const std::string filename = "TestFrameRecording.tgf";
+
+        const cv::Rect_<unsigned long> narrow = cv::Rect_<unsigned long>(0, 1100, 2448, 64);
+
+        // two frames at 4000, one narrow frame at 8000, then two more at 4000
+        void record() const {
+            CaptureSimulated capture;
+            FrameRecorder recorder(filename);
+
+            auto take = [&](int count) {
+                for (auto i = 0; i < count; i++) {
+                    RecordedFrame frame;
+                    frame.roi = capture.region();
+                    frame.exposure = capture.exposure();
+                    frame.gain = capture.gain();
+                    Assert::IsTrue(capture.cap_single(frame.image, frame.roi, 100, frame.frame_id, frame.timestamp));
+                    Assert::IsTrue(recorder.write(frame));
+                }
+            };
+
+            capture.exposure(4000);
+            take(2);
+            capture.exposure(8000);
+            capture.region(narrow);
+            take(1);
+            capture.exposure(4000);
+            capture.region(capture.default_roi);
+            take(2);
+
+            Assert::AreEqual(size_t(5), recorder.frames());
+            Assert::IsTrue(recorder.good());
+        }
+
+        /**
+         * \brief Runs the commands of a seek through a capture thread, which reads ahead of the consumer
+         * \return The frame ids the consumer got
+         */
+        std::vector<unsigned long> seek(std::shared_ptr<CaptureInterface> capture, std::shared_ptr<FrameRecorder> recorder) const {
+            CaptureThread thread(capture, 4, OverflowPolicy::BackPressure);
+            thread.recorder(recorder);
+            thread.start();
+
+            std::vector<unsigned long> ids;
+            auto take = [&](int count) {
+                auto taken = thread.consume(count, [&ids](const CapturedFrame& frame) {
+                                                ids.emplace_back(frame.frame_id);
+                                            });
+                Assert::AreEqual(static_cast<size_t>(count), taken);
+            };
+
+            take(3);
+            thread.exposure_mul(2);
+            take(3);
+            // back to the first settings, the frames recorded with them later on must not be served early
+            thread.exposure_div(2);
+            take(3);
+            thread.region(cv::Rect_<unsigned long>(0, 1110, 2448, 32));
+            take(2);
+            thread.region(narrow);
+            take(3);
+
+            thread.stop();
+            return ids;
+        }
+
+        static bool same(const cv::Mat& a, const cv::Mat& b) {
+            return a.size() == b.size() && cv::countNonZero(a != b) == 0;
+        }
+
+    public:
+
+        TEST_METHOD_CLEANUP(RemoveRecording) {
+            std::remove(filename.c_str());
+        }
+
+        TEST_METHOD(RecordingKeepsFramesAndSettings) {
+            record();
+
+            FrameRecording recording;
+            Assert::IsTrue(recording.open(filename));
+            Assert::AreEqual(size_t(5), recording.size());
+
+            Assert::AreEqual(8000ul, recording.meta(2).exposure);
+            Assert::IsTrue(recording.meta(2).roi == narrow);
+            Assert::AreEqual(3ul, recording.meta(2).frame_id);
+            Assert::IsTrue(recording.meta(1).timestamp < recording.meta(2).timestamp);
+
+            // the frames are rendered again from the same seed
+            CaptureSimulated capture;
+            capture.exposure(4000);
+            cv::Mat expected;
+            capture.cap_single(expected);
+
+            RecordedFrame frame;
+            Assert::IsTrue(recording.read(0, frame));
+            Assert::IsTrue(same(expected, frame.image));
+        }
+
+        TEST_METHOD(PostedFramesAreWrittenInOrder) {
+            {
+                CaptureSimulated capture;
+                FrameRecorder recorder(filename);
+
+                for (auto i = 0; i < 5; i++) {
+                    RecordedFrame frame;
+                    frame.roi = capture.region();
+                    frame.exposure = capture.exposure();
+                    Assert::IsTrue(capture.cap_single(frame.image, frame.roi, 100, frame.frame_id, frame.timestamp));
+                    Assert::IsTrue(recorder.post(frame));
+                }
+
+                recorder.flush();
+                Assert::AreEqual(size_t(5), recorder.frames());
+                Assert::AreEqual(size_t(0), recorder.dropped());
+            }
+
+            FrameRecording recording;
+            Assert::IsTrue(recording.open(filename));
+            Assert::AreEqual(size_t(5), recording.size());
+            for (size_t i = 0; i < recording.size(); i++)
+                Assert::AreEqual(static_cast<unsigned long>(i + 1), recording.meta(i).frame_id);
+        }
+
+        TEST_METHOD(TruncatedRecordingDropsLastFrame) {
+            record();
+
+            std::ifstream in(filename, std::ios::binary | std::ios::ate);
+            auto size = static_cast<size_t>(in.tellg());
+            std::vector<char> bytes(size);
+            in.seekg(0);
+            in.read(bytes.data(), size);
+            in.close();
+
+            std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), size - 100);
+            out.close();
+
+            FrameRecording recording;
+            Assert::IsTrue(recording.open(filename));
+            Assert::AreEqual(size_t(4), recording.size());
+        }
+
+        TEST_METHOD(ReplayFollowsCommands) {
+            record();
+
+            CaptureReplay replay;
+            Assert::IsTrue(replay.load(filename));
+            Assert::AreEqual(4000ul, replay.exposure());
+
+            RecordedFrame frame;
+            Assert::IsTrue(replay.next(frame));
+            Assert::AreEqual(1ul, frame.frame_id);
+
+            // the narrow frame is served as soon as it is asked for
+            replay.exposure(8000);
+            replay.region(narrow);
+            Assert::IsTrue(replay.next(frame));
+            Assert::AreEqual(3ul, frame.frame_id);
+
+            // no more frames were recorded with these settings
+            Assert::IsFalse(replay.next(frame));
+
+            // the 4000 frame skipped before is not served again
+            replay.exposure(4000);
+            replay.region(replay.default_roi);
+            Assert::IsTrue(replay.next(frame));
+            Assert::AreEqual(4ul, frame.frame_id);
+            Assert::AreEqual(size_t(0), replay.mismatched());
+
+            // the same commands get the same frames
+            replay.rewind();
+            Assert::IsTrue(replay.next(frame));
+            Assert::AreEqual(1ul, frame.frame_id);
+        }
+
+        TEST_METHOD(ReplayThroughCaptureThreadRepeats) {
+            std::vector<unsigned long> recorded;
+            {
+                auto capture = std::make_shared<CaptureSimulated>();
+                capture->exposure(4000);
+                capture->region(narrow);
+
+                auto recorder = std::make_shared<FrameRecorder>(filename);
+                recorded = seek(capture, recorder);
+                recorder->flush();
+                Assert::AreEqual(size_t(0), recorder->dropped());
+            }
+
+            // the thread reads ahead by a different amount every run, the consumer still gets the same frames
+            for (auto run = 0; run < 2; run++) {
+                auto replay = std::make_shared<CaptureReplay>();
+                Assert::IsTrue(replay->load(filename));
+                Assert::IsTrue(replay->open());
+
+                auto replayed = seek(replay, nullptr);
+                Assert::IsTrue(recorded == replayed);
+                Assert::AreEqual(size_t(0), replay->mismatched());
+            }
+        }
+
+        TEST_METHOD(ReplayCutsUnrecordedSettings) {
+            record();
+
+            CaptureReplay replay;
+            Assert::IsTrue(replay.load(filename));
+
+            // 7000 was never recorded, the narrow region within the 8000 frame is the closest
+            replay.exposure(7000);
+            replay.region(cv::Rect_<unsigned long>(100, 1110, 200, 20));
+
+            RecordedFrame frame;
+            Assert::IsTrue(replay.next(frame));
+            Assert::AreEqual(3ul, frame.frame_id);
+            Assert::AreEqual(20, frame.image.rows);
+            Assert::AreEqual(200, frame.image.cols);
+            Assert::AreEqual(size_t(1), replay.mismatched());
+
+            RecordedFrame full;
+            replay.recording().read(2, full);
+            Assert::IsTrue(same(full.image(cv::Rect(100, 10, 200, 20)), frame.image));
+        }
+
+    };
+
+}
@@ -0,0 +1,153 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <chrono>
+#include <vector>
+#include "PvApiStub.h"
+#include "../testOpenCV/Camera/FrameRing.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(FRAME_RING_TEST) {
+
+        const tPvHandle camera = reinterpret_cast<tPvHandle>(1);
+
+    public:
+
+        TEST_METHOD(AcquisitionOverlapsProcessing) {
+            // the sensor only exposes when told to, so the order of events is fixed
+            pvstub::configure(64, 32, std::chrono::microseconds(0));
+
+            FrameRing ring(4, 64 * 32);
+            Assert::IsTrue(ring.start(camera));
+
+            pvstub::expose(1);
+            unsigned long previous = 0;
+            for (auto i = 0; i < 20; i++) {
+                auto frame = ring.acquire(0);
+                Assert::IsNotNull(frame);
+                Assert::AreEqual(64ul, frame->Width);
+
+                // the sensor keeps exposing into the other buffers while this frame is processed
+                pvstub::expose(3);
+                Assert::AreEqual(static_cast<size_t>(0), ring.queued());
+
+                if (previous > 0)
+                    Assert::AreEqual(previous + 1, frame->FrameCount);
+                previous = frame->FrameCount;
+
+                ring.release(frame);
+
+                // the remaining completed frames are taken in order before the sensor is needed again
+                for (auto j = 0; j < 3; j++) {
+                    frame = ring.acquire(0);
+                    Assert::IsNotNull(frame);
+                    Assert::AreEqual(++previous, frame->FrameCount);
+                    ring.release(frame);
+                }
+
+                pvstub::expose(1);
+            }
+
+            ring.stop();
+            Assert::AreEqual(0ul, pvstub::frames_lost());
+
+            // with every buffer held by the consumer the next frame is lost
+            Assert::IsTrue(ring.start(camera));
+            pvstub::expose(4);
+            std::vector<tPvFrame*> held;
+            for (auto i = 0; i < 4; i++)
+                held.emplace_back(ring.acquire(0));
+            pvstub::expose(1);
+            Assert::AreEqual(1ul, pvstub::frames_lost());
+            for (auto frame : held)
+                ring.release(frame);
+            ring.stop();
+        }
+
+        TEST_METHOD(FailedFramesAreRequeued) {
+            pvstub::configure(16, 16, std::chrono::milliseconds(1));
+            pvstub::fail_every(3);
+
+            FrameRing ring(3, 16 * 16);
+            ring.start(camera);
+
+            for (auto i = 0; i < 10; i++) {
+                auto frame = ring.acquire(1000);
+                Assert::IsNotNull(frame);
+                Assert::IsTrue(frame->Status == ePvErrSuccess);
+                Assert::AreNotEqual(0ul, frame->FrameCount % 3);
+                ring.release(frame);
+            }
+
+            Assert::IsTrue(ring.failed() > 0);
+        }
+
+        TEST_METHOD(StopReturnsAllFrames) {
+            pvstub::configure(16, 16, std::chrono::milliseconds(1));
+
+            FrameRing ring(4, 16 * 16);
+            ring.start(camera);
+
+            auto frame = ring.acquire(1000);
+            Assert::IsNotNull(frame);
+            ring.release(frame);
+
+            ring.stop();
+            Assert::IsFalse(ring.running());
+            Assert::AreEqual(static_cast<size_t>(0), ring.queued());
+            Assert::IsNull(ring.acquire(10));
+        }
+
+        TEST_METHOD(FenceDiscardsCompletedFrames) {
+            pvstub::configure(16, 16, std::chrono::microseconds(0));
+
+            FrameRing ring(4, 16 * 16);
+            ring.start(camera);
+
+            // every buffer completes, these were all exposed before the fence
+            pvstub::expose(4);
+
+            auto fence = ring.last_frame();
+            Assert::AreEqual(4ul, fence);
+            Assert::AreEqual(static_cast<size_t>(4), ring.fence(fence, 0));
+
+            pvstub::expose(4);
+            for (auto i = 0; i < 4; i++) {
+                auto frame = ring.acquire(0);
+                Assert::IsNotNull(frame);
+                Assert::IsTrue(frame->FrameCount > fence);
+                ring.release(frame);
+            }
+
+            Assert::AreEqual(static_cast<size_t>(4), ring.stale());
+        }
+
+        TEST_METHOD(FenceDiscardsFramesInFlight) {
+            pvstub::configure(16, 16, std::chrono::milliseconds(1));
+
+            FrameRing ring(4, 16 * 16);
+            ring.start(camera);
+
+            // frames still in the driver when the fence is set complete before the fenced time
+            auto fence = pvstub::timestamp() + 10000;
+            ring.fence(0, fence);
+
+            for (auto i = 0; i < 4; i++) {
+                auto frame = ring.acquire(1000);
+                Assert::IsNotNull(frame);
+                Assert::IsTrue(FrameRing::timestamp(frame) >= fence);
+                ring.release(frame);
+            }
+
+            Assert::IsTrue(ring.stale() > 0);
+
+            // a restart clears the fence
+            ring.stop();
+            ring.start(camera);
+            Assert::AreEqual(0ul, ring.last_frame());
+        }
+
+    };
+}
@@ -0,0 +1,187 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cmath>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include "../testOpenCV/CV/Frames.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(FRAMES_TEST) {
+
+        // frame i has every pixel set to its index in the frame plus i * 10, with an odd width so the planes need padding
+        static void fill(Frames& frames, int count) {
+            for (auto i = 0; i < count; i++) {
+                cv::Mat frame(3, 7, CV_8UC1);
+                for (auto p = 0; p < static_cast<int>(frame.total()); p++)
+                    frame.at<uchar>(p / frame.cols, p % frame.cols) = static_cast<uchar>(p + i * 10);
+                frames.add(frame);
+            }
+        }
+
+        // two pass reference, mean first and then the squared differences
+        static void reference(const cv::Mat& frame, double& mean, double& stddev) {
+            mean = 0.0;
+            for (auto y = 0; y < frame.rows; y++)
+                for (auto x = 0; x < frame.cols; x++)
+                    mean += frame.at<uchar>(y, x);
+            mean /= frame.total();
+
+            auto sum_sq = 0.0;
+            for (auto y = 0; y < frame.rows; y++)
+                for (auto x = 0; x < frame.cols; x++) {
+                    auto d = frame.at<uchar>(y, x) - mean;
+                    sum_sq += d * d;
+                }
+            stddev = std::sqrt(sum_sq / frame.total());
+        }
+
+        static cv::Mat random_frame(int seed) {
+            cv::Mat frame(64, 100, CV_8UC1);
+            cv::RNG rng(seed);
+            rng.fill(frame, cv::RNG::NORMAL, 120.0, 30.0);
+            return frame;
+        }
+
+        static void assert_statistics(const Frames& frames) {
+            Assert::AreEqual(frames.frames().size(), frames.means().size());
+            for (size_t i = 0; i < frames.frames().size(); i++) {
+                double mean, stddev;
+                reference(frames.frames()[i], mean, stddev);
+                Assert::AreEqual(mean, frames.means()[i], 1e-9);
+                Assert::AreEqual(stddev, frames.stddevs()[i], 1e-9);
+            }
+        }
+
+    public:
+
+        TEST_METHOD(StatisticsMatchTwoPass) {
+            Frames frames(0);
+            for (auto i = 0; i < 5; i++)
+                frames.add(random_frame(i));
+
+            assert_statistics(frames);
+        }
+
+        TEST_METHOD(StatisticsFollowFrameChanges) {
+            Frames frames(0);
+            for (auto i = 0; i < 3; i++)
+                frames.add(random_frame(i));
+            assert_statistics(frames);
+
+            // appended frames are computed on the next access
+            frames.add(random_frame(3));
+            assert_statistics(frames);
+
+            // a replaced frame is recomputed, and so are the statistics after removing frames
+            frames.edit_frames()[1] = cv::Mat(64, 100, CV_8UC1, cv::Scalar(7));
+            Assert::AreEqual(7.0, frames.means()[1], 1e-9);
+            Assert::AreEqual(0.0, frames.stddevs()[1], 1e-9);
+            assert_statistics(frames);
+
+            frames.edit_frames().pop_back();
+            assert_statistics(frames);
+        }
+
+        TEST_METHOD(StackKeepsPixelsInFrameOrder) {
+            Frames frames(0);
+            fill(frames, 4);
+
+            frames.stack();
+            Assert::IsTrue(frames.stacked());
+
+            // planes are padded to 64 bytes and follow each other in frame order
+            Assert::AreEqual(static_cast<size_t>(64), frames.plane_step());
+
+            const auto first = frames.frames().front().data;
+            Assert::AreEqual(static_cast<uintptr_t>(0), reinterpret_cast<uintptr_t>(first) % 64);
+
+            for (size_t i = 0; i < frames.frames().size(); i++) {
+                const auto& frame = frames.frames()[i];
+                Assert::IsTrue(frame.isContinuous());
+                Assert::IsTrue(first + i * frames.plane_step() == frame.data);
+                for (auto p = 0; p < static_cast<int>(frame.total()); p++)
+                    Assert::AreEqual(static_cast<int>(p + i * 10), static_cast<int>(first[i * frames.plane_step() + p]));
+            }
+        }
+
+        TEST_METHOD(UnstackCopiesFramesOut) {
+            Frames frames(0);
+            fill(frames, 3);
+            frames.stack();
+
+            frames.unstack();
+            Assert::IsFalse(frames.stacked());
+            Assert::AreEqual(static_cast<size_t>(0), frames.plane_step());
+            Assert::AreEqual(20, static_cast<int>(frames.frames()[2].at<uchar>(0, 0)));
+            Assert::AreEqual(3 * 21, static_cast<int>(frames.bytes()));
+        }
+
+        TEST_METHOD(AddedFrameLeavesStack) {
+            Frames frames(0);
+            fill(frames, 2);
+            frames.stack();
+
+            fill(frames, 1);
+            Assert::IsFalse(frames.stacked());
+
+            frames.stack();
+            Assert::IsTrue(frames.stacked());
+            Assert::AreEqual(static_cast<size_t>(3), frames.frames().size());
+            Assert::AreEqual(0, static_cast<int>(frames.frames()[2].at<uchar>(0, 0)));
+        }
+
+        TEST_METHOD(ForEachFrameVisitsFramesInOrder) {
+            Frames frames(0);
+            fill(frames, 3);
+
+            size_t visited = 0;
+            frames.for_each_frame<uchar>([&visited](size_t i, const uchar* pixels, size_t count) {
+                Assert::AreEqual(visited++, i);
+                Assert::AreEqual(static_cast<size_t>(21), count);
+                for (size_t p = 0; p < count; p++)
+                    Assert::AreEqual(static_cast<int>(p + i * 10), static_cast<int>(pixels[p]));
+            });
+            Assert::AreEqual(static_cast<size_t>(3), visited);
+        }
+
+        TEST_METHOD(ForEachPixelWalksAcrossFrames) {
+            Frames frames(0);
+            fill(frames, 4);
+            frames.stack();
+
+            size_t visited = 0;
+            frames.for_each_pixel<uchar>([&visited](size_t p, const uchar* pixel, size_t step, int frame_count) {
+                Assert::AreEqual(visited++, p);
+                Assert::AreEqual(4, frame_count);
+                for (auto i = 0; i < frame_count; i++)
+                    Assert::AreEqual(static_cast<int>(p + i * 10), static_cast<int>(pixel[i * step]));
+            });
+            Assert::AreEqual(static_cast<size_t>(21), visited);
+        }
+
+        TEST_METHOD(AverageIsTheSameStackedOrNot) {
+            Frames frames(0);
+            for (auto i = 0; i < 5; i++)
+                frames.add(random_frame(i));
+
+            cv::Mat separate;
+            frames.average(separate);
+
+            frames.stack();
+            cv::Mat stacked;
+            frames.average(stacked);
+
+            Assert::AreEqual(0, cv::countNonZero(separate != stacked));
+
+            // rounded mean of the burst
+            auto sum = 0;
+            for (auto& frame : frames.frames())
+                sum += frame.at<uchar>(10, 20);
+            Assert::AreEqual((sum + 2) / 5, static_cast<int>(stacked.at<uchar>(10, 20)));
+        }
+
+    };
+}
@@ -0,0 +1,45 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+#include "../testOpenCV/Util/HugePageAllocator.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(HUGE_PAGE_ALLOCATOR_TEST) {
+
+    public:
+
+        TEST_METHOD(FramesArePageAligned) {
+            auto allocator = HugePageAllocator::instance();
+            auto before = allocator->block_bytes();
+
+            {
+                cv::Mat frame;
+                frame.allocator = allocator;
+                frame.create(2040, 2448, CV_8UC1);
+                frame.setTo(cv::Scalar::all(42));
+
+                Assert::AreEqual(static_cast<uintptr_t>(0), reinterpret_cast<uintptr_t>(frame.data) % 4096);
+                Assert::IsTrue(allocator->block_bytes() >= before + frame.total());
+                Assert::AreEqual(42, static_cast<int>(frame.at<uchar>(2039, 2447)));
+            }
+
+            Assert::AreEqual(before, allocator->block_bytes());
+        }
+
+        TEST_METHOD(SmallBuffersAreNotBlocks) {
+            auto allocator = HugePageAllocator::instance();
+            auto before = allocator->block_bytes();
+
+            cv::Mat small;
+            small.allocator = allocator;
+            small.create(16, 16, CV_8UC1);
+
+            Assert::AreEqual(before, allocator->block_bytes());
+        }
+
+    };
+}
@@ -0,0 +1,98 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <memory>
+#include <thread>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "../testOpenCV/Util/MemoryTracker.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(MEMORY_TRACKER_TEST) {
+
+    public:
+
+        TEST_METHOD_INITIALIZE(EnableTracking) {
+            MemoryTracker::enabled(true);
+        }
+
+        TEST_METHOD_CLEANUP(DisableTracking) {
+            MemoryTracker::enabled(false);
+        }
+
+        TEST_METHOD(NothingIsCountedWhenDisabled) {
+            MemoryTracker::enabled(false);
+            MemoryTracker::reset_peaks();
+
+            {
+                MemoryScope scope(MemoryStage::BaseLines);
+                std::vector<char> temporary(8192);
+            }
+
+            Assert::AreEqual(static_cast<int64_t>(0), MemoryTracker::heap(MemoryStage::BaseLines).allocations);
+        }
+
+        TEST_METHOD(HeapIsCountedAgainstActiveStage) {
+            MemoryTracker::reset_peaks();
+            auto before = MemoryTracker::heap(MemoryStage::BaseLines).current;
+
+            std::unique_ptr<std::vector<char>> held;
+            {
+                MemoryScope scope(MemoryStage::BaseLines);
+                held = std::make_unique<std::vector<char>>(4096);
+                std::vector<char> temporary(8192);
+            }
+
+            Assert::IsTrue(MemoryStage::BaseLines != MemoryTracker::stage());
+
+            auto usage = MemoryTracker::heap(MemoryStage::BaseLines);
+            Assert::IsTrue(usage.current >= before + 4096);
+            Assert::IsTrue(usage.allocated >= 4096 + 8192);
+            Assert::IsTrue(usage.peak >= 4096 + 8192);
+            Assert::IsTrue(usage.allocations >= 3);
+
+            // released outside the stage, counted where it is freed, the allocating stage keeps it as current
+            auto other = MemoryTracker::heap(MemoryStage::Other).current;
+            held.reset();
+            Assert::IsTrue(MemoryTracker::heap(MemoryStage::Other).current <= other - 4096);
+        }
+
+        TEST_METHOD(StageIsPerThread) {
+            MemoryTracker::reset_peaks();
+
+            MemoryScope scope(MemoryStage::SeekerPhaseOne);
+
+            auto worker_stage = MemoryStage::Count;
+            std::thread worker([&worker_stage] {
+                worker_stage = MemoryTracker::stage();
+                std::vector<char> buffer(4096);
+            });
+            worker.join();
+
+            Assert::IsTrue(MemoryStage::Other == worker_stage);
+            Assert::IsTrue(MemoryTracker::heap(MemoryStage::Other).allocated >= 4096);
+            Assert::IsTrue(MemoryStage::SeekerPhaseOne == MemoryTracker::stage());
+        }
+
+        TEST_METHOD(MatBuffersAreCounted) {
+            MemoryTracker::reset_peaks();
+            auto before = MemoryTracker::mat(MemoryStage::Laser).current;
+
+            {
+                MemoryScope scope(MemoryStage::Laser);
+                cv::Mat image;
+                image.allocator = MemoryTracker::mat_allocator();
+                image.create(100, 200, CV_16UC1);
+
+                Assert::AreEqual(before + 100 * 200 * 2, MemoryTracker::mat(MemoryStage::Laser).current);
+            }
+
+            auto usage = MemoryTracker::mat(MemoryStage::Laser);
+            Assert::AreEqual(before, usage.current);
+            Assert::AreEqual(static_cast<int64_t>(100 * 200 * 2), usage.allocated);
+        }
+
+    };
+}
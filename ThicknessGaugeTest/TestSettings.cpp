@@ -0,0 +1,74 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cstdio>
+#include <opencv2/core.hpp>
+#include "../testOpenCV/ThicknessGaugeSettings.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(SETTINGS_TEST) {
+
+        const std::string filename = "TestSettings.yml";
+
+        void save(const ThicknessGaugeSettings& settings) const {
+            cv::FileStorage fs(filename, cv::FileStorage::WRITE);
+            fs << "settings";
+            settings.write(fs);
+        }
+
+    public:
+
+        TEST_METHOD_CLEANUP(RemoveSettings) {
+            std::remove(filename.c_str());
+        }
+
+        TEST_METHOD(LoadsValidSettings) {
+            ThicknessGaugeSettings written;
+            written.gaussian_size = 7;
+            written.hough_threshold = 50;
+            save(written);
+
+            ThicknessGaugeSettings loaded;
+            Assert::IsTrue(loaded.load(filename));
+            Assert::AreEqual(7, loaded.gaussian_size);
+            Assert::AreEqual(50, loaded.hough_threshold);
+        }
+
+        TEST_METHOD(RejectsInvalidKernelSizes) {
+            ThicknessGaugeSettings written;
+
+            written.gaussian_size = 4;
+            save(written);
+
+            ThicknessGaugeSettings loaded;
+            Assert::IsFalse(loaded.load(filename));
+
+            // nothing is taken from a rejected file
+            Assert::AreEqual(ThicknessGaugeSettings().gaussian_size, loaded.gaussian_size);
+
+            written.gaussian_size = 5;
+            written.bilateral_diameter = 0;
+            save(written);
+            Assert::IsFalse(loaded.load(filename));
+        }
+
+        TEST_METHOD(RejectsCannyThresholdsOutOfOrder) {
+            ThicknessGaugeSettings written;
+            written.marking_canny_threshold_1 = 220;
+            written.marking_canny_threshold_2 = 200;
+            save(written);
+
+            ThicknessGaugeSettings loaded;
+            Assert::IsFalse(loaded.load(filename));
+            Assert::IsTrue(loaded.valid());
+        }
+
+        TEST_METHOD(MissingFileIsNotLoaded) {
+            ThicknessGaugeSettings loaded;
+            Assert::IsFalse(loaded.load("TestSettingsMissing.yml"));
+        }
+
+    };
+}
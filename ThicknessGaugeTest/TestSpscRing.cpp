@@ -0,0 +1,107 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <thread>
+#include <vector>
+#include "../testOpenCV/Util/SpscRing.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(SPSC_RING_TEST) {
+
+    public:
+
+        TEST_METHOD(PopsInPushOrder) {
+            SpscRing<int> ring(3);
+            Assert::AreEqual(size_t(4), ring.capacity());
+
+            for (auto i = 0; i < 4; i++)
+                Assert::IsTrue(ring.try_push(std::move(i)));
+
+            // full, the value is left untouched
+            auto extra = 4;
+            Assert::IsFalse(ring.try_push(std::move(extra)));
+            Assert::AreEqual(size_t(4), ring.size());
+
+            int value;
+            for (auto i = 0; i < 4; i++) {
+                Assert::IsTrue(ring.try_pop(value));
+                Assert::AreEqual(i, value);
+            }
+
+            Assert::IsFalse(ring.try_pop(value));
+            Assert::IsTrue(ring.empty());
+        }
+
+        TEST_METHOD(DropOldestKeepsNewest) {
+            SpscRing<int> ring(4);
+
+            for (auto i = 0; i < 10; i++)
+                ring.push_drop_oldest(std::move(i));
+
+            Assert::AreEqual(size_t(6), ring.dropped());
+
+            int value;
+            for (auto i = 6; i < 10; i++) {
+                Assert::IsTrue(ring.try_pop(value));
+                Assert::AreEqual(i, value);
+            }
+        }
+
+        TEST_METHOD(ConcurrentProducerConsumer) {
+            const auto count = 100000;
+            SpscRing<std::vector<int>> ring(8);
+
+            std::thread producer([&ring, count] {
+                for (auto i = 0; i < count; i++) {
+                    std::vector<int> value(1, i);
+                    while (!ring.try_push(std::move(value)))
+                        std::this_thread::yield();
+                }
+            });
+
+            std::vector<int> value;
+            auto expected = 0;
+            while (expected < count) {
+                if (!ring.try_pop(value)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                Assert::AreEqual(expected++, value.front());
+            }
+
+            producer.join();
+            Assert::IsTrue(ring.empty());
+        }
+
+        TEST_METHOD(ConcurrentDropOldestStaysOrdered) {
+            const auto count = 100000;
+            SpscRing<int> ring(4);
+
+            std::thread producer([&ring, count] {
+                for (auto i = 0; i < count; i++)
+                    ring.push_drop_oldest(std::move(i));
+            });
+
+            // every element is either consumed or dropped, never twice and never out of order
+            auto consumed = 0;
+            auto last = -1;
+            int value;
+            while (last < count - 1) {
+                if (!ring.try_pop(value)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                Assert::IsTrue(value > last);
+                last = value;
+                ++consumed;
+            }
+
+            producer.join();
+            Assert::AreEqual(static_cast<size_t>(count), consumed + ring.dropped());
+        }
+
+    };
+
+}
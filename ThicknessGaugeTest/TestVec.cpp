@@ -0,0 +1,74 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "../testOpenCV/Util/Vec.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThicknessGaugeTest {
+
+    TEST_CLASS(VEC_TEST) {
+
+    public:
+
+        TEST_METHOD(VectorsAreCompact) {
+            Assert::AreEqual(2 * sizeof(float), sizeof(v2<float>));
+            Assert::AreEqual(3 * sizeof(float), sizeof(v3<float>));
+            Assert::AreEqual(4 * sizeof(float), sizeof(v4<float>));
+
+            std::vector<v2<float>> source(16, v2<float>(1.0f, 2.0f));
+            std::vector<v2<float>> target(16);
+            std::memcpy(target.data(), source.data(), source.size() * sizeof(v2<float>));
+            Assert::IsTrue(source == target);
+        }
+
+        TEST_METHOD(SpanAddAndScale) {
+            std::vector<v2<float>> a(9, v2<float>(1.0f, 2.0f));
+            std::vector<v2<float>> b(9, v2<float>(3.0f, 4.0f));
+            std::vector<v2<float>> out(9);
+
+            span::add(a.data(), b.data(), out.data(), out.size());
+            span::scale(out.data(), out.size(), 0.5f);
+
+            for (auto& v : out)
+                Assert::IsTrue(v == v2<float>(2.0f, 3.0f));
+        }
+
+        TEST_METHOD(SpanDot) {
+            std::vector<v3<float>> a(5, v3<float>(1.0f, 2.0f, 3.0f));
+            std::vector<v3<float>> b(5, v3<float>(4.0f, 5.0f, 6.0f));
+            std::vector<float> out(5);
+
+            span::dot(a.data(), b.data(), out.data(), out.size());
+
+            for (auto d : out)
+                Assert::AreEqual(32.0f, d);
+
+            Assert::AreEqual(160.0, span::dot(a.data(), b.data(), a.size()));
+        }
+
+        TEST_METHOD(CrossProduct) {
+            v3<float> x(1.0f, 0.0f, 0.0f);
+            v3<float> y(0.0f, 1.0f, 0.0f);
+            Assert::IsTrue(x.cross(y) == v3<float>(0.0f, 0.0f, 1.0f));
+        }
+
+        TEST_METHOD(AlignedVectors) {
+            std::vector<v4a<float>> a(7, v4a<float>(1.0f, 2.0f, 3.0f, 4.0f));
+            std::vector<v4a<float>> out(7);
+
+            for (auto& v : a)
+                Assert::AreEqual(std::uintptr_t(0), reinterpret_cast<std::uintptr_t>(&v) % 16);
+
+            span::add(a.data(), a.data(), out.data(), out.size());
+
+            for (auto& v : out)
+                Assert::IsTrue(v == v4a<float>(2.0f, 4.0f, 6.0f, 8.0f));
+
+            Assert::AreEqual(420.0, span::dot(a.data(), out.data(), a.size()));
+        }
+
+    };
+}
@@ -36,6 +36,14 @@ public:
             && lhs.glob_folder_ == rhs.glob_folder_
             && lhs.calibration_output_ == rhs.calibration_output_
             && lhs.test_suite_ == rhs.test_suite_
+            && lhs.settings_file_ == rhs.settings_file_
+            && lhs.tune_samples_ == rhs.tune_samples_
+            && lhs.huge_pages_ == rhs.huge_pages_
+            && lhs.stack_frames_ == rhs.stack_frames_
+            && lhs.track_memory_ == rhs.track_memory_
+            && lhs.session_ == rhs.session_
+            && lhs.record_frames_ == rhs.record_frames_
+            && lhs.capture_ == rhs.capture_
             && lhs.frames_ == rhs.frames_
             && lhs.test_max_ == rhs.test_max_
             && lhs.test_interval_ == rhs.test_interval_
@@ -52,6 +60,8 @@ public:
             << "\nbuildInfoMode: " << obj.build_info_mode_
             << "\ntestMode: " << obj.test_mode_
             << "\ntestSuite: " << obj.test_suite_
+            << "\nsettingsFile: " << obj.settings_file_
+            << "\ntuneSamples: " << obj.tune_samples_
             << "\ncalibrationMode_: " << obj.calibration_mode_
             << "\ncalibrationOutput: " << obj.calibration_output_
             << "\nglobMode_: " << obj.glob_mode_
@@ -59,6 +69,12 @@ public:
             << "\ncameraFile: " << obj.camera_file_
             << "\nshowWindows_: " << obj.show_windows_
             << "\nrecordVideo_: " << obj.record_video_
+            << "\nhugePages: " << obj.huge_pages_
+            << "\nstackFrames: " << obj.stack_frames_
+            << "\ntrackMemory: " << obj.track_memory_
+            << "\nsession: " << obj.session_
+            << "\nrecordFrames: " << obj.record_frames_
+            << "\ncapture: " << obj.capture_
             << "\nframes: " << obj.frames_
             << "\ntestMax: " << obj.test_max_
             << "\ntestInterval: " << obj.test_interval_
@@ -73,6 +89,9 @@ private:
     std::string calibration_output_;
     std::string test_suite_;
     std::string glob_folder_;
+    std::string settings_file_;
+    std::string record_frames_;
+    std::string capture_;
 
     unsigned long phase_two_exposure_;
 
@@ -80,6 +99,8 @@ private:
     int test_max_;
     int test_interval_;
 
+    int tune_samples_ = 50;
+
     int num_open_cv_threads_;
 
     bool build_info_mode_;
@@ -91,6 +112,10 @@ private:
     bool zero_measurering_;
     bool show_windows_;
     bool record_video_;
+    bool huge_pages_ = true;
+    bool stack_frames_ = false;
+    bool track_memory_ = false;
+    bool session_ = false;
 
 public:
 
@@ -134,6 +159,22 @@ public:
         test_suite_ = testSuite;
     }
 
+    const std::string& settings_file() const {
+        return settings_file_;
+    }
+
+    void settings_file(const std::string& settingsFile) {
+        settings_file_ = settingsFile;
+    }
+
+    int tune_samples() const {
+        return tune_samples_;
+    }
+
+    void tune_samples(int tuneSamples) {
+        tune_samples_ = tuneSamples;
+    }
+
     const std::string& calibration_output() const {
         return calibration_output_;
     }
@@ -206,6 +247,54 @@ public:
         record_video_ = recordVideo;
     }
 
+    bool huge_pages() const {
+        return huge_pages_;
+    }
+
+    void huge_pages(bool hugePages) {
+        huge_pages_ = hugePages;
+    }
+
+    bool stack_frames() const {
+        return stack_frames_;
+    }
+
+    void stack_frames(bool stackFrames) {
+        stack_frames_ = stackFrames;
+    }
+
+    bool track_memory() const {
+        return track_memory_;
+    }
+
+    void track_memory(bool trackMemory) {
+        track_memory_ = trackMemory;
+    }
+
+    bool session() const {
+        return session_;
+    }
+
+    void session(bool session) {
+        session_ = session;
+    }
+
+    const std::string& record_frames() const {
+        return record_frames_;
+    }
+
+    void record_frames(const std::string& recordFrames) {
+        record_frames_ = recordFrames;
+    }
+
+    const std::string& capture() const {
+        return capture_;
+    }
+
+    void capture(const std::string& capture) {
+        capture_ = capture;
+    }
+
     const std::string& camera_file() const {
         return camera_file_;
     }
@@ -50,6 +50,12 @@ namespace args {
             TCLAP::ValueArg<std::string> arg_testsuite("", "test_suite", "Test name for saving the test under.", false, "default", new TestSuitConstraint());
             cmd.add(arg_testsuite);
 
+            TCLAP::ValueArg<std::string> arg_settings_file("", "settings", "Processing settings file, loaded in demo mode when given, written by the tuner (--test_suite=tune, settings.yml if not given)", false, "", "filename");
+            cmd.add(arg_settings_file);
+
+            TCLAP::ValueArg<int> arg_tune_samples("", "tune_samples", "Random settings to try when tuning, 0 tries the full grid", false, 50, new IntegerConstraint("Tune samples", 0, 10000));
+            cmd.add(arg_tune_samples);
+
             TCLAP::ValueArg<int> arg_frame("", "frames", "amount of frames each calculation", false, 25, new IntegerConstraint("Frames", 5, 200));
             cmd.add(arg_frame);
 
@@ -59,6 +65,24 @@ namespace args {
             TCLAP::ValueArg<bool> arg_record_video("", "record_video", "Records demo mode to video", false, false, "0/1");
             cmd.add(arg_record_video);
 
+            TCLAP::ValueArg<bool> arg_huge_pages("", "huge_pages", "Back frame buffers with huge pages when the system allows it", false, true, "0/1");
+            cmd.add(arg_huge_pages);
+
+            TCLAP::ValueArg<bool> arg_stack_frames("", "stack_frames", "Moves each frame set into one contiguous buffer after capture", false, false, "0/1");
+            cmd.add(arg_stack_frames);
+
+            TCLAP::ValueArg<bool> arg_track_memory("", "track_memory", "Counts heap and matrix memory per measurement stage", false, false, "0/1");
+            cmd.add(arg_track_memory);
+
+            TCLAP::ValueArg<bool> arg_session("", "session", "Keeps the camera open in demo mode and measures once per line read from stdin (measure, zero or quit)", false, false, "0/1");
+            cmd.add(arg_session);
+
+            TCLAP::ValueArg<std::string> arg_record_frames("", "record_frames", "Records every captured frame with its exposure, region and timing to this file in demo mode", false, "", "filename");
+            cmd.add(arg_record_frames);
+
+            TCLAP::ValueArg<std::string> arg_capture("", "capture", "Capture device in demo and glob mode : pvapi, simulated, replay:<file>, opencv:<device index> or opencv:<video file>", false, "pvapi", "source");
+            cmd.add(arg_capture);
+
             TCLAP::ValueArg<std::string> arg_camera_calibration_file("", "camera_settings", "OpenCV camera calibration file", false, default_camera_calibration_file, new FileConstraint());
             cmd.add(arg_camera_calibration_file);
 
@@ -109,7 +133,19 @@ namespace args {
             sval = arg_glob_name.getValue();
             options->glob_folder(sval);
 
-            auto ival = arg_frame.getValue();
+            sval = arg_settings_file.getValue();
+            options->settings_file(sval);
+
+            sval = arg_record_frames.getValue();
+            options->record_frames(sval);
+
+            sval = arg_capture.getValue();
+            options->capture(sval);
+
+            auto ival = arg_tune_samples.getValue();
+            options->tune_samples(ival);
+
+            ival = arg_frame.getValue();
             options->frames(ival);
 
             ival = arg_max_opencv_threads.getValue();
@@ -121,6 +157,18 @@ namespace args {
             bval = arg_record_video.getValue();
             options->record_video(bval);
 
+            bval = arg_huge_pages.getValue();
+            options->huge_pages(bval);
+
+            bval = arg_stack_frames.getValue();
+            options->stack_frames(bval);
+
+            bval = arg_track_memory.getValue();
+            options->track_memory(bval);
+
+            bval = arg_session.getValue();
+            options->session(bval);
+
             bval = arg_zero_measurement.getValue();
             options->zero_measurering(bval);
 
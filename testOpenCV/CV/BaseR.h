@@ -42,11 +42,17 @@ protected:
 
     std::string window_name_;
 
+#ifdef TG_HEADLESS
+    // visualization is compiled out, all branches on this are removed
+    static constexpr bool show_windows_ = false;
+#else
     bool show_windows_ = false;
+#endif
 
     BaseR(std::string windowName, bool showWindows)
-        : window_name_(windowName)
-          , show_windows_(showWindows) {}
+        : window_name_(windowName) {
+        show_windows(showWindows);
+    }
 
 public:
 
@@ -77,6 +83,8 @@ public:
     }
 
     void show_windows(bool showWindows) {
+#ifndef TG_HEADLESS
         show_windows_ = showWindows;
+#endif
     }
 };
@@ -0,0 +1,236 @@
+#include "BinaryImage.h"
+#include <algorithm>
+#include <opencv2/core.hpp>
+
+namespace {
+
+    inline uint64_t word_at(const uint64_t* row, int stride, int i) {
+        return i >= 0 && i < stride ? row[i] : 0;
+    }
+
+    /**
+     * \brief Word i of a row shifted so that out[x] = in[x - k], pixels outside the row are zero
+     * \param row The row
+     * \param stride The number of words in the row
+     * \param i The word index
+     * \param k The shift in pixels, may be negative
+     * \return The shifted word
+     */
+    inline uint64_t shifted(const uint64_t* row, int stride, int i, int k) {
+        if (k == 0)
+            return row[i];
+
+        if (k > 0) {
+            auto w = k >> 6;
+            auto b = k & 63;
+            auto hi = word_at(row, stride, i - w);
+            if (b == 0)
+                return hi;
+            return hi << b | word_at(row, stride, i - w - 1) >> (64 - b);
+        }
+
+        k = -k;
+        auto w = k >> 6;
+        auto b = k & 63;
+        auto lo = word_at(row, stride, i + w);
+        if (b == 0)
+            return lo;
+        return lo >> b | word_at(row, stride, i + w + 1) << (64 - b);
+    }
+
+}
+
+BinaryImage::BinaryImage()
+    : rows_(0)
+      , cols_(0)
+      , stride_(0)
+      , tail_mask_(~uint64_t(0)) {
+}
+
+BinaryImage::BinaryImage(int rows, int cols)
+    : BinaryImage() {
+    create(rows, cols);
+}
+
+BinaryImage::BinaryImage(const cv::Mat& src)
+    : BinaryImage() {
+    pack(src);
+}
+
+void BinaryImage::create(int rows, int cols) {
+    CV_Assert(rows >= 0 && cols >= 0);
+    rows_ = rows;
+    cols_ = cols;
+    stride_ = (cols + 63) >> 6;
+    tail_mask_ = cols & 63 ? (uint64_t(1) << (cols & 63)) - 1 : ~uint64_t(0);
+    words_.assign(static_cast<size_t>(rows) * stride_, 0);
+}
+
+void BinaryImage::mask_tail() {
+    if (stride_ == 0)
+        return;
+    for (auto y = 0; y < rows_; y++)
+        row(y)[stride_ - 1] &= tail_mask_;
+}
+
+void BinaryImage::pack(const cv::Mat& src) {
+    CV_Assert(src.type() == CV_8UC1);
+
+    if (rows_ != src.rows || cols_ != src.cols)
+        create(src.rows, src.cols);
+
+    const auto full = cols_ >> 6;
+
+    for (auto y = 0; y < rows_; y++) {
+        auto p = src.ptr<uchar>(y);
+        auto r = row(y);
+
+        // split in full words and the tail, the inner loop is simple enough for the compiler to vectorize
+        for (auto i = 0; i < full; i++, p += 64) {
+            uint64_t word = 0;
+            for (auto b = 0; b < 64; b++)
+                word |= static_cast<uint64_t>(p[b] != 0) << b;
+            r[i] = word;
+        }
+
+        if (full < stride_) {
+            uint64_t word = 0;
+            for (auto b = 0; b < (cols_ & 63); b++)
+                word |= static_cast<uint64_t>(p[b] != 0) << b;
+            r[full] = word;
+        }
+    }
+}
+
+void BinaryImage::unpack(cv::Mat& dst) const {
+    dst.create(rows_, cols_, CV_8UC1);
+
+    for (auto y = 0; y < rows_; y++) {
+        auto p = dst.ptr<uchar>(y);
+        auto r = row(y);
+        for (auto x = 0; x < cols_; x++)
+            p[x] = r[x >> 6] >> (x & 63) & 1 ? 255 : 0;
+    }
+}
+
+void BinaryImage::invert() {
+    for (auto& w : words_)
+        w = ~w;
+    mask_tail();
+}
+
+void BinaryImage::dilate_rows(std::vector<uint64_t>& dst, int radius) const {
+    dst.resize(words_.size());
+    for (auto y = 0; y < rows_; y++) {
+        auto r = row(y);
+        auto out = dst.data() + static_cast<size_t>(y) * stride_;
+        for (auto i = 0; i < stride_; i++) {
+            auto word = r[i];
+            for (auto k = 1; k <= radius; k++)
+                word |= shifted(r, stride_, i, k) | shifted(r, stride_, i, -k);
+            out[i] = word;
+        }
+        if (stride_ > 0)
+            out[stride_ - 1] &= tail_mask_;
+    }
+}
+
+void BinaryImage::dilate_cols(const std::vector<uint64_t>& src, std::vector<uint64_t>& dst, int radius) const {
+    dst.assign(src.size(), 0);
+    for (auto y = 0; y < rows_; y++) {
+        auto out = dst.data() + static_cast<size_t>(y) * stride_;
+        auto first = std::max(0, y - radius);
+        auto last = std::min(rows_ - 1, y + radius);
+        for (auto yy = first; yy <= last; yy++) {
+            auto in = src.data() + static_cast<size_t>(yy) * stride_;
+            for (auto i = 0; i < stride_; i++)
+                out[i] |= in[i];
+        }
+    }
+}
+
+void BinaryImage::dilate(BinaryImage& dst, int radius) const {
+    CV_Assert(radius >= 0);
+
+    // the square structure element is separable, rows first then columns
+    std::vector<uint64_t> horizontal;
+    std::vector<uint64_t> result;
+    dilate_rows(horizontal, radius);
+    dilate_cols(horizontal, result, radius);
+
+    dst.rows_ = rows_;
+    dst.cols_ = cols_;
+    dst.stride_ = stride_;
+    dst.tail_mask_ = tail_mask_;
+    dst.words_.swap(result);
+}
+
+void BinaryImage::erode(BinaryImage& dst, int radius) const {
+    // erode(a) = not dilate(not a), with the border of the inverted image cleared
+    auto inverted = *this;
+    inverted.invert();
+    inverted.dilate(dst, radius);
+    dst.invert();
+}
+
+void BinaryImage::gradient(BinaryImage& dst, int radius) const {
+    BinaryImage eroded;
+    erode(eroded, radius);
+    dilate(dst, radius);
+    for (size_t i = 0; i < dst.words_.size(); i++)
+        dst.words_[i] &= ~eroded.words_[i];
+}
+
+void BinaryImage::remove_islands(BinaryImage& dst) const {
+    // the outer ring of the 5x5 block is the 5 wide span of the rows 2 above and below,
+    // and the pixels 2 to the left and right on the 3 center rows
+    std::vector<uint64_t> span;
+    dilate_rows(span, 2);
+
+    std::vector<uint64_t> sides(words_.size());
+    for (auto y = 0; y < rows_; y++) {
+        auto r = row(y);
+        auto out = sides.data() + static_cast<size_t>(y) * stride_;
+        for (auto i = 0; i < stride_; i++)
+            out[i] = shifted(r, stride_, i, 2) | shifted(r, stride_, i, -2);
+        if (stride_ > 0)
+            out[stride_ - 1] &= tail_mask_;
+    }
+
+    auto word = [this](const std::vector<uint64_t>& v, int y, int i) -> uint64_t {
+        return y >= 0 && y < rows_ ? v[static_cast<size_t>(y) * stride_ + i] : 0;
+    };
+
+    // centers of 3x3 blocks with something in them and nothing in the ring
+    BinaryImage centers;
+    dilate(centers, 1);
+    for (auto y = 0; y < rows_; y++) {
+        auto c = centers.row(y);
+        for (auto i = 0; i < stride_; i++)
+            c[i] &= ~(word(span, y - 2, i) | word(span, y + 2, i) | word(sides, y - 1, i) | word(sides, y, i) | word(sides, y + 1, i));
+    }
+
+    // clear the 3x3 blocks
+    centers.dilate(centers, 1);
+
+    if (&dst != this)
+        dst = *this;
+
+    for (size_t i = 0; i < dst.words_.size(); i++)
+        dst.words_[i] &= ~centers.words_[i];
+}
+
+size_t BinaryImage::count() const {
+    size_t count = 0;
+    for (auto w : words_)
+        count += popcount(w);
+    return count;
+}
+
+void BinaryImage::points(std::vector<cv::Point>& output) const {
+    output.clear();
+    output.reserve(count());
+    for_each([&output](int x, int y) {
+        output.emplace_back(x, y);
+    });
+}
@@ -0,0 +1,215 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <opencv2/core/mat.hpp>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+	|  __
+	| /__\
+	| X~~|			"The eternal code god
+	|-\|//-.		 watches over this mess."
+   /|`.|'.' \			- R.A.Kohn, 2017
+  |,|.\~~ /||
+  |:||   ';||
+  ||||   | ||
+  \ \|     |`.
+  |\X|     | |
+  | .'     |||
+  | |   .  |||
+  |||   |  `.| JS
+  ||||  |   ||
+  ||||  |   ||
+  `+.__._._+*/
+
+/**
+ * \brief Bit packed binary image, 64 pixels per word.
+ * Bit i of word w in a row is the pixel at x = w * 64 + i.
+ * Padding bits after the last column are always zero.
+ */
+class BinaryImage {
+
+    int rows_;
+
+    int cols_;
+
+    /**
+     * \brief The number of words per row
+     */
+    int stride_;
+
+    std::vector<uint64_t> words_;
+
+    /**
+     * \brief Mask for the valid bits in the last word of each row
+     */
+    uint64_t tail_mask_;
+
+    void mask_tail();
+
+    void dilate_rows(std::vector<uint64_t>& dst, int radius) const;
+
+    void dilate_cols(const std::vector<uint64_t>& src, std::vector<uint64_t>& dst, int radius) const;
+
+public:
+
+    BinaryImage();
+
+    BinaryImage(int rows, int cols);
+
+    /**
+     * \brief Packs an 8 bit single channel image, all non-zero pixels are set
+     * \param src The image to pack
+     */
+    explicit BinaryImage(const cv::Mat& src);
+
+    /**
+     * \brief (Re)allocates the image, all pixels are cleared
+     * \param rows The number of rows
+     * \param cols The number of columns
+     */
+    void create(int rows, int cols);
+
+    /**
+     * \brief Packs an 8 bit single channel image, all non-zero pixels are set
+     * \param src The image to pack
+     */
+    void pack(const cv::Mat& src);
+
+    /**
+     * \brief Unpacks to an 8 bit single channel image with set pixels as 255
+     * \param dst The destination image
+     */
+    void unpack(cv::Mat& dst) const;
+
+    int rows() const {
+        return rows_;
+    }
+
+    int cols() const {
+        return cols_;
+    }
+
+    int stride() const {
+        return stride_;
+    }
+
+    bool empty() const {
+        return words_.empty();
+    }
+
+    uint64_t* row(int y) {
+        return words_.data() + static_cast<size_t>(y) * stride_;
+    }
+
+    const uint64_t* row(int y) const {
+        return words_.data() + static_cast<size_t>(y) * stride_;
+    }
+
+    bool at(int x, int y) const {
+        return (row(y)[x >> 6] >> (x & 63) & 1) != 0;
+    }
+
+    void set(int x, int y) {
+        row(y)[x >> 6] |= uint64_t(1) << (x & 63);
+    }
+
+    /**
+     * \brief Inverts all pixels
+     */
+    void invert();
+
+    /**
+     * \brief Dilates with a square structure element of size 2 * radius + 1, pixels outside the image are cleared
+     * \param dst The destination, may be this
+     * \param radius The radius of the structure element
+     */
+    void dilate(BinaryImage& dst, int radius) const;
+
+    /**
+     * \brief Erodes with a square structure element of size 2 * radius + 1, pixels outside the image are set
+     * \param dst The destination, may be this
+     * \param radius The radius of the structure element
+     */
+    void erode(BinaryImage& dst, int radius) const;
+
+    /**
+     * \brief Morphological gradient (dilate and not erode) with a square structure element of size 2 * radius + 1
+     * \param dst The destination, may be this
+     * \param radius The radius of the structure element
+     */
+    void gradient(BinaryImage& dst, int radius) const;
+
+    /**
+     * \brief Removes isolated pixels and small islands (pepper noise) from an edge image.
+     * An island is cleared if it fits inside a 3x3 block with no set pixels in the surrounding 5x5 border.
+     * Pixels outside the image are regarded as cleared.
+     * \param dst The destination, may be this
+     */
+    void remove_islands(BinaryImage& dst) const;
+
+    /**
+     * \brief The number of set pixels
+     */
+    size_t count() const;
+
+    /**
+     * \brief Calls func(x, y) for each set pixel, row by row from left to right
+     * \param func The function to call
+     */
+    template <typename Func>
+    void for_each(Func func) const;
+
+    /**
+     * \brief Extracts the location of all set pixels
+     * \param output The output vector, is cleared first
+     */
+    void points(std::vector<cv::Point>& output) const;
+
+    /**
+     * \brief Index of the lowest set bit, value must be non-zero
+     */
+    static int ctz(uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<int>(index);
+#elif defined(_MSC_VER)
+        unsigned long index;
+        if (_BitScanForward(&index, static_cast<unsigned long>(value)))
+            return static_cast<int>(index);
+        _BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+        return static_cast<int>(index) + 32;
+#else
+        return __builtin_ctzll(value);
+#endif
+    }
+
+    static int popcount(uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        return static_cast<int>(__popcnt64(value));
+#elif defined(_MSC_VER)
+        return static_cast<int>(__popcnt(static_cast<unsigned int>(value)) + __popcnt(static_cast<unsigned int>(value >> 32)));
+#else
+        return __builtin_popcountll(value);
+#endif
+    }
+
+};
+
+template <typename Func>
+void BinaryImage::for_each(Func func) const {
+    for (auto y = 0; y < rows_; y++) {
+        auto r = row(y);
+        for (auto i = 0; i < stride_; i++) {
+            auto word = r[i];
+            while (word) {
+                func((i << 6) + ctz(word), y);
+                word &= word - 1;
+            }
+        }
+    }
+}
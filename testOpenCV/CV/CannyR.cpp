@@ -4,15 +4,23 @@
 
 using namespace tg;
 
+void CannyR::process(const cv::Mat& in, Workspace& ws) const {
+    Canny(in, ws.edges, threshold_1_, threshold_2_, aperture_size_, gradient_ > 0);
+
+    // remove isolated edge pixels and small edge islands
+    if (remove_pepper_noise_) {
+        ws.packed.pack(ws.edges);
+        ws.packed.remove_islands(ws.packed);
+        ws.packed.unpack(ws.edges);
+    }
+}
+
 void CannyR::do_canny() {
     try {
-        Canny(image_, edges_, threshold_1_, threshold_2_, aperture_size_, gradient_ > 0);
-
-        if (remove_pepper_noise_)
-            pixel::remove_pepper_noise(image_);
+        process(image_, ws_);
 
         if (show_windows_)
-            imshow(window_name_, edges_);
+            draw::showImage(window_name_, ws_.edges);
     } catch (cv::Exception& e) {
         log_time << "Caught exception in CannyR.\n" << e.what();
     }
@@ -20,5 +28,5 @@ void CannyR::do_canny() {
 }
 
 cv::Mat& CannyR::result() {
-    return edges_;
+    return ws_.edges;
 }
@@ -1,11 +1,12 @@
 #pragma once
 #include <opencv2/core/mat.hpp>
 #include <opencv2/videostab/inpainting.hpp>
-#include <opencv2/highgui.hpp>
 #include <iostream>
 #include "BaseR.h"
+#include "BinaryImage.h"
 #include "../namespaces/pixel.h"
 #include "../namespaces/tg.h"
+#include "../namespaces/draw.h"
 
 /*
 	|  __
@@ -26,11 +27,27 @@
   `+.__._._+*/
 
 /**
- * \brief Canny algorithm wrapper class
+ * \brief Canny algorithm wrapper class.
+ * The thresholds are the configuration, process() only reads them and can be called from several threads,
+ * each with its own workspace.
  */
 class CannyR : public BaseR {
 
-    cv::Mat edges_;
+public:
+
+    /**
+     * \brief The per call state of the edge detection, one per thread
+     */
+    struct Workspace {
+        cv::Mat edges;
+
+        // the bit packed edges used for pepper noise removal
+        BinaryImage packed;
+    };
+
+private:
+
+    Workspace ws_;
 
     int threshold_1_;
 
@@ -47,11 +64,11 @@ class CannyR : public BaseR {
     bool remove_pepper_noise_;
 
     void createWindow() {
-        namedWindow(window_name_, cv::WINDOW_KEEPRATIO);
-        cv::createTrackbar("threshold1", window_name_, &threshold_1_, 200, threshold1cb, this);
-        cv::createTrackbar("threshold2", window_name_, &threshold_2_, 200, threshold2cb, this);
-        cv::createTrackbar("apertureSize", window_name_, &aperture_size_, APER_MAX, apertureSizecb, this);
-        cv::createTrackbar("gradient", window_name_, &gradient_, 1, gradientcb, this);
+        draw::makeWindow(window_name_, true);
+        draw::makeTrackbar("threshold1", window_name_, &threshold_1_, 200, threshold1cb, this);
+        draw::makeTrackbar("threshold2", window_name_, &threshold_2_, 200, threshold2cb, this);
+        draw::makeTrackbar("apertureSize", window_name_, &aperture_size_, APER_MAX, apertureSizecb, this);
+        draw::makeTrackbar("gradient", window_name_, &gradient_, 1, gradientcb, this);
     }
 
     static void threshold1cb(int value, void* userData);
@@ -81,7 +98,7 @@ public:
           , aperture_size_(aperture_size)
           , gradient_(gradient)
           , remove_pepper_noise_(remove_pepper_noise) {
-        if (show_windows)
+        if (show_windows_)
             createWindow();
     }
 
@@ -97,6 +114,13 @@ public:
         this->gradient_ = gradient;
     }
 
+    /**
+     * \brief Detects edges with the current configuration, does not modify the object or show any windows
+     * \param in The image to detect edges in
+     * \param ws The workspace to store the edges in
+     */
+    void process(const cv::Mat& in, Workspace& ws) const;
+
     void do_canny();
 
     cv::Mat& result();
@@ -1,9 +1,10 @@
 #include "FilterR.h"
 #include "namespaces/draw.h"
+#include "namespaces/filters.h"
 
 void FilterR::create_window() {
-    cv::namedWindow(window_name_, cv::WINDOW_FREERATIO | cv::WINDOW_GUI_EXPANDED);
-    cv::createTrackbar("delta", window_name_, &deltaI_, 100, delta_cb, this);
+    draw::makeWindow(window_name_);
+    draw::makeTrackbar("delta", window_name_, &deltaI_, 100, delta_cb, this);
 }
 
 void FilterR::delta_cb(int value, void* user_data) {
@@ -20,9 +21,9 @@ FilterR::FilterR(std::string window_name, bool show_windows)
       , border_(cv::BORDER_DEFAULT) {
     generate_kernel(3, 3, 1.0f);
     anchor_ = cv::Point(-1, -1);
-    show_windows_ = show_windows;
+    BaseR::show_windows(show_windows);
     this->window_name_ = window_name;
-    if (show_windows)
+    if (show_windows_)
         create_window();
 }
 
@@ -32,7 +33,6 @@ FilterR::FilterR(std::string window_name)
       , border_(cv::BORDER_DEFAULT) {
     generate_kernel(3, 3, 1.0f);
     anchor_ = cv::Point(-1, -1);
-    show_windows_ = false;
     this->window_name_ = window_name;
 }
 
@@ -43,7 +43,7 @@ FilterR::FilterR(const cv::Mat& original, const cv::Mat& image, int ddepth, cv::
       , delta_(delta)
       , ddepth_(ddepth)
       , border_(border) {
-    if (show_windows)
+    if (show_windows_)
         create_window();
 }
 
@@ -116,8 +116,21 @@ void FilterR::do_filter(int depth, cv::Mat& kernel, cv::Point& anchor, double de
     do_filter(depth, kernel, anchor, delta, border_);
 }
 
+void FilterR::apply(const cv::Mat& in, cv::Mat& out, int depth, const cv::Mat& kernel, const cv::Point& anchor, double delta, int border) {
+    // box kernels (as made by generate_kernel) are applied with running sums, cost is independent of the kernel size
+    double scale;
+    if (in.channels() == 1 && kernel.total() >= box_min_area && filters::is_box_kernel(kernel, scale))
+        filters::box_filter(in, out, depth, kernel.size(), anchor, scale, delta, border);
+    else
+        filter2D(in, out, depth, kernel, anchor, delta, border);
+}
+
+void FilterR::process(const cv::Mat& in, Workspace& ws) const {
+    apply(in, ws.result, ddepth_, kernel_, anchor_, delta_, border_);
+}
+
 void FilterR::do_filter(int depth, cv::Mat& kernel, cv::Point& anchor, double delta, int border) {
-    filter2D(image_, result_, depth, kernel, anchor, delta, border);
+    apply(image_, result_, depth, kernel, anchor, delta, border);
     if (show_windows_)
         draw::showImage(window_name_, result_);
 }
@@ -22,10 +22,28 @@
   `+.__._._+*/
 
 /**
- * \brief Generic filter class with support for live changing of parameters
+ * \brief Generic filter class with support for live changing of parameters.
+ * The filter parameters are the configuration, process() only reads them and can be called from several threads,
+ * each with its own workspace.
  */
 class FilterR : public BaseR {
 
+public:
+
+    /**
+     * \brief The per call state of the filter, one per thread
+     */
+    struct Workspace {
+        cv::Mat result;
+    };
+
+private:
+
+    /**
+     * \brief The smallest kernel area where box kernels are applied with running sums instead of filter2D.
+     */
+    static const size_t box_min_area = 25;
+
     /**
      * \brief The result of the process
      */
@@ -65,6 +83,8 @@ class FilterR : public BaseR {
 
     static void delta_cb(int value, void* user_data);
 
+    static void apply(const cv::Mat& in, cv::Mat& out, int depth, const cv::Mat& kernel, const cv::Point& anchor, double delta, int border);
+
 public: // constructors
 
     explicit FilterR(std::string window_name, bool show_windows);
@@ -101,6 +121,13 @@ public: // constructors
 
     void generate_kernel(int width, int height, float modifier);
 
+    /**
+     * \brief Filters an image with the current configuration, does not modify the filter or show any windows
+     * \param in The image to filter
+     * \param ws The workspace to store the result in
+     */
+    void process(const cv::Mat& in, Workspace& ws) const;
+
     void do_filter();
 
     void do_filter(int depth);
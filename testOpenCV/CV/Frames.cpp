@@ -1,4 +1,120 @@
 #include "Frames.h"
+#include "Util/HugePageAllocator.h"
+#include <cmath>
+#include <cstdint>
+#include <opencv2/core/utility.hpp>
+
+namespace {
+
+    /**
+     * \brief Running count, mean and sum of squared differences (Welford)
+     */
+    struct Moments {
+        double count = 0.0;
+        double mean = 0.0;
+        double m2 = 0.0;
+
+        /**
+         * \brief Combines with the moments of another part of the data (Chan et al.)
+         */
+        void merge(const Moments& other) {
+            if (other.count == 0.0)
+                return;
+            auto n = count + other.count;
+            auto delta = other.mean - mean;
+            mean += delta * other.count / n;
+            m2 += other.m2 + delta * delta * count * other.count / n;
+            count = n;
+        }
+
+        double stddev() const {
+            return count > 0.0 ? std::sqrt(m2 / count) : 0.0;
+        }
+    };
+
+    /**
+     * \brief Integer rows are summed exactly, then converted to moments
+     */
+    template <typename T>
+    Moments row_moments_integer(const T* row, int cols) {
+        uint64_t sum = 0;
+        uint64_t sum_sq = 0;
+        for (auto x = 0; x < cols; x++) {
+            uint64_t v = row[x];
+            sum += v;
+            sum_sq += v * v;
+        }
+        Moments m;
+        m.count = cols;
+        m.mean = static_cast<double>(sum) / cols;
+        m.m2 = static_cast<double>(sum_sq) - static_cast<double>(sum) * m.mean;
+        return m;
+    }
+
+    template <typename T>
+    Moments row_moments_float(const T* row, int cols) {
+        Moments m;
+        for (auto x = 0; x < cols; x++) {
+            m.count += 1.0;
+            auto delta = row[x] - m.mean;
+            m.mean += delta / m.count;
+            m.m2 += delta * (row[x] - m.mean);
+        }
+        return m;
+    }
+
+    Moments frame_moments(const cv::Mat& frame) {
+        CV_Assert(frame.channels() == 1);
+        Moments total;
+        for (auto y = 0; y < frame.rows; y++) {
+            switch (frame.depth()) {
+            case CV_8U:
+                total.merge(row_moments_integer(frame.ptr<uchar>(y), frame.cols));
+                break;
+            case CV_16U:
+                total.merge(row_moments_integer(frame.ptr<ushort>(y), frame.cols));
+                break;
+            case CV_32F:
+                total.merge(row_moments_float(frame.ptr<float>(y), frame.cols));
+                break;
+            case CV_64F:
+                total.merge(row_moments_float(frame.ptr<double>(y), frame.cols));
+                break;
+            default:
+                CV_Error(cv::Error::StsUnsupportedFormat, "Unsupported frame depth for statistics.");
+            }
+        }
+        return total;
+    }
+
+    /**
+     * \brief Computes the statistics of a range of frames, one frame per task
+     */
+    class FrameStatistics : public cv::ParallelLoopBody {
+
+        const std::vector<cv::Mat>& frames_;
+
+        std::vector<double>& means_;
+
+        std::vector<double>& stddevs_;
+
+    public:
+
+        FrameStatistics(const std::vector<cv::Mat>& frames, std::vector<double>& means, std::vector<double>& stddevs)
+            : frames_(frames)
+              , means_(means)
+              , stddevs_(stddevs) { }
+
+        void operator()(const cv::Range& range) const override {
+            for (auto i = range.start; i < range.end; i++) {
+                auto m = frame_moments(frames_[i]);
+                means_[i] = m.mean;
+                stddevs_[i] = m.stddev();
+            }
+        }
+    };
+
+}
 
 Frames::Frames(const unsigned long index)
     : index_(index)
@@ -11,26 +127,161 @@ Frames::Frames(const std::string& expExt, unsigned long expMs)
 
 void Frames::clear() {
     frames_.clear();
-    means_.clear();
-    stddevs_.clear();
+    stack_.release();
+    plane_step_ = 0;
+    clear_statistics();
     exp_ext_.clear();
     exp_ms_ = 0;
 }
 
-void Frames::compute() {
+void Frames::add(const cv::Mat& frame) {
+    frames_.emplace_back(frame);
+}
+
+std::vector<cv::Mat>& Frames::edit_frames() {
+    clear_statistics();
+    return frames_;
+}
+
+void Frames::compute() const {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+
+    // frames are only removed or replaced through edit_frames(), which discards the statistics
+    const auto done = static_cast<int>(means_.size());
+    const auto count = static_cast<int>(frames_.size());
+    CV_DbgAssert(done <= count);
+
+    if (done >= count)
+        return;
+
+    means_.resize(count);
+    stddevs_.resize(count);
+
+    cv::parallel_for_(cv::Range(done, count), FrameStatistics(frames_, means_, stddevs_));
+}
+
+void Frames::clear_statistics() {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
     means_.clear();
-    means_.shrink_to_fit();
-    means_.reserve(frames_.size());
     stddevs_.clear();
-    stddevs_.shrink_to_fit();
-    stddevs_.reserve(frames_.size());
-
-    cv::Vec2d ms;
-    for (auto& frame : frames_) {
-        cvr::compute_intensity_std_dev(frame, ms);
-        means_.emplace_back(ms[0]);
-        stddevs_.emplace_back(ms[1]);
+}
+
+const std::vector<double>& Frames::means() const {
+    compute();
+    return means_;
+}
+
+const std::vector<double>& Frames::stddevs() const {
+    compute();
+    return stddevs_;
+}
+
+void Frames::stack() {
+    if (frames_.empty()) {
+        unstack();
+        return;
+    }
+
+    if (stacked())
+        return;
+
+    // always a new buffer, the frames may still be views into the old one
+    stack_.release();
+
+    const auto size = frames_.front().size();
+    const auto type = frames_.front().type();
+    const auto elem_size = frames_.front().elemSize();
+    CV_Assert(CV_MAT_CN(type) == 1 && 64 % elem_size == 0);
+
+    const auto plane = static_cast<size_t>(size.area());
+    plane_step_ = cv::alignSize(plane * elem_size, 64) / elem_size;
+
+    // single row, so any column range of it is continuous and can be reshaped into a frame,
+    // the extra space allows the first plane to be moved to an aligned address
+    stack_.allocator = HugePageAllocator::instance();
+    stack_.create(1, static_cast<int>(plane_step_ * frames_.size() + 64 / elem_size), type);
+    const auto offset = static_cast<int>((cv::alignPtr(stack_.data, 64) - stack_.data) / elem_size);
+
+    for (size_t i = 0; i < frames_.size(); i++) {
+        auto& frame = frames_[i];
+        CV_Assert(frame.size() == size && frame.type() == type);
+
+        const auto start = offset + static_cast<int>(plane_step_ * i);
+        auto view = stack_.colRange(start, start + static_cast<int>(plane)).reshape(0, size.height);
+
+        // the old buffer is kept alive by the frame until it is replaced
+        frame.copyTo(view);
+        frame = view;
+    }
+}
+
+void Frames::unstack() {
+    if (stacked()) {
+        for (auto& frame : frames_)
+            frame = frame.clone();
     }
+    stack_.release();
+    plane_step_ = 0;
+}
+
+bool Frames::stacked() const {
+    if (stack_.empty() || frames_.empty())
+        return false;
+
+    // every frame has to be its own plane in the stack
+    const auto first = frames_.front().data;
+    const auto elem_size = frames_.front().elemSize();
+    if (first < stack_.data || first + frames_.size() * plane_step_ * elem_size > stack_.data + stack_.total() * elem_size)
+        return false;
+
+    for (size_t i = 0; i < frames_.size(); i++) {
+        if (frames_[i].data != first + i * plane_step_ * elem_size)
+            return false;
+    }
+
+    return true;
+}
+
+void Frames::average(cv::Mat& output) const {
+    CV_Assert(!frames_.empty() && frames_.front().type() == CV_8UC1);
+
+    const auto count = static_cast<unsigned>(frames_.size());
+    const auto half = count / 2;
+
+    // a new matrix, so it is continuous and the pixel index addresses it directly
+    cv::Mat result(frames_.front().size(), CV_8UC1);
+    auto target = result.ptr<uchar>();
+
+    if (stacked()) {
+        // the burst of each pixel is summed at once, the planes are read side by side
+        for_each_pixel<uchar>([target, half](size_t p, const uchar* pixel, size_t step, int frame_count) {
+            auto sum = half;
+            for (auto i = 0; i < frame_count; i++)
+                sum += pixel[i * step];
+            target[p] = static_cast<uchar>(sum / frame_count);
+        });
+    } else {
+        std::vector<unsigned> sums(result.total(), half);
+        for_each_frame<uchar>([&sums](size_t, const uchar* pixels, size_t total) {
+            CV_Assert(total == sums.size());
+            for (size_t p = 0; p < total; p++)
+                sums[p] += pixels[p];
+        });
+        for (size_t p = 0; p < sums.size(); p++)
+            target[p] = static_cast<uchar>(sums[p] / count);
+    }
+
+    output = result;
+}
+
+size_t Frames::bytes() const {
+    if (stacked())
+        return stack_.total() * stack_.elemSize();
+
+    size_t total = 0;
+    for (auto& frame : frames_)
+        total += frame.total() * frame.elemSize();
+    return total;
 }
 
 std::ostream& operator<<(std::ostream& os, const Frames& obj) {
@@ -47,17 +298,19 @@ std::ostream& operator<<(std::ostream& os, const Frames& obj) {
 
     // means
     os << "\t\"means\":[ ";
-    auto size = obj.means_.size();
+    auto& means = obj.means();
+    auto size = means.size();
     for (auto i = 0; i < size; i++) {
-        os << cv::format("\"%f\"", obj.means_[i]);
+        os << cv::format("\"%f\"", means[i]);
         if (i != size - 1)
             os << ",";
     }
     os << " ],\n";
     os << "\t\"stddevs\":[ ";
-    size = obj.stddevs_.size();
+    auto& stddevs = obj.stddevs();
+    size = stddevs.size();
     for (auto i = 0; i < size; i++) {
-        os << cv::format("\"%f\"", obj.stddevs_[i]);
+        os << cv::format("\"%f\"", stddevs[i]);
         if (i != size - 1)
             os << ",";
     }
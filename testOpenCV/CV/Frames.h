@@ -2,6 +2,7 @@
 #include <opencv2/core/mat.hpp>
 #include <Camera/OpenCVCap.h>
 #include "namespaces/cvr.h"
+#include <mutex>
 #include <ostream>
 
 /**
@@ -19,6 +20,8 @@ public:
 
     Frames(Frames&& other) noexcept
         : frames_(std::move(other.frames_)),
+          stack_(std::move(other.stack_)),
+          plane_step_(other.plane_step_),
           means_(std::move(other.means_)),
           stddevs_(std::move(other.stddevs_)),
           exp_ext_(std::move(other.exp_ext_)),
@@ -26,20 +29,45 @@ public:
           index_(other.index_),
           exp_ms_(other.exp_ms_) {}
 
-    Frames& operator=(Frames other) {
-        using std::swap;
-        swap(*this, other);
+    Frames& operator=(const Frames& other) = delete;
+
+    // member wise, std::swap would call this again
+    Frames& operator=(Frames&& other) noexcept {
+        if (this != &other) {
+            frames_ = std::move(other.frames_);
+            stack_ = std::move(other.stack_);
+            plane_step_ = other.plane_step_;
+            means_ = std::move(other.means_);
+            stddevs_ = std::move(other.stddevs_);
+            exp_ext_ = std::move(other.exp_ext_);
+            frame_size_ = other.frame_size_;
+            index_ = other.index_;
+            exp_ms_ = other.exp_ms_;
+        }
         return *this;
     }
 
-    // the captured frames
+private:
+
+    // the captured frames, appended through add() or changed through edit_frames()
     std::vector<cv::Mat> frames_;
 
-    // means of captured frames
-    std::vector<double> means_;
+    // contiguous storage for the frames when stacked, frame i starts at plane_step_ * i elements from the first plane
+    cv::Mat stack_;
+
+    // distance between two frames in the stack in elements
+    size_t plane_step_ = 0;
+
+    // means of captured frames, computed on access for the frames added since the last access
+    mutable std::vector<double> means_;
+
+    // standard deviation of frames, follows means_
+    mutable std::vector<double> stddevs_;
 
-    // standard deviation of frames
-    std::vector<double> stddevs_;
+    // serializes the computation of the statistics between const readers
+    mutable std::mutex statistics_mutex_;
+
+public:
 
     // string of exposure
     std::string exp_ext_;
@@ -65,11 +93,121 @@ public:
     void clear();
 
     /**
-     * \brief Computes mean and stddev based on the contained frames.
+     * \brief The captured frames
+     */
+    const std::vector<cv::Mat>& frames() const {
+        return frames_;
+    }
+
+    /**
+     * \brief Appends a frame, the statistics of the frames before it are kept
+     */
+    void add(const cv::Mat& frame);
+
+    /**
+     * \brief Write access to the frames, discards the computed statistics.
+     * Take it again for changes made after reading statistics, the statistics follow the frames as they were then.
+     */
+    std::vector<cv::Mat>& edit_frames();
+
+    /**
+     * \brief Computes mean and stddev for the frames added since the last computation, in parallel over the frames.
+     * Called by means() and stddevs(), so it is only needed to do the work up front.
+     * Const readers may call this concurrently, the computation is serialized,
+     * but the frames must not change meanwhile and references from means() and stddevs() are only valid until they do.
+     */
+    void compute() const;
+
+    /**
+     * \brief Discards the computed statistics, they are recomputed on the next access
+     */
+    void clear_statistics();
+
+    /**
+     * \brief The intensity mean of each frame
+     */
+    const std::vector<double>& means() const;
+
+    /**
+     * \brief The intensity standard deviation of each frame
+     */
+    const std::vector<double>& stddevs() const;
+
+    /**
+     * \brief Moves the frames into one contiguous buffer (frames x rows x cols) and replaces them with views into it.
+     * Each frame starts on a 64 byte boundary. All frames must have the same size and a single channel type.
+     * Adding frames afterwards leaves the stack, call stack() again.
+     */
+    void stack();
+
+    /**
+     * \brief Releases the contiguous buffer, the frames are copied back into their own buffers
+     */
+    void unstack();
+
+    /**
+     * \brief Whether the frames are views into the contiguous buffer
+     */
+    bool stacked() const;
+
+    /**
+     * \brief The bytes held by the frames, the stack if stacked
+     */
+    size_t bytes() const;
+
+    /**
+     * \brief The distance in elements between a pixel in one frame and the same pixel in the next, requires stacked()
      */
-    void compute();
+    size_t plane_step() const {
+        return plane_step_;
+    }
+
+    /**
+     * \brief Frame major iteration, calls func(frame_index, pixels, count) for each frame in order,
+     * where pixels points to the count contiguous pixels of the frame
+     */
+    template <typename T, typename Func>
+    void for_each_frame(Func func) const;
+
+    /**
+     * \brief Pixel major iteration, calls func(pixel_index, pixel, plane_step, frame_count) for each pixel in order,
+     * where pixel[i * plane_step] is the pixel in frame i, requires stacked()
+     */
+    template <typename T, typename Func>
+    void for_each_pixel(Func func) const;
+
+    /**
+     * \brief The rounded per pixel mean of the frames, which must all have the same size and be CV_8UC1.
+     * Pixel major over the stack when stacked, frame major otherwise
+     * \param output The averaged frame
+     */
+    void average(cv::Mat& output) const;
 
     // output stream operator, outputs the entire dataset as json
     friend std::ostream& operator<<(std::ostream& os, const Frames& obj);
 
 };
+
+template <typename T, typename Func>
+void Frames::for_each_frame(Func func) const {
+    for (size_t i = 0; i < frames_.size(); i++) {
+        const auto& frame = frames_[i];
+        CV_Assert(frame.elemSize() == sizeof(T));
+        if (frame.isContinuous())
+            func(i, frame.ptr<T>(), frame.total());
+        else {
+            auto continuous = frame.clone();
+            func(i, continuous.ptr<T>(), continuous.total());
+        }
+    }
+}
+
+template <typename T, typename Func>
+void Frames::for_each_pixel(Func func) const {
+    CV_Assert(stacked() && frames_.front().elemSize() == sizeof(T));
+    const auto first = frames_.front().ptr<T>();
+    const auto count = frames_.front().total();
+    const auto frame_count = static_cast<int>(frames_.size());
+    for (size_t p = 0; p < count; p++)
+        func(p, first + p, plane_step_, frame_count);
+}
@@ -1,11 +1,11 @@
 #pragma once
 #include <opencv2/core/mat.hpp>
-#include <opencv2/highgui.hpp>
 #include <iostream>
 #include "BaseR.h"
 
 #include "../namespaces/tg.h"
 #include "../namespaces/calc.h"
+#include "../namespaces/draw.h"
 #include "LinePair.h"
 
 /*
@@ -76,33 +76,45 @@ public:
         }
     } lineHYSort;
 
-private:
+    /**
+     * \brief The per call state of the line detection, one per thread.
+     * The configuration (threshold, line lengths) lives in the HoughLinesPR object and is shared.
+     */
+    struct Workspace {
+        // the image the lines were detected in
+        cv::Mat image;
 
-    cv::Mat output_;
+        std::vector<cv::Vec4f> lines;
+
+        std::vector<LineH> all_lines;
+
+        std::vector<LineH> right_lines;
 
-    std::vector<cv::Vec4f> lines_;
+        std::vector<LineH> left_lines;
 
-    std::vector<LineH> all_lines_;
+        double center = 0.0;
+    };
 
-    std::vector<LineH> right_lines_;
+private:
+
+    cv::Mat output_;
 
-    std::vector<LineH> left_lines_;
+    Workspace ws_;
 
 public:
     const std::vector<LineH>& all_lines() const {
-        return all_lines_;
+        return ws_.all_lines;
     }
 
     const std::vector<LineH>& right_lines() const {
-        return right_lines_;
+        return ws_.right_lines;
     }
 
     const std::vector<LineH>& left_lines() const {
-        return left_lines_;
+        return ws_.left_lines;
     }
 
 private:
-    double center_;
 
     double left_y_ = 0.0;
 
@@ -143,23 +155,23 @@ public:
         max_theta_ = calc::PI;
         angle_limit_ = 0;
         max_line_gab_ = 10;
-        if (show_window)
+        if (show_windows_)
             create_window();
     }
 
 private:
     void create_window() {
-        namedWindow(window_name_, cv::WINDOW_KEEPRATIO);
-        cv::createTrackbar("rho", window_name_, &rho_, 3, rhocb, this);
-        cv::createTrackbar("theta", window_name_, &theta_, 180, thetacb, this);
-        cv::createTrackbar("threshold", window_name_, &threshold_, 100, thresholdcb, this);
-        cv::createTrackbar("min len", window_name_, &min_line_len_, 200, minLineLencb, this);
-        cv::createTrackbar("max gab", window_name_, &max_line_gab_, 100, maxLineGabcb, this);
+        draw::makeWindow(window_name_, true);
+        draw::makeTrackbar("rho", window_name_, &rho_, 3, rhocb, this);
+        draw::makeTrackbar("theta", window_name_, &theta_, 180, thetacb, this);
+        draw::makeTrackbar("threshold", window_name_, &threshold_, 100, thresholdcb, this);
+        draw::makeTrackbar("min len", window_name_, &min_line_len_, 200, minLineLencb, this);
+        draw::makeTrackbar("max gab", window_name_, &max_line_gab_, 100, maxLineGabcb, this);
     }
 
     void compute_borders();
 
-    void bresenham();
+    static void bresenham(Workspace& ws);
 
     static bool split_lines_x(std::vector<LineH>& source, std::vector<LineH>& right, std::vector<LineH>& left, double x, double* leftCenter, double* rightCenter);
 
@@ -194,6 +206,13 @@ public:
 
     void clear();
 
+    /**
+     * \brief Computes the horizontal lines with the current configuration, does not modify the object or show any windows
+     * \param in The edge image
+     * \param ws The workspace to store the lines in
+     */
+    void process(const cv::Mat& in, Workspace& ws) const;
+
     void hough_horizontal();
 
     void draw_line(std::vector<line_pair<float>>& linePairs, cv::Scalar colour);
@@ -222,7 +241,7 @@ public:
         this->angle_limit_ = angleLimit;
     }
 
-    void original(cv::Mat& newImage) {
+    void original(const cv::Mat& newImage) {
         original_ = newImage;
         if (show_windows_)
             cvtColor(newImage, output_, CV_GRAY2BGR);
@@ -278,42 +297,47 @@ inline void HoughLinesPR::minLineLencb(int value, void* userData) {
 }
 
 inline void HoughLinesPR::clear() {
-    all_lines_.clear();
-    left_lines_.clear();
-    right_lines_.clear();
+    ws_.all_lines.clear();
+    ws_.left_lines.clear();
+    ws_.right_lines.clear();
 }
 
-inline void HoughLinesPR::hough_horizontal() {
-    // not optimized what so ever..
-    // splitting things up in smaller function would help!
-    lines_.reserve(image_.cols * image_.rows);
+inline void HoughLinesPR::process(const cv::Mat& in, Workspace& ws) const {
 
-    HoughLinesP(image_, lines_, rho_, calc::PI / 4.0, threshold_, static_cast<double>(min_line_len_), static_cast<double>(max_line_gab_));
+    ws.image = in;
 
-    auto count = lines_.size();
+    HoughLinesP(in, ws.lines, rho_, calc::PI / 4.0, threshold_, static_cast<double>(min_line_len_), static_cast<double>(max_line_gab_));
+
+    auto count = ws.lines.size();
 
     // set up data containers.
 
-    all_lines_.clear();
-    all_lines_.reserve(count);
+    ws.all_lines.clear();
+    ws.all_lines.reserve(count);
 
-    left_lines_.clear();
-    left_lines_.reserve(count);
+    ws.left_lines.clear();
+    ws.left_lines.reserve(count);
 
-    right_lines_.clear();
-    right_lines_.reserve(count);
+    ws.right_lines.clear();
+    ws.right_lines.reserve(count);
 
-    center_ = static_cast<double>(image_.cols) * 0.5f;
+    ws.center = static_cast<double>(in.cols) * 0.5f;
 
     // insert lines into data structure.
-    for (auto& line : lines_)
-        all_lines_.emplace_back(LineH(line, line_pair<float>(line[0], line[2], line[1], line[3])));
+    for (auto& line : ws.lines)
+        ws.all_lines.emplace_back(LineH(line, line_pair<float>(line[0], line[2], line[1], line[3])));
+
+    bresenham(ws);
+
+}
+
+inline void HoughLinesPR::hough_horizontal() {
 
-    bresenham();
+    process(image_, ws_);
 
     if (show_windows_) {
-        draw_lines(left_lines_, cv::Scalar(255, 0, 255));
-        draw_lines(right_lines_, cv::Scalar(0, 255, 0));
+        draw_lines(ws_.left_lines, cv::Scalar(255, 0, 255));
+        draw_lines(ws_.right_lines, cv::Scalar(0, 255, 0));
         show();
     }
 
@@ -322,37 +346,38 @@ inline void HoughLinesPR::hough_horizontal() {
 /**
  * \brief Populates the lines information for main vector and populates left and right sides
  */
-inline void HoughLinesPR::bresenham() {
+inline void HoughLinesPR::bresenham(Workspace& ws) {
 
-    if (all_lines_.empty())
+    if (ws.all_lines.empty())
         return;
 
-    auto size = all_lines_.size();
+    // trace the elements of each line once, the sides get copies of the traced lines
+    for (auto& line : ws.all_lines) {
+        cv::LineIterator it(ws.image, line.points_.p1, line.points_.p2, 8);
+        line.elements_.clear();
+        line.elements_.reserve(it.count);
+        for (auto i = 0; i < it.count; i++ , ++it)
+            line.elements_.emplace_back(it.pos());
+    }
 
-    right_lines_.clear();
-    right_lines_.reserve(size);
+    auto size = ws.all_lines.size();
 
-    left_lines_.clear();
-    left_lines_.reserve(size);
+    ws.right_lines.clear();
+    ws.right_lines.reserve(size);
 
-    for (auto& line : all_lines_) {
-        if (line.entry_[0] < center_)
-            left_lines_.emplace_back(line);
-        else
-            right_lines_.emplace_back(line);
-    }
+    ws.left_lines.clear();
+    ws.left_lines.reserve(size);
 
-    // TESTING FOR ALL LINES (not required?)
-    for (auto& line : all_lines_) {
-        cv::LineIterator it(image_, line.points_.p1, line.points_.p2, 8);
-        line.elements_.reserve(it.count);
-        for (auto i = 0; i < it.count; i++ , ++it)
-            line.elements_.emplace_back(it.pos());
+    for (auto& line : ws.all_lines) {
+        if (line.entry_[0] < ws.center)
+            ws.left_lines.emplace_back(line);
+        else
+            ws.right_lines.emplace_back(line);
     }
 
 
-    auto left_size = left_lines_.size();
-    auto right_size = right_lines_.size(); // not wrong
+    auto left_size = ws.left_lines.size();
+    auto right_size = ws.right_lines.size(); // not wrong
 
     auto onlyRight = false;
 
@@ -369,14 +394,6 @@ inline void HoughLinesPR::bresenham() {
     //else
     //	onlyRight = lSize == 0;
 
-    // build right side line points
-    for (auto& right_line : right_lines_) {
-        cv::LineIterator it(image_, right_line.points_.p1, right_line.points_.p2, 8);
-        right_line.elements_.reserve(it.count);
-        for (auto i = 0; i < it.count; i++ , ++it)
-            right_line.elements_.emplace_back(it.pos());
-    }
-
     //// sort if needed
     //if (rSize > 1)
     //	sort(rightLines.begin(), rightLines.end(), lineHsizeSort);
@@ -385,14 +402,6 @@ inline void HoughLinesPR::bresenham() {
     //if (onlyRight)
     //	return;
 
-    // build left side line points
-    for (auto& left_line : left_lines_) {
-        cv::LineIterator it(image_, left_line.points_.p1, left_line.points_.p2, 8);
-        left_line.elements_.reserve(it.count);
-        for (auto i = 0; i < it.count; i++ , ++it)
-            left_line.elements_.emplace_back(it.pos());
-    }
-
     //// sort if needed
     //if (lSize > 1)
     //	sort(leftLines.begin(), leftLines.end(), lineHsizeSort);
@@ -456,5 +465,5 @@ inline void HoughLinesPR::draw_line(cv::Vec4f& line, cv::Scalar colour) {
 }
 
 inline void HoughLinesPR::show() const {
-    imshow(window_name_, output_);
+    draw::showImage(window_name_, output_);
 }
@@ -1,9 +1,15 @@
 #include <opencv2/core.hpp>
+#include <cstring>
 #include "HoughLinesR.h"
+#include "Util/HugePageAllocator.h"
 
 bool HoughLinesR::is_lines_intersecting(Side side) {
+    return is_lines_intersecting(side, ws_);
+}
+
+bool HoughLinesR::is_lines_intersecting(Side side, const Workspace& ws) {
 
-    auto& lines = side == Side::Right ? right_lines_ : left_lines_;
+    auto& lines = side == Side::Right ? ws.right_lines : ws.left_lines;
 
     if (lines.empty())
         return false;
@@ -29,39 +35,39 @@ bool HoughLinesR::is_lines_intersecting(Side side) {
 
 }
 
-void HoughLinesR::compute_meta() {
+void HoughLinesR::compute_meta(Workspace& ws) {
 
-    if (all_lines_.empty())
+    if (ws.all_lines.empty())
         return;
 
-    auto size = all_lines_.size();
+    auto size = ws.all_lines.size();
 
-    right_lines_.clear();
-    right_lines_.reserve(size);
+    ws.right_lines.clear();
+    ws.right_lines.reserve(size);
 
-    left_lines_.clear();
-    left_lines_.reserve(size);
+    ws.left_lines.clear();
+    ws.left_lines.reserve(size);
 
-    auto center = image_.cols / 2;
+    auto center = ws.image.cols / 2;
 
     using namespace tg;
 
     //log_time << __FUNCTION__ << " center: " << center << std::endl;
 
-    for (auto& a : all_lines_) {
+    for (auto& a : ws.all_lines) {
         // TODO : do something in regards to the slobe
         a.slobe = calc::slope(a.entry_[0], a.entry_[2], a.entry_[1], a.entry_[3]);
         if (a.points.p1.x > center) {
             //log_time << __FUNCTION__ << " right point added : " << a.points.p1 << std::endl;
-            right_lines_.emplace_back(a);
+            ws.right_lines.emplace_back(a);
         } else {
             //log_time << __FUNCTION__ << " left point added : " << a.points.p1 << std::endl;
-            left_lines_.emplace_back(a);
+            ws.left_lines.emplace_back(a);
         }
     }
 
-    auto lSize = left_lines_.size();
-    auto rSize = right_lines_.size();
+    auto lSize = ws.left_lines.size();
+    auto rSize = ws.right_lines.size();
 
     //// TODO : replace with throw asserts ?
     //if (lSize + rSize == 0)
@@ -73,8 +79,8 @@ void HoughLinesR::compute_meta() {
     //if (rSize == 0)
     //    throw NoLineDetectedException("No marking right line detected.");
 
-    for (auto& left : left_lines_) {
-        cv::LineIterator it(image_, left.points.p1, left.points.p2, 8);
+    for (auto& left : ws.left_lines) {
+        cv::LineIterator it(ws.image, left.points.p1, left.points.p2, 8);
         left.elements.reserve(it.count);
         for (auto i = 0; i < it.count; i++ , ++it)
             left.elements.emplace_back(it.pos());
@@ -85,16 +91,119 @@ void HoughLinesR::compute_meta() {
     };
 
     if (lSize > 1)
-        std::sort(left_lines_.begin(), left_lines_.end(), line_sort);
+        std::sort(ws.left_lines.begin(), ws.left_lines.end(), line_sort);
 
-    for (auto& right : right_lines_) {
-        cv::LineIterator it(image_, right.points.p1, right.points.p2, 8);
+    for (auto& right : ws.right_lines) {
+        cv::LineIterator it(ws.image, right.points.p1, right.points.p2, 8);
         right.elements.reserve(it.count);
         for (auto i = 0; i < it.count; i++ , ++it)
             right.elements.emplace_back(it.pos());
     }
 
     if (rSize > 1)
-        std::sort(right_lines_.begin(), right_lines_.end(), line_sort);
+        std::sort(ws.right_lines.begin(), ws.right_lines.end(), line_sort);
+
+}
+
+template <typename ForEachEdge>
+void HoughLinesR::vote_edges(int rows, int cols, ForEachEdge for_each_edge, Workspace& ws) const {
+
+    // same layout and resolution as cv::HoughLines(image_, lines_, 1.0, calc::DEGREES, threshold_, 0, 0)
+    const auto rho = 1.0;
+    const auto theta = calc::DEGREES;
+    const auto num_angle = cvRound((max_theta_ - min_theta_) / theta);
+    const auto num_rho = cvRound(((cols + rows) * 2 + 1) / rho);
+    const auto width = num_rho + 2;
+
+    // vote for the accepted angles and their direct neighbours, so the local maximum check is the same as for all angles
+    vector<int> angles;
+    vector<float> tab_cos(num_angle);
+    vector<float> tab_sin(num_angle);
+    vector<bool> accepted(num_angle);
+
+    for (auto n = 0; n < num_angle; n++) {
+        auto angle = min_theta_ + n * theta;
+        tab_cos[n] = static_cast<float>(cos(angle) / rho);
+        tab_sin[n] = static_cast<float>(sin(angle) / rho);
+        accepted[n] = is_angle_accepted(angle);
+    }
+
+    for (auto n = 0; n < num_angle; n++)
+        if (accepted[n] || (n > 0 && accepted[n - 1]) || (n + 1 < num_angle && accepted[n + 1]))
+            angles.emplace_back(n);
+
+    // only reallocated when the frame size changes, a buffer from another allocator is released by that one
+    ws.accumulator.allocator = HugePageAllocator::instance();
+    ws.accumulator.create(num_angle + 2, width, CV_32SC1);
+    ws.accumulator.setTo(cv::Scalar::all(0));
+
+    const auto rho_offset = (num_rho - 1) / 2;
+    auto accum = ws.accumulator.ptr<int>();
+
+    for_each_edge([&](int x, int y) {
+        for (auto n : angles) {
+            auto r = cvRound(x * tab_cos[n] + y * tab_sin[n]) + rho_offset;
+            accum[(n + 1) * width + r + 1]++;
+        }
+    });
+
+    // find local maximums
+    vector<int> sort_buf;
+
+    for (auto n = 0; n < num_angle; n++) {
+        if (!accepted[n])
+            continue;
+        for (auto r = 0; r < num_rho; r++) {
+            auto base = (n + 1) * width + r + 1;
+            if (accum[base] > threshold_ &&
+                accum[base] > accum[base - 1] && accum[base] >= accum[base + 1] &&
+                accum[base] > accum[base - width] && accum[base] >= accum[base + width])
+                sort_buf.emplace_back(base);
+        }
+    }
+
+    // strongest lines first, same as cv::HoughLines
+    std::sort(sort_buf.begin(), sort_buf.end(), [accum](int l1, int l2) {
+        return accum[l1] > accum[l2] || (accum[l1] == accum[l2] && l1 < l2);
+    });
+
+    ws.lines.clear();
+    ws.lines.reserve(sort_buf.size());
+
+    const auto scale = 1.0 / width;
+
+    for (auto idx : sort_buf) {
+        auto n = cvFloor(idx * scale) - 1;
+        auto r = idx - (n + 1) * width - 1;
+        ws.lines.emplace_back(static_cast<float>((r - (num_rho - 1) * 0.5f) * rho), static_cast<float>(min_theta_ + n * theta));
+    }
+
+}
+
+void HoughLinesR::vote(const BinaryImage& edges, Workspace& ws) const {
+    vote_edges(edges.rows(), edges.cols(), [&edges](const auto& func) { edges.for_each(func); }, ws);
+}
 
+void HoughLinesR::vote(const cv::Mat& edges, Workspace& ws) const {
+    CV_Assert(edges.type() == CV_8UC1);
+
+    // edges are sparse, eight pixels are tested at once and skipped together when all are zero
+    vote_edges(edges.rows, edges.cols, [&edges](const auto& func) {
+                   for (auto y = 0; y < edges.rows; y++) {
+                       auto row = edges.ptr<uchar>(y);
+                       auto x = 0;
+                       for (; x + 8 <= edges.cols; x += 8) {
+                           uint64_t word;
+                           std::memcpy(&word, row + x, sizeof(word));
+                           if (!word)
+                               continue;
+                           for (auto i = x; i < x + 8; i++)
+                               if (row[i])
+                                   func(i, y);
+                       }
+                       for (; x < edges.cols; x++)
+                           if (row[x])
+                               func(x, y);
+                   }
+               }, ws);
 }
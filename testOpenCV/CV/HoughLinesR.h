@@ -1,12 +1,14 @@
 #pragma once
 #include <opencv2/core/mat.hpp>
 #include <opencv2/videostab/inpainting.hpp>
-#include <opencv2/highgui.hpp>
 #include <iostream>
+#include <sstream>
 
 #include "BaseR.h"
+#include "BinaryImage.h"
 #include "../namespaces/tg.h"
 #include "../namespaces/calc.h"
+#include "../namespaces/draw.h"
 #include "../namespaces/validate.h"
 
 #include "Exceptions/NoLineDetectedException.h"
@@ -91,24 +93,45 @@ public:
         return output_;
     }
 
-private:
-    // the line output for the houghlines algorithm
-    vector<cv::Vec2f> lines_;
+    /**
+     * \brief The per call state of the line detection, one per thread.
+     * The configuration (threshold, angles) lives in the HoughLinesR object and is shared.
+     */
+    struct Workspace {
+        // the image the lines were detected in
+        cv::Mat image;
+
+        // the line output for the houghlines algorithm
+        vector<cv::Vec2f> lines;
+
+        // the lines with all information
+        vector<LineV> all_lines;
+
+        // the lines located on the right side of the image
+        vector<LineV> right_lines;
+
+        // the lines location on the left side of the image
+        vector<LineV> left_lines;
 
-    // the lines with all information
-    vector<LineV> all_lines_;
+        // the x coordinates of the left "border" of the marking
+        cv::Vec4d left_border;
 
-    // the lines located on the right side of the image
-    vector<LineV> right_lines_;
+        // the x coordinates of the right "border" of the marking
+        cv::Vec4d right_border;
 
-    // the lines location on the left side of the image
-    vector<LineV> left_lines_;
+        cv::Rect2d marking_rect;
 
-    // the x coordinates of the left "border" of the marking
-    cv::Vec4d left_border_;
+        // the hough accumulator for voting directly from the edges, CV_32SC1 angles x distances,
+        // several MB per frame size, so it is kept to avoid reallocation and served from huge pages
+        cv::Mat accumulator;
+
+        // messages of compute_borders(), logged by the caller so workers do not write to the log concurrently
+        std::string log;
+    };
+
+private:
 
-    // the x coordinates of the right "border" of the marking
-    cv::Vec4d right_border_;
+    Workspace ws_;
 
     double left_y_ = 0.0;
 
@@ -151,22 +174,35 @@ public:
         min_theta_ = 0.0;
         max_theta_ = calc::PI;
         angle_limit_ = 0;
-        if (show_window)
+        if (show_windows_)
             create_window();
     }
 
     void compute_borders();
 
+    /**
+     * \brief Computes the marking rectangle and borders from the lines in a workspace
+     * \param ws The workspace with the lines from process()
+     */
+    void compute_borders(Workspace& ws) const;
+
+    /**
+     * \brief Draws the borders of a workspace on the original image and shows it, only with windows
+     */
+    void show_borders(Workspace& ws);
+
     bool is_lines_intersecting(Side side);
 
+    static bool is_lines_intersecting(Side side, const Workspace& ws);
+
     void draw_lines(vector<LineV>& linePairs, cv::Scalar colour);
 
 private:
     void create_window() {
-        namedWindow(window_name_, cv::WINDOW_KEEPRATIO);
-        cv::createTrackbar("rho", window_name_, &rho_, 3, rhocb, this);
-        cv::createTrackbar("theta", window_name_, &theta_, 180, thetacb, this);
-        cv::createTrackbar("threshold", window_name_, &threshold_, 100, thresholdcb, this);
+        draw::makeWindow(window_name_, true);
+        draw::makeTrackbar("rho", window_name_, &rho_, 3, rhocb, this);
+        draw::makeTrackbar("theta", window_name_, &theta_, 180, thetacb, this);
+        draw::makeTrackbar("threshold", window_name_, &threshold_, 100, thresholdcb, this);
     }
 
     line_pair<float> compute_point_pair(cv::Vec2f& line) const;
@@ -175,7 +211,21 @@ private:
 
     void show_output() const;
 
-    void compute_meta();
+    static void compute_meta(Workspace& ws);
+
+    bool is_angle_accepted(double theta) const;
+
+    int process_lines(Workspace& ws) const;
+
+    /**
+     * \brief Votes for the accepted angles and their neighbours, calling for_each_edge(func) has to call func(x, y) for each edge pixel
+     */
+    template <typename ForEachEdge>
+    void vote_edges(int rows, int cols, ForEachEdge for_each_edge, Workspace& ws) const;
+
+    void vote(const BinaryImage& edges, Workspace& ws) const;
+
+    void vote(const cv::Mat& edges, Workspace& ws) const;
 
     static void compute_rect_from_lines(vector<LineV>& input, cv::Rect2d& output);
 
@@ -206,60 +256,101 @@ private:
 
 public:
 
+    /**
+     * \brief Computes the vertical lines with the current configuration, does not modify the object or show any windows
+     * \param in The edge image
+     * \param ws The workspace to store the lines in
+     * \return 0 if ok, -1 if no lines at all, -2 if no vertical lines
+     */
+    int process(const cv::Mat& in, Workspace& ws) const;
+
+    /**
+     * \brief Computes the vertical lines by voting directly from the set bits of a bit packed edge image.
+     * \param in The unpacked edge image, used for the line elements
+     * \param edges The bit packed edge image
+     * \param ws The workspace to store the lines in
+     * \return 0 if ok, -1 if no lines at all, -2 if no vertical lines
+     */
+    int process(const cv::Mat& in, const BinaryImage& edges, Workspace& ws) const;
+
+    /**
+     * \brief Computes the vertical lines by voting directly from the non-zero pixels of the edge image, it is not packed first.
+     * Same lines as the bit packed voting, for edges that are not already bit packed.
+     * \param in The 8 bit edge image
+     * \param ws The workspace to store the lines in
+     * \return 0 if ok, -1 if no lines at all, -2 if no vertical lines
+     */
+    int process_voting(const cv::Mat& in, Workspace& ws) const;
+
     int hough_vertical();
 
+    /**
+     * \brief Computes the vertical lines by voting directly from the non-zero pixels of the image (set with image())
+     * \return 0 if ok, -1 if no lines at all, -2 if no vertical lines
+     */
+    int hough_vertical_voting();
+
+    /**
+     * \brief Computes the vertical lines by voting directly from the set bits of a bit packed edge image.
+     * Only the angles accepted by the angle limit are voted for.
+     * The image (set with image()) is still used for the line elements, and should be the unpacked edges.
+     * \param edges The bit packed edge image
+     * \return 0 if ok, -1 if no lines at all, -2 if no vertical lines
+     */
+    int hough_vertical(const BinaryImage& edges);
+
     void angle_limit(double angleLimit) {
         this->angle_limit_ = angleLimit;
     }
 
-    void original(cv::Mat& original) {
+    void original(const cv::Mat& original) {
         original_ = original;
         if (show_windows_)
             cvtColor(original_, output_, CV_GRAY2BGR);
     }
 
     const vector<cv::Vec2f>& lines() const {
-        return lines_;
+        return ws_.lines;
     }
 
     const vector<LineV>& all_lines() const {
-        return all_lines_;
+        return ws_.all_lines;
     }
 
     void all_lines(const vector<LineV>& allLines) {
-        this->all_lines_ = allLines;
+        ws_.all_lines = allLines;
     }
 
     const vector<LineV>& right_lines() const {
-        return right_lines_;
+        return ws_.right_lines;
     }
 
     void right_lines(const vector<LineV>& rightLines) {
-        this->right_lines_ = rightLines;
+        ws_.right_lines = rightLines;
     }
 
     const vector<LineV>& left_lines() const {
-        return left_lines_;
+        return ws_.left_lines;
     }
 
     void left_lines(const vector<LineV>& leftLines) {
-        this->left_lines_ = leftLines;
+        ws_.left_lines = leftLines;
     }
 
     const cv::Vec4d& left_border() const {
-        return left_border_;
+        return ws_.left_border;
     }
 
     const cv::Vec4d& right_border() const {
-        return right_border_;
+        return ws_.right_border;
     }
 
     void left_border(cv::Vec4d leftBorder) {
-        left_border_ = leftBorder;
+        ws_.left_border = leftBorder;
     }
 
     void right_border(cv::Vec4d rightBorder) {
-        right_border_ = rightBorder;
+        ws_.right_border = rightBorder;
     }
 };
 
@@ -282,57 +373,79 @@ inline void HoughLinesR::compute_rect_from_lines(vector<LineV>& input, cv::Rect2
 
 inline void HoughLinesR::compute_borders() {
 
-    cv::Rect2d left_roi(0.0, 0.0, 0.0, static_cast<double>(image_.rows));
-    cv::Rect2d right_roi(0.0, 0.0, 0.0, static_cast<double>(image_.rows));
+    ws_.log.clear();
+    compute_borders(ws_);
+    marking_rect_ = ws_.marking_rect;
+    log_time << ws_.log;
+
+    if (show_windows_) {
+        draw_line(ws_.left_border);
+        draw_line(ws_.right_border);
+        show_output();
+    }
+
+}
+
+inline void HoughLinesR::compute_borders(Workspace& ws) const {
+
+    auto& left_lines = ws.left_lines;
+    auto& right_lines = ws.right_lines;
+    auto& left_border = ws.left_border;
+    auto& right_border = ws.right_border;
+    auto& marking_rect = ws.marking_rect;
+
+    cv::Rect2d left_roi(0.0, 0.0, 0.0, static_cast<double>(ws.image.rows));
+    cv::Rect2d right_roi(0.0, 0.0, 0.0, static_cast<double>(ws.image.rows));
 
-    compute_rect_from_lines(left_lines_, left_roi);
+    std::ostringstream log;
+
+    compute_rect_from_lines(left_lines, left_roi);
     if (!validate::validate_rect(left_roi)) {
-        for (int i = 0; i < left_lines_.size(); i++) {
-            cv::Rect2f t = cv::boundingRect(left_lines_[i].elements);
-            log_time << __FUNCTION__ << " bounding rect for line : " << t << std::endl;
+        for (int i = 0; i < left_lines.size(); i++) {
+            cv::Rect2f t = cv::boundingRect(left_lines[i].elements);
+            log << __FUNCTION__ << " bounding rect for line : " << t << '\n';
         }
-        log_time << __FUNCTION__ << " leftRoi : " << left_roi << std::endl;
+        log << __FUNCTION__ << " leftRoi : " << left_roi << '\n';
+        ws.log += log.str();
+        log.str("");
         throw_assert(!validate::validate_rect(left_roi), "Left ROI rect failed validation!!!");
     }
 
-    compute_rect_from_lines(right_lines_, right_roi);
+    compute_rect_from_lines(right_lines, right_roi);
     if (!validate::validate_rect(right_roi)) {
-        for (auto i = 0; i < right_lines_.size(); i++) {
-            cv::Rect2f t = cv::boundingRect(right_lines_[i].elements);
-            log_time << __FUNCTION__ << " bounding rect for right line : " << t << std::endl;
+        for (auto i = 0; i < right_lines.size(); i++) {
+            cv::Rect2f t = cv::boundingRect(right_lines[i].elements);
+            log << __FUNCTION__ << " bounding rect for right line : " << t << '\n';
         }
-        log_time << __FUNCTION__ << " rightRoi : " << left_roi << std::endl;
+        log << __FUNCTION__ << " rightRoi : " << left_roi << '\n';
+        ws.log += log.str();
+        log.str("");
         throw_assert(!validate::validate_rect(right_roi), "Right ROI rect failed validation!!!");
     }
 
-    auto img_height = static_cast<double>(image_.rows);
+    auto img_height = static_cast<double>(ws.image.rows);
 
-    log_time << __FUNCTION__ << " left_roi: " << left_roi << '\n';
-    log_time << __FUNCTION__ << " right_roi: " << right_roi << '\n';
+    log << __FUNCTION__ << " left_roi: " << left_roi << '\n';
+    log << __FUNCTION__ << " right_roi: " << right_roi << '\n';
+    ws.log += log.str();
 
-    marking_rect_.x = left_roi.x;
-    marking_rect_.y = left_roi.y;
-    marking_rect_.width = right_roi.x - left_roi.x + right_roi.width;
-    marking_rect_.height = img_height;
-    throw_assert(validate::validate_rect(marking_rect_), "Marking rect failed validation!!!");
+    marking_rect.x = left_roi.x;
+    marking_rect.y = left_roi.y;
+    marking_rect.width = right_roi.x - left_roi.x + right_roi.width;
+    marking_rect.height = img_height;
+    throw_assert(validate::validate_rect(marking_rect), "Marking rect failed validation!!!");
 
-    left_border_[0] = left_roi.x;
-    left_border_[1] = img_height;
-    left_border_[2] = left_roi.x + left_roi.width;
-    left_border_[3] = 0.0f;
-    throw_assert((validate::valid_vec<float, 4>(left_border_)), "Left border failed validation!!!");
+    left_border[0] = left_roi.x;
+    left_border[1] = img_height;
+    left_border[2] = left_roi.x + left_roi.width;
+    left_border[3] = 0.0f;
+    throw_assert((validate::valid_vec<float, 4>(left_border)), "Left border failed validation!!!");
 
-    right_border_[0] = right_roi.x;
-    right_border_[1] = 0.0f;
-    right_border_[2] = right_roi.x + right_roi.width;
-    right_border_[3] = img_height;
-    throw_assert((validate::valid_vec<float, 4>(right_border_)), "Right border failed validation!!!");
-
-    if (show_windows_) {
-        draw_line(left_border_);
-        draw_line(right_border_);
-        show_output();
-    }
+    right_border[0] = right_roi.x;
+    right_border[1] = 0.0f;
+    right_border[2] = right_roi.x + right_roi.width;
+    right_border[3] = img_height;
+    throw_assert((validate::valid_vec<float, 4>(right_border)), "Right border failed validation!!!");
 
 }
 
@@ -357,42 +470,84 @@ inline void HoughLinesR::thresholdcb(int value, void* user_data) {
     log_time << cv::format("%s threshold : %i\n", that->window_name_, value);
 }
 
-inline int HoughLinesR::hough_vertical() {
+inline int HoughLinesR::process(const cv::Mat& in, Workspace& ws) const {
 
-    if (!lines_.empty())
-        lines_.clear();
+    ws.image = in;
+    ws.lines.clear();
 
     //cv::HoughLines(image, lines, rho, angle, threshold, srn, stn, minTheta, maxTheta);
-    HoughLines(image_, lines_, 1.0, calc::DEGREES, threshold_, 0, 0);
+    HoughLines(in, ws.lines, 1.0, calc::DEGREES, threshold_, 0, 0);
+
+    return process_lines(ws);
+
+}
+
+inline int HoughLinesR::process(const cv::Mat& in, const BinaryImage& edges, Workspace& ws) const {
+
+    ws.image = in;
+
+    vote(edges, ws);
+
+    return process_lines(ws);
+
+}
+
+inline int HoughLinesR::process_voting(const cv::Mat& in, Workspace& ws) const {
+
+    ws.image = in;
+
+    vote(in, ws);
+
+    return process_lines(ws);
+
+}
+
+inline int HoughLinesR::hough_vertical() {
+    return process(image_, ws_);
+}
+
+inline int HoughLinesR::hough_vertical_voting() {
+    return process_voting(image_, ws_);
+}
+
+inline int HoughLinesR::hough_vertical(const BinaryImage& edges) {
+    return process(image_, edges, ws_);
+}
 
-    if (lines_.empty())
+inline bool HoughLinesR::is_angle_accepted(double theta) const {
+    return theta > calc::DEGREES * (180 - angle_limit_) || theta < calc::DEGREES * angle_limit_;
+}
+
+inline int HoughLinesR::process_lines(Workspace& ws) const {
+
+    if (ws.lines.empty())
         return -1;
 
-    all_lines_.clear();
-    all_lines_.reserve(lines_.size());
+    ws.all_lines.clear();
+    ws.all_lines.reserve(ws.lines.size());
 
     auto pos = 0;
 
-    for (auto& line : lines_) {
+    for (auto& line : ws.lines) {
         auto theta = line[1];
-        if (theta <= calc::DEGREES * (180 - angle_limit_) && theta >= calc::DEGREES * angle_limit_)
+        if (!is_angle_accepted(theta))
             continue;
 
         //log_time << "vhough1\n";
         auto p = compute_point_pair(line);
-        all_lines_.emplace_back(LineV(line, p));
+        ws.all_lines.emplace_back(LineV(line, p));
         pos++;
     }
 
-    //log_time << __FUNCTION__ << " all line count : " << all_lines_.size() << std::endl;
+    //log_time << __FUNCTION__ << " all line count : " << ws.all_lines.size() << std::endl;
 
-    if (all_lines_.empty())
+    if (ws.all_lines.empty())
         return -2;
     //cerr << "FATAL ERROR, NO VERTICAL LINES DETECTED!";
 
     //log_time << "vhough2\n";
 
-    compute_meta();
+    compute_meta(ws);
 
     return 0;
 
@@ -429,9 +584,18 @@ inline void HoughLinesR::draw_line(cv::Vec4d& line) {
     cv::line(output_, p1, p2, cv::Scalar(120, 120, 255), 2);
 }
 
+inline void HoughLinesR::show_borders(Workspace& ws) {
+    if (!show_windows_)
+        return;
+
+    draw_line(ws.left_border);
+    draw_line(ws.right_border);
+    show_output();
+}
+
 inline void HoughLinesR::show_output() const {
     if (!show_windows_)
         return;
 
-    imshow(window_name_, output_);
+    draw::showImage(window_name_, output_);
 }
@@ -1,12 +1,34 @@
 #pragma once
 #include "BaseR.h"
+#include "BinaryImage.h"
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgproc.hpp>
-#include <opencv2/highgui/highgui.hpp>
+#include "../namespaces/draw.h"
 
+/**
+ * \brief Morphology wrapper class.
+ * The method and structure element are the configuration, process() only reads them and can be called from several threads,
+ * each with its own workspace.
+ */
 class MorphR : public BaseR {
 
-    cv::Mat output_;
+public:
+
+    /**
+     * \brief The per call state of the morphology, one per thread
+     */
+    struct Workspace {
+        cv::Mat output;
+
+        BinaryImage packed;
+
+        // only valid if the last process was done in binary mode
+        BinaryImage packed_output;
+    };
+
+private:
+
+    Workspace ws_;
 
     cv::Mat structure_element_;
 
@@ -16,18 +38,45 @@ class MorphR : public BaseR {
 
     int iterations_;
 
+    /**
+     * \brief The radius of the (square) structure element, an empty element is 3x3
+     */
+    int structure_radius_;
+
+    /**
+     * \brief Process binary input (such as canny edges) bit packed, 64 pixels per word
+     */
+    bool binary_;
+
 public:
 
-    explicit MorphR(cv::MorphTypes method, const int iterations, const bool show_window)
+    explicit MorphR(cv::MorphTypes method, const int iterations, const bool show_window, const bool binary = false)
         : BaseR("MorphR", show_window)
           , method_(method)
-          , iterations_(iterations) {
+          , iterations_(iterations)
+          , structure_radius_(1)
+          , binary_(binary) {
         structure_element_ = cv::Mat();
         element_shape_ = cv::MORPH_RECT;
     }
 
     const cv::Mat& result() const {
-        return output_;
+        return ws_.output;
+    }
+
+    /**
+     * \brief The bit packed result, only valid if the last morph() was done in binary mode
+     */
+    const BinaryImage& binary_result() const {
+        return ws_.packed_output;
+    }
+
+    bool binary() const {
+        return binary_;
+    }
+
+    void binary(bool binary) {
+        binary_ = binary;
     }
 
     cv::MorphTypes method() const {
@@ -56,22 +105,76 @@ public:
 
     void generate_structure_element(int size) {
         structure_element_ = getStructuringElement(element_shape_, cv::Size(2 * size + 1, 2 * size + 1), cv::Point(size, size));
+        structure_radius_ = size;
     }
 
     void resetStructureElement() {
         structure_element_ = cv::Mat();
+        structure_radius_ = 1;
+    }
+
+    /**
+     * \brief Performs the morphology with the current configuration, does not modify the object or show any windows
+     * \param in The image to process
+     * \param ws The workspace to store the result in
+     */
+    void process(const cv::Mat& in, Workspace& ws) const {
+        if (binary_ && morph_binary(in, ws)) {
+            ws.packed_output.unpack(ws.output);
+        } else
+            cv::morphologyEx(in, ws.output, method_, structure_element_, cv::Point(-1, -1), iterations_);
     }
 
     void morph() {
-        cv::morphologyEx(image_, output_, method_, structure_element_, cv::Point(-1, -1), iterations_);
+        process(image_, ws_);
+
         if (show_windows_)
             show();
     }
 
 private:
 
+    /**
+     * \brief Performs the morphology on the bit packed image.
+     * Only rectangular structure elements and the erode, dilate, open, close and gradient methods are supported.
+     * \return true if the morphology was done, false if it is not supported
+     */
+    bool morph_binary(const cv::Mat& in, Workspace& ws) const {
+        if (in.type() != CV_8UC1 || (!structure_element_.empty() && element_shape_ != cv::MORPH_RECT))
+            return false;
+
+        // iterating a square element n times equals a single pass with n times the radius
+        auto radius = structure_radius_ * iterations_;
+
+        ws.packed.pack(in);
+
+        switch (method_) {
+        case cv::MORPH_ERODE:
+            ws.packed.erode(ws.packed_output, radius);
+            break;
+        case cv::MORPH_DILATE:
+            ws.packed.dilate(ws.packed_output, radius);
+            break;
+        case cv::MORPH_OPEN:
+            ws.packed.erode(ws.packed_output, radius);
+            ws.packed_output.dilate(ws.packed_output, radius);
+            break;
+        case cv::MORPH_CLOSE:
+            ws.packed.dilate(ws.packed_output, radius);
+            ws.packed_output.erode(ws.packed_output, radius);
+            break;
+        case cv::MORPH_GRADIENT:
+            ws.packed.gradient(ws.packed_output, radius);
+            break;
+        default:
+            return false;
+        }
+
+        return true;
+    }
+
     void show() const {
-        cv::imshow(window_name_, output_);
+        draw::showImage(window_name_, ws_.output);
     }
 
 };
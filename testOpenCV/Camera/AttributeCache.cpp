@@ -0,0 +1,190 @@
+#include "AttributeCache.h"
+#include <cstdio>
+#include <vector>
+
+AttributeCache::AttributeCache(tPvHandle handle)
+    : handle_(handle) { }
+
+void AttributeCache::handle(tPvHandle new_handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    handle_ = new_handle;
+    for (auto& entry : entries_) {
+        entry.second.valid = false;
+        entry.second.dirty = false;
+    }
+}
+
+tPvErr AttributeCache::load(const char* name, Entry& entry) const {
+    if (entry.valid) {
+        ++entry.counts.hits;
+        return ePvErrSuccess;
+    }
+
+    ++entry.counts.reads;
+    auto err_code = PvAttrUint32Get(handle_, name, &entry.value);
+    entry.valid = err_code == ePvErrSuccess;
+    return err_code;
+}
+
+tPvErr AttributeCache::write(const char* name, Entry& entry, unsigned long value) {
+    ++entry.counts.writes;
+    auto err_code = PvAttrUint32Set(handle_, name, value);
+    entry.value = value;
+    entry.valid = err_code == ePvErrSuccess;
+    return err_code;
+}
+
+tPvErr AttributeCache::get(const char* name, unsigned long& value) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries_[name];
+    auto err_code = load(name, entry);
+    if (err_code == ePvErrSuccess)
+        value = entry.value;
+    return err_code;
+}
+
+tPvErr AttributeCache::set(const char* name, unsigned long value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries_[name];
+
+    if (entry.valid && entry.value == value) {
+        ++entry.counts.skipped;
+        return ePvErrSuccess;
+    }
+
+    return write(name, entry, value);
+}
+
+bool AttributeCache::stage(const char* name, unsigned long value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries_[name];
+
+    // the current value is needed to skip the write and to restore it if the commit fails
+    load(name, entry);
+
+    entry.staged = value;
+    entry.dirty = !entry.valid || entry.value != value;
+    if (!entry.dirty)
+        ++entry.counts.skipped;
+
+    return entry.dirty;
+}
+
+tPvErr AttributeCache::commit(std::initializer_list<const char*> order, size_t& written) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    written = 0;
+
+    // attribute and value before the write, for the roll back
+    std::vector<std::pair<const char*, Entry*>> done;
+    std::vector<unsigned long> previous;
+
+    auto err_code = ePvErrSuccess;
+
+    for (auto name : order) {
+        auto& entry = entries_[name];
+        if (!entry.dirty)
+            continue;
+
+        entry.dirty = false;
+
+        auto was_valid = entry.valid;
+        auto was = entry.value;
+
+        err_code = write(name, entry, entry.staged);
+        if (err_code != ePvErrSuccess)
+            break;
+
+        if (was_valid) {
+            done.emplace_back(name, &entry);
+            previous.emplace_back(was);
+        }
+        ++written;
+    }
+
+    if (err_code == ePvErrSuccess)
+        return err_code;
+
+    // nothing staged after the failure is written
+    for (auto name : order)
+        entries_[name].dirty = false;
+
+    for (auto i = done.size(); i--;)
+        write(done[i].first, *done[i].second, previous[i]);
+
+    written = 0;
+    return err_code;
+}
+
+tPvErr AttributeCache::region(unsigned long x, unsigned long y, unsigned long width, unsigned long height, size_t& written) {
+    unsigned long current_width = 0;
+    unsigned long current_height = 0;
+
+    auto err_code = get("Width", current_width);
+    if (err_code == ePvErrSuccess)
+        err_code = get("Height", current_height);
+    if (err_code != ePvErrSuccess) {
+        written = 0;
+        return err_code;
+    }
+
+    stage("RegionX", x);
+    stage("RegionY", y);
+    stage("Width", width);
+    stage("Height", height);
+
+    // the region has to fit on the sensor after every single write
+    auto shrink_x = width < current_width;
+    auto shrink_y = height < current_height;
+
+    if (shrink_x && shrink_y)
+        return commit({"Width", "Height", "RegionX", "RegionY"}, written);
+    if (shrink_x)
+        return commit({"Width", "RegionY", "Height", "RegionX"}, written);
+    if (shrink_y)
+        return commit({"Height", "RegionX", "Width", "RegionY"}, written);
+    return commit({"RegionX", "RegionY", "Width", "Height"}, written);
+}
+
+void AttributeCache::invalidate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_)
+        entry.second.valid = false;
+}
+
+void AttributeCache::invalidate(const char* name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[name].valid = false;
+}
+
+AttributeCache::Counts AttributeCache::counts(const char* name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    return it == entries_.end() ? Counts{0, 0, 0, 0} : it->second.counts;
+}
+
+std::map<std::string, AttributeCache::Counts> AttributeCache::counts() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, Counts> result;
+    for (auto& entry : entries_)
+        result.emplace(entry.first, entry.second.counts);
+    return result;
+}
+
+void AttributeCache::reset_counts() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_)
+        entry.second.counts = Counts{0, 0, 0, 0};
+}
+
+std::string AttributeCache::report() const {
+    std::string result;
+    char line[128];
+    for (auto& entry : counts()) {
+        auto& c = entry.second;
+        std::snprintf(line, sizeof(line), "%-16s reads %6lu, writes %6lu, cached %6lu, unchanged %6lu\n",
+                      entry.first.c_str(), c.reads, c.writes, c.hits, c.skipped);
+        result += line;
+    }
+    return result;
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <initializer_list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <PvApi.h>
+
+/**
+ * \brief Write-through cache of the unsigned integer attributes of a PvAPI camera.
+ * A value is read from the camera once and then served from the cache, writes go to the camera right away
+ * and are skipped when the camera already has the value. A failed write drops the cached value,
+ * as the camera state is unknown then. Attributes the camera changes by itself must not be read through the cache,
+ * and invalidate() has to be called after changing anything the cached attributes depend on.
+ * Writes can be staged and committed together, only the attributes that changed are written.
+ */
+class AttributeCache {
+
+public:
+
+    /**
+     * \brief Calls made for an attribute
+     */
+    struct Counts {
+        // reads from the camera
+        unsigned long reads;
+        // writes to the camera
+        unsigned long writes;
+        // reads served from the cache
+        unsigned long hits;
+        // writes skipped because the value was unchanged
+        unsigned long skipped;
+    };
+
+private:
+
+    struct Entry {
+        unsigned long value = 0;
+        bool valid = false;
+        unsigned long staged = 0;
+        bool dirty = false;
+        Counts counts{0, 0, 0, 0};
+    };
+
+    tPvHandle handle_;
+
+    mutable std::mutex mutex_;
+
+    mutable std::map<std::string, Entry> entries_;
+
+    /**
+     * \brief Makes sure the entry holds the camera value, requires the lock
+     */
+    tPvErr load(const char* name, Entry& entry) const;
+
+    /**
+     * \brief Writes the value to the camera and the cache, requires the lock
+     */
+    tPvErr write(const char* name, Entry& entry, unsigned long value);
+
+public:
+
+    explicit AttributeCache(tPvHandle handle = nullptr);
+
+    /**
+     * \brief Sets the camera and drops all cached values
+     */
+    void handle(tPvHandle new_handle);
+
+    /**
+     * \brief Reads an attribute, from the camera the first time
+     */
+    tPvErr get(const char* name, unsigned long& value) const;
+
+    /**
+     * \brief Writes an attribute unless the camera already has the value
+     */
+    tPvErr set(const char* name, unsigned long value);
+
+    /**
+     * \brief Stages a write for commit()
+     * \return true if the value differs from the camera value
+     */
+    bool stage(const char* name, unsigned long value);
+
+    /**
+     * \brief Writes the staged attributes that changed, in the given order.
+     * If a write fails, the attributes written before it are restored, so the commit is all or nothing.
+     * \param order The staged attributes in the order they are written
+     * \param written Receives the number of attributes written
+     * \return The error of the failed write, ePvErrSuccess if all were written
+     */
+    tPvErr commit(std::initializer_list<const char*> order, size_t& written);
+
+    /**
+     * \brief Changes the region of interest, ordering the writes so the region stays on the sensor in between.
+     * A region that shrinks along an axis is resized before it is moved, one that grows is moved first.
+     * \return The error of the failed write, ePvErrSuccess if the region was changed
+     */
+    tPvErr region(unsigned long x, unsigned long y, unsigned long width, unsigned long height, size_t& written);
+
+    /**
+     * \brief Drops all cached values
+     */
+    void invalidate();
+
+    /**
+     * \brief Drops the cached value of an attribute
+     */
+    void invalidate(const char* name);
+
+    Counts counts(const char* name) const;
+
+    /**
+     * \brief The calls for every attribute used so far
+     */
+    std::map<std::string, Counts> counts() const;
+
+    void reset_counts();
+
+    /**
+     * \brief One line per attribute with its calls, for the log
+     */
+    std::string report() const;
+
+};
@@ -2,51 +2,124 @@
 
 #include <vector>
 #include <string>
+#include <opencv2/core.hpp>
 #include "../namespaces/tg.h"
 
-using CaptureSettings = struct CaptureSettings {
+/**
+ * \brief The capture devices the measurement runs on, a camera, a simulation or a recording.
+ * The calls follow the order of a camera session : initialize, open, prepare, region, frame_init, cap_init
+ * and aquisition_init before capturing, then aquisition_end, cap_end, close and uninitialize.
+ * Frames are 8 bit mono and the size of the current region. Captured frames may be backed by pooled buffers,
+ * they are leased to the caller and returned when the last reference is released.
+ * The settings are changed between frames, streaming on a thread of its own is done by CaptureThread.
+ */
+class CaptureInterface {
 
-    double brightness;
+public:
 
-    double contrast;
+    const cv::Rect_<unsigned long> default_roi_full = cv::Rect_<unsigned long>(0, 0, 2448, 2040);
 
-    double saturation;
+    const cv::Rect_<unsigned long> default_roi = cv::Rect_<unsigned long>(0, 1006, 2448, 256);
 
-    double hue;
+    virtual ~CaptureInterface() = default;
 
-    double gain;
+    /**
+     * \brief Short name of the backend, for the log
+     */
+    virtual std::string name() const = 0;
 
-    double exposure;
+    virtual bool initialize() = 0;
 
-    bool Rgb;
+    virtual void uninitialize() = 0;
 
-    double white_balance_u;
+    virtual bool open() = 0;
 
-    double white_balance_v;
+    virtual void close() = 0;
 
-    bool rectification;
+    virtual bool is_open() const = 0;
 
-    double iso_speed;
+    /**
+     * \brief Sets up the device the way the measurement expects it, mono 8 bit without binning
+     */
+    virtual void prepare() = 0;
 
-    double buffersize;
+    virtual bool frame_init() = 0;
 
-};
+    /**
+     * \return 0 on success, a negative error code otherwise
+     */
+    virtual int cap_init() const = 0;
 
-class CaptureInterface {
+    virtual bool cap_end() const = 0;
+
+    virtual bool aquisition_init() const = 0;
+
+    virtual bool aquisition_end() const = 0;
+
+    virtual bool region(cv::Rect_<unsigned long> new_region) = 0;
+
+    virtual cv::Rect_<unsigned long> region() const = 0;
+
+    /**
+     * \brief Sets the exposure in microseconds
+     */
+    virtual bool exposure(unsigned long new_value) = 0;
+
+    virtual unsigned long exposure() const = 0;
 
-protected:
-    ~CaptureInterface() = default;
+    /**
+     * \brief Sets the gain in dB
+     */
+    virtual void gain(unsigned long new_value) = 0;
 
-    bool auto_exposure = false;
+    virtual unsigned long gain() const = 0;
 
-    static std::string status(std::string pre, bool s) {
-        return pre + (s ? " ok" : " fail") + ".\n";
+    /**
+     * \brief Captures frames of the current settings
+     * \param frame_count Amount of frames to capture
+     * \param target_vector The target vector for the captured images
+     */
+    virtual void cap(int frame_count, std::vector<cv::Mat>& target_vector) = 0;
+
+    virtual void cap_single(cv::Mat& target) = 0;
+
+    /**
+     * \brief Captures a single frame with its metadata, without querying the device for its region
+     * \param target The target
+     * \param roi The region the device is set to
+     * \param timeout The maximum wait in milliseconds
+     * \param frame_id The frame counter of the device for the captured frame
+     * \param timestamp The device time of the captured frame in microseconds, 0 if unknown
+     * \return true if a frame was captured within the timeout
+     */
+    virtual bool cap_single(cv::Mat& target, const cv::Rect_<unsigned long>& roi, unsigned long timeout, unsigned long& frame_id, unsigned long long& timestamp) = 0;
+
+    /**
+     * \brief The number of frames discarded because they were exposed before a setting change
+     */
+    virtual size_t stale_frames() const = 0;
+
+    /**
+     * \brief Statistics of the backend for the log, one line per item
+     */
+    virtual std::string report() const = 0;
+
+    void exposure_add(unsigned long value) {
+        exposure(exposure() + value);
     }
 
-public:
+    void exposure_sub(unsigned long value) {
+        auto current = exposure();
+        exposure(current > value ? current - value : 1);
+    }
 
-    virtual void retrieveAllInfo() = 0;
+    void exposure_div(unsigned long value) {
+        if (value != 0)
+            exposure(exposure() / value);
+    }
 
-    //virtual void capture(int frame_count, std::vector<cv::Mat>& target_vector, unsigned long exposure) = 0;
+    void exposure_mul(unsigned long value) {
+        exposure(exposure() * value);
+    }
 
 };
@@ -0,0 +1,232 @@
+#include "CaptureOpenCV.h"
+#include <opencv2/imgproc.hpp>
+
+CaptureOpenCV::CaptureOpenCV(int device)
+    : device_(device)
+      , region_(default_roi)
+      , exposure_(5000)
+      , gain_(0)
+      , frame_id_(0)
+      , timestamp_(0)
+      , file_start_us_(0)
+      , restarts_(0) { }
+
+CaptureOpenCV::CaptureOpenCV(const std::string& filename)
+    : device_(-1)
+      , filename_(filename)
+      , region_(default_roi)
+      , exposure_(5000)
+      , gain_(0)
+      , frame_id_(0)
+      , timestamp_(0)
+      , file_start_us_(0)
+      , restarts_(0) { }
+
+bool CaptureOpenCV::fits(const cv::Rect_<unsigned long>& rect) const {
+    if (rect.width == 0 || rect.height == 0)
+        return false;
+
+    if (frame_size_.area() == 0)
+        return true;
+
+    return rect.x + rect.width <= static_cast<unsigned long>(frame_size_.width)
+        && rect.y + rect.height <= static_cast<unsigned long>(frame_size_.height);
+}
+
+bool CaptureOpenCV::read(cv::Mat& target) {
+    cv::Mat raw;
+
+    if (!video_.read(raw) || raw.empty()) {
+        if (device_ >= 0)
+            return false;
+
+        // the file ran out, it continues one frame period after its last frame
+        auto fps = video_.get(cv::CAP_PROP_FPS);
+        file_start_us_ = timestamp_ + (fps > 0.0 ? static_cast<unsigned long long>(1e6 / fps) : 0);
+        video_.set(cv::CAP_PROP_POS_FRAMES, 0);
+        ++restarts_;
+
+        if (!video_.read(raw) || raw.empty())
+            return false;
+    }
+
+    if (device_ < 0)
+        timestamp_ = file_start_us_ + static_cast<unsigned long long>(video_.get(cv::CAP_PROP_POS_MSEC) * 1000.0);
+    else
+        timestamp_ = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - open_time_).count();
+
+    cv::Mat gray;
+    if (raw.channels() == 3)
+        cv::cvtColor(raw, gray, cv::COLOR_BGR2GRAY);
+    else if (raw.channels() == 4)
+        cv::cvtColor(raw, gray, cv::COLOR_BGRA2GRAY);
+    else
+        gray = raw;
+
+    // 16 bit frames keep their upper 8 bits
+    if (gray.depth() == CV_16U)
+        gray.convertTo(gray, CV_8U, 1.0 / 256.0);
+    else if (gray.depth() != CV_8U)
+        gray.convertTo(gray, CV_8U);
+
+    frame_size_ = gray.size();
+
+    if (!fits(region_))
+        return false;
+
+    cv::Rect crop(static_cast<int>(region_.x), static_cast<int>(region_.y), static_cast<int>(region_.width), static_cast<int>(region_.height));
+    target = gray(crop).clone();
+    ++frame_id_;
+
+    return true;
+}
+
+std::string CaptureOpenCV::name() const {
+    return "opencv";
+}
+
+bool CaptureOpenCV::initialize() {
+    return true;
+}
+
+void CaptureOpenCV::uninitialize() { }
+
+bool CaptureOpenCV::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto ok = device_ >= 0 ? video_.open(device_) : video_.open(filename_);
+    if (!ok || !video_.isOpened())
+        return false;
+
+    frame_size_ = cv::Size(static_cast<int>(video_.get(cv::CAP_PROP_FRAME_WIDTH)), static_cast<int>(video_.get(cv::CAP_PROP_FRAME_HEIGHT)));
+
+    // the camera regions rarely fit other devices, they start with the whole frame
+    if (!fits(region_))
+        region_ = cv::Rect_<unsigned long>(0, 0, frame_size_.width, frame_size_.height);
+
+    frame_id_ = 0;
+    timestamp_ = 0;
+    file_start_us_ = 0;
+    restarts_ = 0;
+    open_time_ = std::chrono::steady_clock::now();
+
+    return true;
+}
+
+void CaptureOpenCV::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    video_.release();
+}
+
+bool CaptureOpenCV::is_open() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return video_.isOpened();
+}
+
+void CaptureOpenCV::prepare() { }
+
+bool CaptureOpenCV::frame_init() {
+    return true;
+}
+
+int CaptureOpenCV::cap_init() const {
+    return 0;
+}
+
+bool CaptureOpenCV::cap_end() const {
+    return true;
+}
+
+bool CaptureOpenCV::aquisition_init() const {
+    return true;
+}
+
+bool CaptureOpenCV::aquisition_end() const {
+    return true;
+}
+
+bool CaptureOpenCV::region(cv::Rect_<unsigned long> new_region) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!fits(new_region))
+        return false;
+
+    region_ = new_region;
+    return true;
+}
+
+cv::Rect_<unsigned long> CaptureOpenCV::region() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return region_;
+}
+
+bool CaptureOpenCV::exposure(unsigned long new_value) {
+    if (new_value == 0)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    exposure_ = new_value;
+
+    // the unit is up to the driver, the PvAPI driver takes microseconds
+    if (device_ >= 0 && video_.isOpened())
+        video_.set(cv::CAP_PROP_EXPOSURE, static_cast<double>(new_value));
+
+    return true;
+}
+
+unsigned long CaptureOpenCV::exposure() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return exposure_;
+}
+
+void CaptureOpenCV::gain(unsigned long new_value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gain_ = new_value;
+
+    if (device_ >= 0 && video_.isOpened())
+        video_.set(cv::CAP_PROP_GAIN, static_cast<double>(new_value));
+}
+
+unsigned long CaptureOpenCV::gain() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return gain_;
+}
+
+void CaptureOpenCV::cap(int frame_count, std::vector<cv::Mat>& target_vector) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    target_vector.reserve(target_vector.size() + frame_count);
+
+    cv::Mat frame;
+    for (auto i = frame_count; i-- && read(frame);)
+        target_vector.emplace_back(frame);
+}
+
+void CaptureOpenCV::cap_single(cv::Mat& target) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    read(target);
+}
+
+bool CaptureOpenCV::cap_single(cv::Mat& target, const cv::Rect_<unsigned long>& roi, unsigned long /*timeout*/, unsigned long& frame_id, unsigned long long& timestamp) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (roi != region_ || !read(target))
+        return false;
+
+    frame_id = frame_id_;
+    timestamp = timestamp_;
+    return true;
+}
+
+size_t CaptureOpenCV::stale_frames() const {
+    return 0;
+}
+
+std::string CaptureOpenCV::report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (device_ >= 0)
+        return cv::format("read %i frames from device %i\n", static_cast<int>(frame_id_), device_);
+
+    return cv::format("read %i frames from %s, started over %i times\n", static_cast<int>(frame_id_), filename_.c_str(), static_cast<int>(restarts_));
+}
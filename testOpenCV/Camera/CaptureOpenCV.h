@@ -0,0 +1,128 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include "CaptureInterface.h"
+
+/**
+ * \brief Capture device reading frames through cv::VideoCapture, from a video device or from a video file or image sequence.
+ * Frames are converted to 8 bit mono and cut to the region in software, as the drivers behind VideoCapture do not share a way to set one.
+ * Exposure and gain are passed on to video devices, which may ignore them, files keep the exposure they were taken with.
+ * A file starts over at its end, so a measurement can take more frames than the file holds.
+ */
+class CaptureOpenCV : public CaptureInterface {
+
+    // video device index, negative when reading from the file
+    int device_;
+
+    // video file or image sequence pattern, like "frames/%04d.png"
+    std::string filename_;
+
+    cv::VideoCapture video_;
+
+    // guards the settings and the video
+    mutable std::mutex mutex_;
+
+    // the size of the frames as they are read, empty until open
+    cv::Size frame_size_;
+
+    cv::Rect_<unsigned long> region_;
+
+    unsigned long exposure_;
+
+    unsigned long gain_;
+
+    unsigned long frame_id_;
+
+    unsigned long long timestamp_;
+
+    // camera time at the last start of the file in microseconds
+    unsigned long long file_start_us_;
+
+    size_t restarts_;
+
+    std::chrono::steady_clock::time_point open_time_;
+
+    bool fits(const cv::Rect_<unsigned long>& rect) const;
+
+    /**
+     * \brief Reads the next frame cut to the region, requires the lock
+     * \return false if the video has no more frames
+     */
+    bool read(cv::Mat& target);
+
+public:
+
+    /**
+     * \brief Reads from a video device, CV_CAP_PVAPI selects the first PvAPI camera through OpenCV
+     */
+    explicit CaptureOpenCV(int device);
+
+    /**
+     * \brief Reads from a video file or image sequence
+     */
+    explicit CaptureOpenCV(const std::string& filename);
+
+    std::string name() const override;
+
+    bool initialize() override;
+
+    void uninitialize() override;
+
+    bool open() override;
+
+    void close() override;
+
+    bool is_open() const override;
+
+    void prepare() override;
+
+    bool frame_init() override;
+
+    int cap_init() const override;
+
+    bool cap_end() const override;
+
+    bool aquisition_init() const override;
+
+    bool aquisition_end() const override;
+
+    /**
+     * \brief Sets the region frames are cut to
+     * \return false if it is empty or does not fit the frames of an open video
+     */
+    bool region(cv::Rect_<unsigned long> new_region) override;
+
+    cv::Rect_<unsigned long> region() const override;
+
+    bool exposure(unsigned long new_value) override;
+
+    unsigned long exposure() const override;
+
+    void gain(unsigned long new_value) override;
+
+    unsigned long gain() const override;
+
+    void cap(int frame_count, std::vector<cv::Mat>& target_vector) override;
+
+    void cap_single(cv::Mat& target) override;
+
+    /**
+     * \brief Captures a single frame
+     * \param target The target
+     * \param roi The region the caller expects
+     * \param timeout Not used, VideoCapture blocks until the driver has a frame
+     * \param frame_id The number of frames read since open
+     * \param timestamp The position in the file, or the time since open for a device, in microseconds
+     * \return false if the region does not match the current one or no frame could be read
+     */
+    bool cap_single(cv::Mat& target, const cv::Rect_<unsigned long>& roi, unsigned long timeout, unsigned long& frame_id, unsigned long long& timestamp) override;
+
+    size_t stale_frames() const override;
+
+    std::string report() const override;
+
+};
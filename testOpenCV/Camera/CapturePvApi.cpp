@@ -1,10 +1,18 @@
 #include <thread>
 #include <chrono>
+#include <algorithm>
 #include "../namespaces/tg.h"
 #include "CapturePvApi.h"
 
 using namespace tg;
 
+namespace {
+
+    // frames that can be exposing or in transfer inside the camera when a setting changes
+    const unsigned long frames_in_flight = 2;
+
+}
+
 char const* CapturePvApi::error_last(tPvErr error) {
 
     std::string return_string;
@@ -230,10 +238,15 @@ bool CapturePvApi::frame_init() {
         return false;
     }
 
-    // Allocate a buffer to store the image
-    memset(&camera_.Frame, 0, sizeof(tPvFrame));
-    camera_.Frame.ImageBufferSize = frame_size_;
-    camera_.Frame.ImageBuffer = new char[frame_size_];
+    // Allocate the buffers to store the images, they are queued with the first capture
+    ring_ = std::make_unique<FrameRing>(ring_size_, frame_size_);
+
+    // the camera clock is used to discard frames exposed before a setting change
+    err_code = PvAttrUint32Get(camera_.Handle, "TimeStampFrequency", &timestamp_frequency_);
+    if (err_code != ePvErrSuccess) {
+        log_err << cv::format("Camera clock not available, stale frames are skipped by frame count. %s\n", error_last(err_code));
+        timestamp_frequency_ = 0;
+    }
 
     return true;
 
@@ -262,6 +275,10 @@ int CapturePvApi::cap_init() const {
 }
 
 bool CapturePvApi::cap_end() const {
+    // the queued frames have to be back before the capture ends
+    if (ring_)
+        ring_->stop();
+
     auto err_code = PvCaptureEnd(camera_.Handle);
     if (err_code != ePvErrSuccess) {
         log_err << cv::format("Error. Failed to end capture. %s\n", error_last(err_code));
@@ -412,6 +429,9 @@ void CapturePvApi::reset_binning() const {
     if (err_code != ePvErrSuccess) {
         log_err << cv::format("Error setting BinningY.. %s\n", error_last(err_code));
     }
+
+    // the camera adjusts the region to the binning
+    attributes_.invalidate();
 }
 
 bool CapturePvApi::is_open() const {
@@ -454,6 +474,18 @@ unsigned long CapturePvApi::frame_size() const {
     return frame_size_;
 }
 
+size_t CapturePvApi::stale_frames() const {
+    return ring_ ? ring_->stale() : 0;
+}
+
+size_t CapturePvApi::ring_size() const {
+    return ring_size_;
+}
+
+void CapturePvApi::ring_size(size_t new_value) {
+    ring_size_ = std::max(new_value, static_cast<size_t>(1));
+}
+
 std::string CapturePvApi::version() const {
     unsigned long major = 0;
     unsigned long minor = 0;
@@ -461,28 +493,23 @@ std::string CapturePvApi::version() const {
     return cv::format("%i.%i", major, minor);
 }
 
-bool CapturePvApi::region(cv::Rect_<unsigned long> new_region) const {
-
-    auto failures = 0;
+bool CapturePvApi::region(cv::Rect_<unsigned long> new_region) {
 
-    if (!region_x(new_region.x))
-        failures++;
+    // only the changed attributes are written, in an order that keeps the region on the sensor
+    size_t written = 0;
+    auto err_code = attributes_.region(new_region.x, new_region.y, new_region.width, new_region.height, written);
 
-    if (!region_y(new_region.y))
-        failures++;
-
-    if (!region_width(new_region.width))
-        failures++;
-
-    if (!region_height(new_region.height))
-        failures++;
+    if (err_code != ePvErrSuccess) {
+        log_err << cv::format("Error setting roi, the previous roi is kept.. %s\n", error_last(err_code));
+        return false;
+    }
 
-    if (failures == 0) {
+    if (written > 0) {
+        committed(known_exposure());
         log_time << "Capture roi changed to " << new_region << std::endl;
-        return true;
     }
 
-    return false;
+    return true;
 }
 
 cv::Rect_<unsigned long> CapturePvApi::region() const {
@@ -494,7 +521,7 @@ cv::Rect_<unsigned long> CapturePvApi::region() const {
 }
 
 bool CapturePvApi::region_x(unsigned new_x) const {
-    auto err_code = PvAttrUint32Set(camera_.Handle, "RegionX", new_x);
+    auto err_code = set_attribute("RegionX", new_x, known_exposure());
     if (err_code == ePvErrSuccess)
         return true;
     log_err << cv::format("Error setting roi x.. %s\n", error_last(err_code));
@@ -503,7 +530,7 @@ bool CapturePvApi::region_x(unsigned new_x) const {
 
 unsigned long CapturePvApi::region_x() const {
     unsigned long x = 0;
-    auto err_code = PvAttrUint32Get(camera_.Handle, "RegionX", &x);
+    auto err_code = attributes_.get("RegionX", x);
     if (err_code != ePvErrSuccess) {
         log_err << cv::format("Error getting roi x.. %s\n", error_last(err_code));
     }
@@ -511,7 +538,7 @@ unsigned long CapturePvApi::region_x() const {
 }
 
 bool CapturePvApi::region_y(unsigned new_y) const {
-    auto err_code = PvAttrUint32Set(camera_.Handle, "RegionY", new_y);
+    auto err_code = set_attribute("RegionY", new_y, known_exposure());
     if (err_code == ePvErrSuccess)
         return true;
     log_err << cv::format("Error setting roi y.. %s\n", error_last(err_code));
@@ -520,7 +547,7 @@ bool CapturePvApi::region_y(unsigned new_y) const {
 
 unsigned long CapturePvApi::region_y() const {
     unsigned long y = 0;
-    auto err_code = PvAttrUint32Get(camera_.Handle, "RegionY", &y);
+    auto err_code = attributes_.get("RegionY", y);
     if (err_code != ePvErrSuccess) {
         log_err << cv::format("Error getting roi y.. %s\n", error_last(err_code));
     }
@@ -528,7 +555,7 @@ unsigned long CapturePvApi::region_y() const {
 }
 
 bool CapturePvApi::region_height(unsigned new_height) const {
-    auto err_code = PvAttrUint32Set(camera_.Handle, "Height", new_height);
+    auto err_code = set_attribute("Height", new_height, known_exposure());
     if (err_code == ePvErrSuccess)
         return true;
     log_time << cv::format("Error setting roi height.. %s\n", error_last(err_code));
@@ -537,7 +564,7 @@ bool CapturePvApi::region_height(unsigned new_height) const {
 
 unsigned long CapturePvApi::region_height() const {
     unsigned long height = 0;
-    auto err_code = PvAttrUint32Get(camera_.Handle, "Height", &height);
+    auto err_code = attributes_.get("Height", height);
     if (err_code != ePvErrSuccess) {
         log_err << cv::format("Error getting roi height.. %s\n", error_last(err_code));
     }
@@ -545,7 +572,7 @@ unsigned long CapturePvApi::region_height() const {
 }
 
 bool CapturePvApi::region_width(unsigned new_width) const {
-    auto err_code = PvAttrUint32Set(camera_.Handle, "Width", new_width);
+    auto err_code = set_attribute("Width", new_width, known_exposure());
     if (err_code == ePvErrSuccess)
         return true;
     log_err << cv::format("Error setting roi width.. %s\n", error_last(err_code));
@@ -554,7 +581,7 @@ bool CapturePvApi::region_width(unsigned new_width) const {
 
 unsigned long CapturePvApi::region_width() const {
     unsigned long width = 0;
-    auto err_code = PvAttrUint32Get(camera_.Handle, "Width", &width);
+    auto err_code = attributes_.get("Width", width);
     if (err_code != ePvErrSuccess) {
         log_err << cv::format("Error getting roi width.. %s\n", error_last(err_code));
     }
@@ -565,38 +592,36 @@ void CapturePvApi::cap(int frame_count, std::vector<cv::Mat>& target_vector) {
 
     // retrieve the roi to use
     auto roi = region();
+    const auto rows = static_cast<int>(roi.height);
+    const auto cols = static_cast<int>(roi.width);
 
-    auto m = cv::Mat(roi.height, roi.width, CV_8UC1);
-
-    cv::Mat undistorted;
+    // buffers released since the last capture are reused, the pool only grows while frames are still held
+    pool_->reserve(rows, cols, CV_8UC1, frame_count);
+    target_vector.reserve(target_vector.size() + frame_count);
 
     for (auto i = frame_count; i--;) {
-        if (!PvCaptureQueueFrame(camera_.Handle, &(camera_.Frame), nullptr)) {
-
-            while (true) {
-                auto err_code = PvCaptureWaitForFrameDone(camera_.Handle, &(camera_.Frame), 100);
-                if (err_code == ePvErrTimeout)
-                    continue;
-                if (err_code == ePvErrSuccess)
-                    break;
-                log_err << cv::format("Error while waiting for frame. %s\n", error_last(err_code));
-            }
+        auto done = next_frame(roi);
+        if (!done)
+            return;
 
-            // Create an image header (mono image)
-            // Push ImageBuffer data into the image matrix and clone it into target vector
+        // Create an image header (mono image) for the ImageBuffer and copy it into a pooled frame
+        cv::Mat grabbed(rows, cols, CV_8UC1, done->ImageBuffer);
 
-            m.data = static_cast<uchar *>(camera_.Frame.ImageBuffer);
+        auto frame = pool_->get(rows, cols, CV_8UC1);
 
-            // if the calibration data has been loaded, the undistorted image is then used
-            //if (cal->loaded) {
-            //    cv::undistort(m, undistorted, cal->intrinsic, cal->dist_coeffs);
-            //    target_vector.emplace_back(undistorted);
-            //} else {
-                target_vector.emplace_back(m.clone());
-            //}
+        // if the calibration data has been loaded, the undistorted image is then used
+        //if (cal->loaded) {
+        //    cv::undistort(grabbed, frame, cal->intrinsic, cal->dist_coeffs);
+        //} else {
+            grabbed.copyTo(frame);
+        //}
 
-            //cv::imwrite("ostefars.png", target_vector.back());
-        }
+        // the buffer goes straight back to the camera
+        ring_->release(done);
+
+        target_vector.emplace_back(frame);
+
+        //cv::imwrite("ostefars.png", target_vector.back());
     }
 }
 
@@ -604,37 +629,161 @@ void CapturePvApi::cap_single(cv::Mat& target) {
 
     // retrieve the roi to use
     auto roi = region();
+    const auto rows = static_cast<int>(roi.height);
+    const auto cols = static_cast<int>(roi.width);
 
-    target = cv::Mat(roi.height, roi.width, CV_8UC1);
-    auto grabbed = cv::Mat(roi.height, roi.width, CV_8UC1);
+    auto done = next_frame(roi);
+    if (!done)
+        return;
 
-    if (!PvCaptureQueueFrame(camera_.Handle, &(camera_.Frame), nullptr)) {
+    // Create an image header (mono image) for the ImageBuffer and copy it into a pooled frame
+    cv::Mat grabbed(rows, cols, CV_8UC1, done->ImageBuffer);
 
-        while (true) {
-            auto err_code = PvCaptureWaitForFrameDone(camera_.Handle, &(camera_.Frame), 100);
-            if (err_code == ePvErrTimeout)
-                continue;
-            if (err_code == ePvErrSuccess)
-                break;
-            log_err << cv::format("Error while waiting for frame. %s\n", error_last(err_code));
-        }
+    target = pool_->get(rows, cols, CV_8UC1);
 
-        // Create an image header (mono image)
-        // Push ImageBuffer data into the image matrix and clone it into target vector
+    // if the calibration data has been loaded, the undistorted image is then used
+    if (cal->loaded)
+        cv::undistort(grabbed, target, cal->intrinsic, cal->dist_coeffs);
+    else
+        grabbed.copyTo(target);
 
-        grabbed.data = static_cast<uchar *>(camera_.Frame.ImageBuffer);
+    ring_->release(done);
 
-        // if the calibration data has been loaded, the undistorted image is then used
-        if (cal->loaded) {
-            cv::Mat undistorted;
-            cv::undistort(grabbed, undistorted, cal->intrinsic, cal->dist_coeffs);
-            target = undistorted.clone();
-        } else
-            target = grabbed.clone();
+    //cv::imwrite("ostefars.png", target_vector.back());
 
-        //cv::imwrite("ostefars.png", target_vector.back());
+}
+
+bool CapturePvApi::cap_single(cv::Mat& target, const cv::Rect_<unsigned long>& roi, unsigned long timeout, unsigned long& frame_id, unsigned long long& timestamp) {
+
+    const auto rows = static_cast<int>(roi.height);
+    const auto cols = static_cast<int>(roi.width);
+
+    auto done = next_frame(roi, timeout);
+    if (!done)
+        return false;
+
+    frame_id = done->FrameCount;
+
+    if (timestamp_frequency_ > 0) {
+        // in two steps, the ticks times a million overflow after a few days
+        auto ticks = FrameRing::timestamp(done);
+        timestamp = ticks / timestamp_frequency_ * 1000000 + ticks % timestamp_frequency_ * 1000000 / timestamp_frequency_;
+    } else {
+        timestamp = 0;
     }
 
+    cv::Mat grabbed(rows, cols, CV_8UC1, done->ImageBuffer);
+
+    pool_->reserve(rows, cols, CV_8UC1, 1);
+    target = pool_->get(rows, cols, CV_8UC1);
+
+    if (cal->loaded)
+        cv::undistort(grabbed, target, cal->intrinsic, cal->dist_coeffs);
+    else
+        grabbed.copyTo(target);
+
+    ring_->release(done);
+
+    return true;
+}
+
+tPvFrame* CapturePvApi::next_frame(const cv::Rect_<unsigned long>& roi, unsigned long timeout) {
+
+    if (!ring_) {
+        log_err << "Error. Frames are not initialized.\n";
+        return nullptr;
+    }
+
+    if (!ring_->running() && !ring_->start(camera_.Handle)) {
+        log_err << "Error. Unable to queue the frame buffers.\n";
+        ring_->stop();
+        return nullptr;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+    while (true) {
+        auto done = ring_->acquire(timeout > 0 ? std::min(timeout, 100ul) : 100);
+
+        if (!done) {
+            if (!ring_->running()) {
+                log_err << "Error while waiting for frame, capture is stopped.\n";
+                return nullptr;
+            }
+            if (timeout > 0 && std::chrono::steady_clock::now() >= deadline)
+                return nullptr;
+            continue;
+        }
+
+        // frames queued before a region change still have the previous size
+        if (done->Width == roi.width && done->Height == roi.height)
+            return done;
+
+        ring_->release(done);
+    }
+
+}
+
+void CapturePvApi::committed(unsigned long settle) const {
+
+    // nothing can be in flight before the buffers are queued
+    if (!ring_ || !ring_->running())
+        return;
+
+    auto frame = ring_->last_frame();
+    uint64_t timestamp = 0;
+
+    unsigned long high = 0;
+    unsigned long low = 0;
+
+    if (timestamp_frequency_ > 0
+        && PvCommandRun(camera_.Handle, "TimeStampValueLatch") == ePvErrSuccess
+        && PvAttrUint32Get(camera_.Handle, "TimeStampValueHi", &high) == ePvErrSuccess
+        && PvAttrUint32Get(camera_.Handle, "TimeStampValueLo", &low) == ePvErrSuccess) {
+        timestamp = (static_cast<uint64_t>(high) << 32 | low) + static_cast<uint64_t>(settle) * timestamp_frequency_ / 1000000;
+    } else
+        frame += frames_in_flight;
+
+    auto discarded = ring_->fence(frame, timestamp);
+
+    log_time << cv::format("Setting committed after frame %i, %i completed frames discarded.\n", ring_->last_frame(), discarded);
+
+}
+
+unsigned long CapturePvApi::known_exposure() const {
+    unsigned long value = 0;
+    attributes_.get("ExposureValue", value);
+    return value;
+}
+
+tPvErr CapturePvApi::set_attribute(const char* name, unsigned long value, unsigned long settle) const {
+    size_t written = 0;
+    attributes_.stage(name, value);
+    auto err_code = attributes_.commit({name}, written);
+    if (written > 0)
+        committed(settle);
+    return err_code;
+}
+
+const AttributeCache& CapturePvApi::attributes() const {
+    return attributes_;
+}
+
+std::string CapturePvApi::report() const {
+    return attributes_.report();
+}
+
+std::string CapturePvApi::name() const {
+    return "pvapi";
+}
+
+void CapturePvApi::prepare() {
+    reset_binning();
+    packet_size(9014);
+}
+
+const FramePool& CapturePvApi::frame_pool() const {
+    return *pool_;
 }
 
 bool CapturePvApi::initialize() {
@@ -708,6 +857,7 @@ bool CapturePvApi::open() {
 
     auto err_code = PvCameraOpen(camera_.UID, ePvAccessMaster, &(camera_.Handle));
     is_open_ = err_code == ePvErrSuccess;
+    attributes_.handle(camera_.Handle);
 
     if (!is_open_) { // something went to shiets...
         log_err << cv::format("Error. camera not open.. %s\n", error_last(err_code));
@@ -736,8 +886,8 @@ void CapturePvApi::packet_size(const unsigned long new_value) const {
     }
 }
 
-void CapturePvApi::gain(unsigned long new_value) const {
-    auto err_code = PvAttrUint32Set(camera_.Handle, "GainValue", new_value);
+void CapturePvApi::gain(unsigned long new_value) {
+    auto err_code = set_attribute("GainValue", new_value, known_exposure());
     if (err_code != ePvErrSuccess) {
         log_err << "Gain changed failed.\n";
         return;
@@ -747,7 +897,7 @@ void CapturePvApi::gain(unsigned long new_value) const {
 
 unsigned long CapturePvApi::gain() const {
     unsigned long val = 0;
-    auto err_code = PvAttrUint32Get(camera_.Handle, "GainValue", &val);
+    auto err_code = attributes_.get("GainValue", val);
     if (err_code != ePvErrSuccess) {
         log_err << cv::format("Error. gain(). %s\n", error_last(err_code));
         return 0;
@@ -756,8 +906,9 @@ unsigned long CapturePvApi::gain() const {
     return val;
 }
 
-bool CapturePvApi::exposure(unsigned long new_value) const {
-    auto err_code = PvAttrUint32Set(camera_.Handle, "ExposureValue", new_value);
+bool CapturePvApi::exposure(unsigned long new_value) {
+    // frames have to cover the longer of the two exposures after the change
+    auto err_code = set_attribute("ExposureValue", new_value, std::max(known_exposure(), new_value));
     if (err_code != ePvErrSuccess) {
         log_err << "Exposure changed failed.\n";
         return false;
@@ -768,7 +919,7 @@ bool CapturePvApi::exposure(unsigned long new_value) const {
 
 unsigned long CapturePvApi::exposure() const {
     unsigned long val = 0;
-    auto err_code = PvAttrUint32Get(camera_.Handle, "ExposureValue", &val);
+    auto err_code = attributes_.get("ExposureValue", val);
     if (err_code != ePvErrSuccess) {
         log_err << cv::format("Error. exposure(). %s\n", error_last(err_code));
         return 0;
@@ -777,22 +928,6 @@ unsigned long CapturePvApi::exposure() const {
     return val;
 }
 
-void CapturePvApi::exposure_add(unsigned long value) const {
-    exposure(exposure() + value);
-}
-
-void CapturePvApi::exposure_sub(unsigned long value) const {
-    exposure(exposure() - value);
-}
-
-void CapturePvApi::exposure_div(unsigned long value) const {
-    exposure(exposure() / value);
-}
-
-void CapturePvApi::exposure_mul(unsigned long value) const {
-    exposure(exposure() * value);
-}
-
 void CapturePvApi::print_attr() const {
     unsigned long count = 0;
     tPvAttrListPtr pListPtr;
@@ -1,13 +1,16 @@
 #pragma once
 
 #include "CaptureInterface.h"
+#include "AttributeCache.h"
+#include "FramePool.h"
+#include "FrameRing.h"
 #include <PvApi.h>
 #include "../namespaces/validate.h"
 
 /**
  * \brief Allows capture through PvAPI -> OpenCV data structure
  */
-class CapturePvApi {
+class CapturePvApi : public CaptureInterface {
 
 public:
 
@@ -36,12 +39,34 @@ private:
 
     std::unique_ptr<calibrations> cal = std::make_unique<calibrations>();
 
+    /**
+     * \brief The buffers of the captured frames, recycled when the frames are released
+     */
+    std::shared_ptr<FramePool> pool_ = FramePool::create();
+
+    /**
+     * \brief The frame buffers kept queued in the driver, created by frame_init()
+     */
+    std::unique_ptr<FrameRing> ring_;
+
+    size_t ring_size_ = 4;
+
+    /**
+     * \brief Ticks per second of the camera clock, 0 if the camera does not report it
+     */
+    unsigned long timestamp_frequency_ = 0;
+
     const int mono = 1;
 
     const unsigned long def_packet_size = 8228;
 
     tg::tCamera camera_;
 
+    /**
+     * \brief The region, exposure and gain as last written to or read from the camera
+     */
+    mutable AttributeCache attributes_;
+
     tPvCameraInfo camera_info_;
 
     unsigned long frame_size_;
@@ -60,11 +85,38 @@ private:
 
     void query_attribute(const char* aLabel) const;
 
-public:
+    /**
+     * \brief Waits for the next frame of the given region from the ring, starting the ring if needed
+     * \param roi The region the camera is set to
+     * \param timeout The maximum wait in milliseconds, 0 waits as long as the capture runs
+     * \return The frame, release it to the ring after use. nullptr on timeout or if the capture is not running
+     */
+    tPvFrame* next_frame(const cv::Rect_<unsigned long>& roi, unsigned long timeout = 0);
 
-    const cv::Rect_<unsigned long> default_roi_full = cv::Rect_<unsigned long>(0, 0, 2448, 2040);
+    /**
+     * \brief Records that a camera setting was committed, so frames exposed before it are never captured.
+     * The camera clock is latched, and frames stamped earlier than the latch plus the settle time are discarded by the ring,
+     * as are frames that had completed already. A frame stamped that late started its exposure after the change,
+     * whether the camera stamps the start or the end of the exposure.
+     * Without the camera clock the frames that may be in the camera are skipped by frame count instead.
+     * \param settle The longest exposure around the change in microseconds
+     */
+    void committed(unsigned long settle) const;
 
-    const cv::Rect_<unsigned long> default_roi = cv::Rect_<unsigned long>(0, 1006, 2448, 256);
+    /**
+     * \brief The current exposure, read from the camera if not cached
+     */
+    unsigned long known_exposure() const;
+
+    /**
+     * \brief Writes a cached attribute if it changed, and commits the change for the captured frames
+     * \param name The attribute
+     * \param value The new value
+     * \param settle The longest exposure around the change in microseconds
+     */
+    tPvErr set_attribute(const char* name, unsigned long value, unsigned long settle) const;
+
+public:
 
     CapturePvApi()
         : frame_size_(0)
@@ -75,6 +127,7 @@ public:
 
     CapturePvApi(tg::tCamera myCamera, tPvCameraInfo cameraInfo, unsigned long frameSize)
         : camera_(myCamera)
+          , attributes_(myCamera.Handle)
           , camera_info_(cameraInfo)
           , frame_size_(frameSize)
           , retry_count_(10)
@@ -82,21 +135,24 @@ public:
           , is_open_(false)
           , exposure_target_reached_(false) { }
 
-    ~CapturePvApi() {
-        delete[] static_cast<char*>(camera_.Frame.ImageBuffer);
-    }
-
     bool load_calibration_data(std::string& filename) const;
 
-    bool frame_init();
+    std::string name() const override;
+
+    /**
+     * \brief Resets the binning and uses jumbo packets
+     */
+    void prepare() override;
 
-    int cap_init() const;
+    bool frame_init() override;
 
-    bool cap_end() const;
+    int cap_init() const override;
 
-    bool aquisition_init() const;
+    bool cap_end() const override;
 
-    bool aquisition_end() const;
+    bool aquisition_init() const override;
+
+    bool aquisition_end() const override;
 
     bool exposure_auto_reset() const;
 
@@ -128,7 +184,7 @@ public:
      */
     void reset_binning() const;
 
-    bool is_open() const;
+    bool is_open() const override;
 
     void is_open(bool new_value);
 
@@ -142,6 +198,28 @@ public:
 
     unsigned long frame_size() const;
 
+    size_t ring_size() const;
+
+    /**
+     * \brief Sets the number of frame buffers kept queued, takes effect at the next frame_init()
+     */
+    void ring_size(size_t new_value);
+
+    /**
+     * \brief The number of frames discarded because they were exposed before a setting change
+     */
+    size_t stale_frames() const override;
+
+    /**
+     * \brief The attribute cache, for its call counts
+     */
+    const AttributeCache& attributes() const;
+
+    /**
+     * \brief The calls made for each camera attribute
+     */
+    std::string report() const override;
+
     std::string version() const;
 
     template <typename T>
@@ -163,13 +241,13 @@ public:
      * \param new_region The region as opencv rect of unsigned long
      * \return true if all 4 regions were set without errors
      */
-    bool region(cv::Rect_<unsigned long> new_region) const;
+    bool region(cv::Rect_<unsigned long> new_region) override;
 
     /**
      * \brief Retrieves the camera ROI
      * \return The roi as opencv rect type unsigned long
      */
-    cv::Rect_<unsigned long> region() const;
+    cv::Rect_<unsigned long> region() const override;
 
     bool region_x(unsigned new_x) const;
 
@@ -188,40 +266,47 @@ public:
     unsigned long region_width() const;
 
     /**
-     * \brief Captures frames synchron into a vector of opencv matricies using specified exposure
+     * \brief Captures frames synchron into a vector of opencv matricies using specified exposure.
+     * The frames are backed by pooled buffers, which are reused once all references to a frame are released.
      * \param frame_count Amount of frames to capture
      * \param target_vector The target vector for the captured images
      */
-    void cap(int frame_count, std::vector<cv::Mat>& target_vector);
-
-    void cap_single(cv::Mat& target);
+    void cap(int frame_count, std::vector<cv::Mat>& target_vector) override;
 
-    bool initialize();
+    void cap_single(cv::Mat& target) override;
 
-    void uninitialize();
+    /**
+     * \brief Captures a single frame without querying the camera for its region, for capture loops on their own thread
+     * \param target The target, backed by a pooled buffer
+     * \param roi The region the camera is set to
+     * \param timeout The maximum wait in milliseconds
+     * \param frame_id The frame counter of the camera for the captured frame
+     * \param timestamp The camera time of the captured frame in microseconds, 0 if the camera does not report it
+     * \return true if a frame was captured within the timeout
+     */
+    bool cap_single(cv::Mat& target, const cv::Rect_<unsigned long>& roi, unsigned long timeout, unsigned long& frame_id, unsigned long long& timestamp) override;
 
-    static unsigned long camera_count();
+    const FramePool& frame_pool() const;
 
-    bool open();
+    bool initialize() override;
 
-    void close();
+    void uninitialize() override;
 
-    void packet_size(const unsigned long new_value) const;
+    static unsigned long camera_count();
 
-    void gain(unsigned long new_value) const;
+    bool open() override;
 
-    unsigned long gain() const;
+    void close() override;
 
-    bool exposure(unsigned long new_value) const;
+    void packet_size(const unsigned long new_value) const;
 
-    unsigned long exposure() const;
+    void gain(unsigned long new_value) override;
 
-    void exposure_add(unsigned long value_to_add) const;
+    unsigned long gain() const override;
 
-    void exposure_sub(unsigned long value_to_sub) const;
-    void exposure_div(unsigned long value) const;
+    bool exposure(unsigned long new_value) override;
 
-    void exposure_mul(unsigned long value_to_mul) const;
+    unsigned long exposure() const override;
 
     void pixel_format(const PixelFormat format) const;
 
@@ -0,0 +1,271 @@
+#include "CaptureReplay.h"
+#include <chrono>
+#include <limits>
+#include <thread>
+
+namespace {
+
+    bool contains(const cv::Rect_<unsigned long>& outer, const cv::Rect_<unsigned long>& inner) {
+        return inner.x >= outer.x && inner.y >= outer.y
+            && inner.x + inner.width <= outer.x + outer.width
+            && inner.y + inner.height <= outer.y + outer.height;
+    }
+
+    unsigned long distance(unsigned long a, unsigned long b) {
+        return a > b ? a - b : b - a;
+    }
+
+}
+
+CaptureReplay::CaptureReplay()
+    : cursor_(0)
+      , seek_(true)
+      , region_(default_roi)
+      , exposure_(5000)
+      , gain_(0)
+      , timestamp_(0)
+      , served_(0)
+      , mismatched_(0)
+      , is_open_(false) { }
+
+bool CaptureReplay::load(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!recording_.open(filename))
+        return false;
+
+    cursor_ = 0;
+    seek_ = true;
+    timestamp_ = 0;
+    served_ = 0;
+    mismatched_ = 0;
+
+    if (recording_.size() > 0) {
+        auto& first = recording_.meta(0);
+        region_ = first.roi;
+        exposure_ = first.exposure;
+        gain_ = first.gain;
+    }
+
+    return true;
+}
+
+void CaptureReplay::rewind() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cursor_ = 0;
+    seek_ = true;
+}
+
+const FrameRecording& CaptureReplay::recording() const {
+    return recording_;
+}
+
+size_t CaptureReplay::find(bool& exact) const {
+    const auto count = recording_.size();
+
+    auto matches = [this](const RecordedFrame& meta) {
+        return meta.roi == region_ && meta.exposure == exposure_ && meta.gain == gain_;
+    };
+
+    exact = true;
+    if (seek_) {
+        for (auto i = cursor_; i < count; i++) {
+            if (matches(recording_.meta(i)))
+                return i;
+        }
+    } else if (cursor_ < count && matches(recording_.meta(cursor_)))
+        return cursor_;
+
+    // the recorded run took no more frames with these settings here, like a camera timing out
+    for (size_t i = 0; i < count; i++) {
+        if (matches(recording_.meta(i)))
+            return count;
+    }
+
+    // settings the recorded run never used, the closest exposure is cut to the region
+    exact = false;
+
+    auto best = count;
+    auto best_distance = std::numeric_limits<unsigned long>::max();
+
+    for (size_t n = 0; n < count; n++) {
+        // from the cursor on and around, so the frames keep moving forward where they can
+        auto i = (cursor_ + n) % count;
+        auto& meta = recording_.meta(i);
+        if (meta.gain != gain_ || !contains(meta.roi, region_))
+            continue;
+
+        auto d = distance(meta.exposure, exposure_);
+        if (d < best_distance) {
+            best = i;
+            best_distance = d;
+        }
+    }
+
+    return best;
+}
+
+bool CaptureReplay::next(RecordedFrame& frame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    bool exact;
+    auto index = find(exact);
+
+    if (index == recording_.size() || !recording_.read(index, frame))
+        return false;
+
+    if (exact) {
+        cursor_ = index + 1;
+        seek_ = false;
+    } else {
+        cv::Rect crop(static_cast<int>(region_.x - frame.roi.x), static_cast<int>(region_.y - frame.roi.y),
+                      static_cast<int>(region_.width), static_cast<int>(region_.height));
+        frame.image = frame.image(crop).clone();
+        frame.roi = region_;
+        ++mismatched_;
+    }
+
+    timestamp_ = frame.timestamp;
+    ++served_;
+    return true;
+}
+
+std::string CaptureReplay::name() const {
+    return "replay";
+}
+
+bool CaptureReplay::initialize() {
+    return true;
+}
+
+void CaptureReplay::uninitialize() { }
+
+bool CaptureReplay::open() {
+    is_open_ = recording_.size() > 0;
+    return is_open_;
+}
+
+void CaptureReplay::close() {
+    is_open_ = false;
+}
+
+bool CaptureReplay::is_open() const {
+    return is_open_;
+}
+
+void CaptureReplay::prepare() { }
+
+bool CaptureReplay::frame_init() {
+    return true;
+}
+
+int CaptureReplay::cap_init() const {
+    return 0;
+}
+
+bool CaptureReplay::cap_end() const {
+    return true;
+}
+
+bool CaptureReplay::aquisition_init() const {
+    return true;
+}
+
+bool CaptureReplay::aquisition_end() const {
+    return true;
+}
+
+bool CaptureReplay::region(cv::Rect_<unsigned long> new_region) {
+    if (new_region.width == 0 || new_region.height == 0)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    region_ = new_region;
+    seek_ = true;
+    return true;
+}
+
+cv::Rect_<unsigned long> CaptureReplay::region() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return region_;
+}
+
+bool CaptureReplay::exposure(unsigned long new_value) {
+    if (new_value == 0)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    exposure_ = new_value;
+    seek_ = true;
+    return true;
+}
+
+unsigned long CaptureReplay::exposure() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return exposure_;
+}
+
+void CaptureReplay::gain(unsigned long new_value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gain_ = new_value;
+    seek_ = true;
+}
+
+unsigned long CaptureReplay::gain() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return gain_;
+}
+
+void CaptureReplay::cap(int frame_count, std::vector<cv::Mat>& target_vector) {
+    target_vector.reserve(target_vector.size() + frame_count);
+
+    RecordedFrame frame;
+    for (auto i = frame_count; i-- && next(frame);)
+        target_vector.emplace_back(frame.image);
+}
+
+void CaptureReplay::cap_single(cv::Mat& target) {
+    RecordedFrame frame;
+    if (next(frame))
+        target = frame.image;
+}
+
+bool CaptureReplay::cap_single(cv::Mat& target, const cv::Rect_<unsigned long>& roi, unsigned long timeout, unsigned long& frame_id, unsigned long long& timestamp) {
+    RecordedFrame frame;
+
+    if (roi != region() || !next(frame)) {
+        // the camera would wait for a frame that never comes
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+        return false;
+    }
+
+    target = frame.image;
+    frame_id = frame.frame_id;
+    timestamp = frame.timestamp;
+    return true;
+}
+
+unsigned long long CaptureReplay::timestamp() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timestamp_;
+}
+
+size_t CaptureReplay::served() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return served_;
+}
+
+size_t CaptureReplay::mismatched() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mismatched_;
+}
+
+size_t CaptureReplay::stale_frames() const {
+    return 0;
+}
+
+std::string CaptureReplay::report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cv::format("replayed %i of %i recorded frames, %i with other settings than recorded\n",
+                      static_cast<int>(served_), static_cast<int>(recording_.size()), static_cast<int>(mismatched_));
+}
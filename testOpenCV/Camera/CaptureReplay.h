@@ -0,0 +1,147 @@
+#pragma once
+#include <mutex>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "CaptureInterface.h"
+#include "FrameRecording.h"
+
+/**
+ * \brief Capture device serving the frames of a recording, so a measurement can be repeated offline.
+ * The replay follows the exposure and region commands. The first capture after a command skips ahead to the next
+ * recorded frame taken with the new settings, the following ones only serve the frames recorded right after it,
+ * and time out at the end of that run like the camera would until the next command.
+ * That way the same commands get the same frames back as in the recorded run, even when a capture thread reads ahead.
+ * A setting the recording does not have is answered with the recorded frame of the closest exposure
+ * whose region holds the requested one, cut to the requested region, and counted as a mismatch.
+ */
+class CaptureReplay : public CaptureInterface {
+
+    FrameRecording recording_;
+
+    // guards the settings and the replay position
+    mutable std::mutex mutex_;
+
+    // index of the next recorded frame to look at
+    size_t cursor_;
+
+    // set by a settings command, the next frame may be further on in the recording
+    bool seek_;
+
+    cv::Rect_<unsigned long> region_;
+
+    unsigned long exposure_;
+
+    unsigned long gain_;
+
+    unsigned long long timestamp_;
+
+    size_t served_;
+
+    size_t mismatched_;
+
+    bool is_open_;
+
+    /**
+     * \brief Finds the frame to serve for the current settings, requires the lock
+     * \param exact Set if the frame was recorded with the current settings
+     * \return The index of the frame, the size of the recording if there is none
+     */
+    size_t find(bool& exact) const;
+
+public:
+
+    CaptureReplay();
+
+    /**
+     * \brief Opens a recording and rewinds to its first frame, taking over its first settings
+     */
+    bool load(const std::string& filename);
+
+    /**
+     * \brief Starts over from the first frame
+     */
+    void rewind();
+
+    const FrameRecording& recording() const;
+
+    std::string name() const override;
+
+    bool initialize() override;
+
+    void uninitialize() override;
+
+    bool open() override;
+
+    void close() override;
+
+    bool is_open() const override;
+
+    void prepare() override;
+
+    bool frame_init() override;
+
+    int cap_init() const override;
+
+    bool cap_end() const override;
+
+    bool aquisition_init() const override;
+
+    bool aquisition_end() const override;
+
+    bool region(cv::Rect_<unsigned long> new_region) override;
+
+    cv::Rect_<unsigned long> region() const override;
+
+    bool exposure(unsigned long new_value) override;
+
+    unsigned long exposure() const override;
+
+    void gain(unsigned long new_value) override;
+
+    unsigned long gain() const override;
+
+    /**
+     * \brief Captures frames of the current settings, fewer if the recording runs out
+     */
+    void cap(int frame_count, std::vector<cv::Mat>& target_vector) override;
+
+    void cap_single(cv::Mat& target) override;
+
+    /**
+     * \brief Captures a single frame
+     * \param target The target
+     * \param roi The region the caller expects
+     * \param timeout The wait in milliseconds when there is no frame, as a camera would wait
+     * \param frame_id The recorded frame counter
+     * \param timestamp The recorded camera time in microseconds
+     * \return false if the region does not match the current one or the recording has no frame for it
+     */
+    bool cap_single(cv::Mat& target, const cv::Rect_<unsigned long>& roi, unsigned long timeout, unsigned long& frame_id, unsigned long long& timestamp) override;
+
+    /**
+     * \brief Serves the next frame with its metadata
+     * \return false if the recording has no frame for the current settings
+     */
+    bool next(RecordedFrame& frame);
+
+    /**
+     * \brief Camera time of the last served frame in microseconds
+     */
+    unsigned long long timestamp() const;
+
+    /**
+     * \brief The number of frames served so far
+     */
+    size_t served() const;
+
+    /**
+     * \brief The number of frames served with other settings than requested
+     */
+    size_t mismatched() const;
+
+    size_t stale_frames() const override;
+
+    std::string report() const override;
+
+};
@@ -0,0 +1,280 @@
+#include "CaptureSimulated.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+    // rows of the laser profile rendered on each side of the line center, in standard deviations
+    const double laser_extent = 4.0;
+
+    /**
+     * \brief How much of the column at x is marking, ramping up over the border width at each border
+     */
+    double marking_cover(const SimulatedScene& scene, double x) {
+        auto half = scene.border_width / 2.0;
+        if (half <= 0.0)
+            return x >= scene.marking_left && x < scene.marking_right ? 1.0 : 0.0;
+
+        auto rise = (x - (scene.marking_left - half)) / scene.border_width;
+        auto fall = ((scene.marking_right + half) - x) / scene.border_width;
+        return std::max(0.0, std::min({1.0, rise, fall}));
+    }
+
+}
+
+CaptureSimulated::CaptureSimulated(const SimulatedScene& scene)
+    : scene_(scene)
+      , rng_(scene.seed)
+      , region_(default_roi)
+      , exposure_(5000)
+      , gain_(0)
+      , frame_id_(0)
+      , time_us_(0)
+      , pace_(false)
+      , is_open_(false)
+      , start_(std::chrono::steady_clock::now()) { }
+
+const SimulatedScene& CaptureSimulated::scene() const {
+    return scene_;
+}
+
+void CaptureSimulated::scene(const SimulatedScene& new_scene) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    scene_ = new_scene;
+}
+
+SimulatedTruth CaptureSimulated::truth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    SimulatedTruth truth;
+    truth.base_y = scene_.laser_y;
+    truth.marking_y = scene_.laser_y - scene_.marking_height;
+    truth.height = scene_.marking_height;
+    truth.marking_rect = cv::Rect_<double>(scene_.marking_left, truth.marking_y, scene_.marking_right - scene_.marking_left, truth.height);
+
+    return truth;
+}
+
+double CaptureSimulated::laser_y(double x) const {
+    auto base = scene_.laser_y + scene_.laser_tilt * (x - scene_.sensor.width / 2.0);
+    return base - scene_.marking_height * marking_cover(scene_, x);
+}
+
+void CaptureSimulated::pace(bool new_value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pace_ = new_value;
+}
+
+bool CaptureSimulated::pace() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pace_;
+}
+
+std::string CaptureSimulated::name() const {
+    return "simulated";
+}
+
+bool CaptureSimulated::initialize() {
+    return true;
+}
+
+void CaptureSimulated::uninitialize() { }
+
+bool CaptureSimulated::open() {
+    is_open_ = true;
+    return true;
+}
+
+void CaptureSimulated::close() {
+    is_open_ = false;
+}
+
+bool CaptureSimulated::is_open() const {
+    return is_open_;
+}
+
+void CaptureSimulated::prepare() { }
+
+bool CaptureSimulated::frame_init() {
+    return true;
+}
+
+int CaptureSimulated::cap_init() const {
+    return 0;
+}
+
+bool CaptureSimulated::cap_end() const {
+    return true;
+}
+
+bool CaptureSimulated::aquisition_init() const {
+    return true;
+}
+
+bool CaptureSimulated::aquisition_end() const {
+    return true;
+}
+
+bool CaptureSimulated::region(cv::Rect_<unsigned long> new_region) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (new_region.width == 0 || new_region.height == 0)
+        return false;
+
+    if (new_region.x + new_region.width > static_cast<unsigned long>(scene_.sensor.width)
+        || new_region.y + new_region.height > static_cast<unsigned long>(scene_.sensor.height))
+        return false;
+
+    region_ = new_region;
+    return true;
+}
+
+cv::Rect_<unsigned long> CaptureSimulated::region() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return region_;
+}
+
+bool CaptureSimulated::exposure(unsigned long new_value) {
+    if (new_value == 0)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    exposure_ = new_value;
+    return true;
+}
+
+unsigned long CaptureSimulated::exposure() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return exposure_;
+}
+
+void CaptureSimulated::gain(unsigned long new_value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    gain_ = new_value;
+}
+
+unsigned long CaptureSimulated::gain() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return gain_;
+}
+
+unsigned long long CaptureSimulated::frame_period_us() const {
+    auto period = static_cast<unsigned long long>(1000000.0 / scene_.frame_rate);
+    return std::max(period, static_cast<unsigned long long>(exposure_));
+}
+
+void CaptureSimulated::render(cv::Mat& target) {
+    const auto rows = static_cast<int>(region_.height);
+    const auto cols = static_cast<int>(region_.width);
+
+    auto amplify = std::pow(10.0, gain_ / 20.0) * exposure_;
+    auto laser_peak = scene_.laser_level * amplify;
+
+    level_.create(rows, cols, CV_32FC1);
+
+    auto top = static_cast<double>(region_.y);
+
+    for (auto c = 0; c < cols; c++) {
+        auto x = static_cast<double>(region_.x + c);
+        auto reflect = scene_.road_level + (scene_.marking_level - scene_.road_level) * marking_cover(scene_, x);
+        level_.col(c).setTo(cv::Scalar::all(scene_.light * reflect * amplify));
+
+        // only the rows the laser profile reaches are touched
+        auto center = laser_y(x) - top;
+        auto first = std::max(0, static_cast<int>(std::floor(center - laser_extent * scene_.laser_sigma)));
+        auto last = std::min(rows - 1, static_cast<int>(std::ceil(center + laser_extent * scene_.laser_sigma)));
+
+        for (auto r = first; r <= last; r++) {
+            auto d = (r - center) / scene_.laser_sigma;
+            level_.at<float>(r, c) += static_cast<float>(laser_peak * std::exp(-0.5 * d * d));
+        }
+    }
+
+    if (scene_.noise > 0.0) {
+        noise_.create(rows, cols, CV_32FC1);
+        rng_.fill(noise_, cv::RNG::NORMAL, 0.0, scene_.noise);
+        level_ += noise_;
+    }
+
+    pool_->reserve(rows, cols, CV_8UC1, 1);
+    target = pool_->get(rows, cols, CV_8UC1);
+
+    // the conversion saturates like the sensor
+    level_.convertTo(target, CV_8UC1);
+}
+
+void CaptureSimulated::cap(int frame_count, std::vector<cv::Mat>& target_vector) {
+    target_vector.reserve(target_vector.size() + frame_count);
+
+    for (auto i = frame_count; i--;) {
+        cv::Mat frame;
+        cap_single(frame);
+        target_vector.emplace_back(frame);
+    }
+}
+
+unsigned long CaptureSimulated::capture(cv::Mat& target, unsigned long long& timestamp) {
+    std::chrono::steady_clock::time_point due;
+    unsigned long frame_id;
+    bool pace;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        time_us_ += frame_period_us();
+
+        // the camera runs freely, frames nobody waited for are gone
+        if (pace_) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_).count();
+            time_us_ = std::max(time_us_, static_cast<unsigned long long>(elapsed));
+        }
+
+        frame_id = ++frame_id_;
+        timestamp = time_us_;
+        due = start_ + std::chrono::microseconds(time_us_);
+        pace = pace_;
+        render(target);
+    }
+
+    if (pace)
+        std::this_thread::sleep_until(due);
+
+    return frame_id;
+}
+
+void CaptureSimulated::cap_single(cv::Mat& target) {
+    unsigned long long timestamp;
+    capture(target, timestamp);
+}
+
+bool CaptureSimulated::cap_single(cv::Mat& target, const cv::Rect_<unsigned long>& roi, unsigned long /*timeout*/, unsigned long& frame_id, unsigned long long& timestamp) {
+    if (roi != region())
+        return false;
+
+    frame_id = capture(target, timestamp);
+    return true;
+}
+
+unsigned long long CaptureSimulated::timestamp() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return time_us_;
+}
+
+unsigned long CaptureSimulated::frame_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frame_id_;
+}
+
+size_t CaptureSimulated::stale_frames() const {
+    return 0;
+}
+
+std::string CaptureSimulated::report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cv::format("rendered %i frames, %.1f s of camera time\n", static_cast<int>(frame_id_), time_us_ / 1e6);
+}
+
+const FramePool& CaptureSimulated::frame_pool() const {
+    return *pool_;
+}
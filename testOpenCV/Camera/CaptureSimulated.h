@@ -0,0 +1,237 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "CaptureInterface.h"
+#include "FramePool.h"
+
+/**
+ * \brief The scene rendered by CaptureSimulated, positions are in sensor pixels.
+ * A bright marking lies between two darker road areas, and the laser crosses both as a horizontal line.
+ * On the marking the line is raised by the height of the marking.
+ */
+struct SimulatedScene {
+
+    cv::Size sensor = cv::Size(2448, 2040);
+
+    // left and right border of the marking
+    double marking_left = 800.0;
+    double marking_right = 1600.0;
+
+    // columns over which a border goes from road to marking
+    double border_width = 4.0;
+
+    // pixel level per microsecond of exposure at 0 dB gain
+    double road_level = 0.006;
+    double marking_level = 0.0255;
+
+    // row of the laser on the road, at the center column
+    double laser_y = 1134.0;
+
+    // rows the laser line is raised by on the marking
+    double marking_height = 6.0;
+
+    // rows the laser line drops per column, the line is never quite level
+    double laser_tilt = 0.0;
+
+    // standard deviation of the laser line profile in rows
+    double laser_sigma = 1.5;
+
+    // peak pixel level of the laser per microsecond of exposure at 0 dB gain
+    double laser_level = 0.01;
+
+    // ambient light, scales the marking and road but not the laser
+    double light = 1.0;
+
+    // standard deviation of the sensor noise in pixel levels
+    double noise = 2.0;
+
+    // the highest frame rate of the camera, longer exposures lower it
+    double frame_rate = 15.0;
+
+    unsigned int seed = 42;
+
+};
+
+/**
+ * \brief What the scene looks like, to compare measurements against
+ */
+struct SimulatedTruth {
+
+    // the marking in sensor coordinates, spanning the rows of the laser line
+    cv::Rect_<double> marking_rect;
+
+    // row of the laser on the road and on the marking, at the center column
+    double base_y;
+
+    double marking_y;
+
+    // the height of the marking in rows
+    double height;
+
+};
+
+/**
+ * \brief Simulated capture device, so the processing can run and be benchmarked without a camera.
+ * Frames are rendered from a SimulatedScene for the current region, exposure and gain,
+ * saturating like the 8 bit sensor does. Frames carry a frame counter and a camera time,
+ * and with pacing enabled they are delivered no faster than the camera would deliver them.
+ */
+class CaptureSimulated : public CaptureInterface {
+
+    SimulatedScene scene_;
+
+    std::shared_ptr<FramePool> pool_ = FramePool::create();
+
+    // guards the settings, the frame counter and the render buffers
+    mutable std::mutex mutex_;
+
+    cv::RNG rng_;
+
+    // pixel levels of the frame being rendered, before noise and saturation
+    cv::Mat level_;
+
+    cv::Mat noise_;
+
+    cv::Rect_<unsigned long> region_;
+
+    unsigned long exposure_;
+
+    unsigned long gain_;
+
+    unsigned long frame_id_;
+
+    // camera time of the last frame in microseconds
+    unsigned long long time_us_;
+
+    bool pace_;
+
+    bool is_open_;
+
+    // wall time of camera time 0, for pacing
+    std::chrono::steady_clock::time_point start_;
+
+    /**
+     * \brief Renders a frame of the current settings into target, requires the lock
+     */
+    void render(cv::Mat& target);
+
+    /**
+     * \brief Microseconds between two frames with the current exposure
+     */
+    unsigned long long frame_period_us() const;
+
+    /**
+     * \brief Renders the next frame, waiting for its camera time when pacing
+     * \return The frame counter of the frame
+     */
+    unsigned long capture(cv::Mat& target, unsigned long long& timestamp);
+
+public:
+
+    explicit CaptureSimulated(const SimulatedScene& scene = SimulatedScene());
+
+    const SimulatedScene& scene() const;
+
+    /**
+     * \brief Changes the scene, takes effect from the next frame
+     */
+    void scene(const SimulatedScene& new_scene);
+
+    /**
+     * \brief The ground truth of the current scene
+     */
+    SimulatedTruth truth() const;
+
+    /**
+     * \brief Row of the laser line center at a sensor column, on the road or the marking
+     */
+    double laser_y(double x) const;
+
+    /**
+     * \brief If set, frames are delivered at the frame rate of the camera instead of as fast as they render
+     */
+    void pace(bool new_value);
+
+    bool pace() const;
+
+    std::string name() const override;
+
+    bool initialize() override;
+
+    void uninitialize() override;
+
+    bool open() override;
+
+    void close() override;
+
+    bool is_open() const override;
+
+    void prepare() override;
+
+    bool frame_init() override;
+
+    int cap_init() const override;
+
+    bool cap_end() const override;
+
+    bool aquisition_init() const override;
+
+    bool aquisition_end() const override;
+
+    /**
+     * \brief Sets the region, which has to fit on the sensor
+     */
+    bool region(cv::Rect_<unsigned long> new_region) override;
+
+    cv::Rect_<unsigned long> region() const override;
+
+    bool exposure(unsigned long new_value) override;
+
+    unsigned long exposure() const override;
+
+    /**
+     * \brief Sets the gain in dB
+     */
+    void gain(unsigned long new_value) override;
+
+    unsigned long gain() const override;
+
+    /**
+     * \brief Captures frames of the current settings
+     * \param frame_count Amount of frames to capture
+     * \param target_vector The target vector for the captured images
+     */
+    void cap(int frame_count, std::vector<cv::Mat>& target_vector) override;
+
+    void cap_single(cv::Mat& target) override;
+
+    /**
+     * \brief Captures a single frame, the region is only checked against the current one
+     * \param target The target, backed by a pooled buffer
+     * \param roi The region the caller expects
+     * \param timeout Unused, a simulated frame is always delivered
+     * \param frame_id The frame counter for the captured frame
+     * \param timestamp The camera time of the captured frame in microseconds
+     * \return false if the region does not match the current one
+     */
+    bool cap_single(cv::Mat& target, const cv::Rect_<unsigned long>& roi, unsigned long timeout, unsigned long& frame_id, unsigned long long& timestamp) override;
+
+    /**
+     * \brief Camera time of the last frame in microseconds
+     */
+    unsigned long long timestamp() const;
+
+    /**
+     * \brief The number of frames captured so far
+     */
+    unsigned long frame_count() const;
+
+    size_t stale_frames() const override;
+
+    std::string report() const override;
+
+    const FramePool& frame_pool() const;
+
+};
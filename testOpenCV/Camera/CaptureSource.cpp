@@ -0,0 +1,39 @@
+#include "CaptureSource.h"
+#include <cctype>
+#include <algorithm>
+#include "CaptureOpenCV.h"
+#include "CapturePvApi.h"
+#include "CaptureReplay.h"
+#include "CaptureSimulated.h"
+
+std::shared_ptr<CaptureInterface> capture_source(const std::string& source) {
+    auto colon = source.find(':');
+    auto kind = source.substr(0, colon);
+    auto argument = colon == std::string::npos ? std::string() : source.substr(colon + 1);
+
+    if (kind == "pvapi")
+        return std::make_shared<CapturePvApi>();
+
+    if (kind == "simulated" || kind == "sim") {
+        // runs at the frame rate of the camera, like the real one would
+        auto simulated = std::make_shared<CaptureSimulated>();
+        simulated->pace(true);
+        return simulated;
+    }
+
+    if (kind == "replay") {
+        auto replay = std::make_shared<CaptureReplay>();
+        if (!replay->load(argument))
+            return nullptr;
+        return replay;
+    }
+
+    if (kind == "opencv" && !argument.empty()) {
+        auto is_index = std::all_of(argument.begin(), argument.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+        if (is_index)
+            return std::make_shared<CaptureOpenCV>(std::stoi(argument));
+        return std::make_shared<CaptureOpenCV>(argument);
+    }
+
+    return nullptr;
+}
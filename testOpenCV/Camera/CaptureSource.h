@@ -0,0 +1,12 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "CaptureInterface.h"
+
+/**
+ * \brief Creates the capture device for a source description
+ * \param source "pvapi" for the camera through PvAPI, "simulated" for the simulated scene, "replay:<file>" for a frame recording,
+ * "opencv:<device index>" for a video device or "opencv:<file>" for a video file or image sequence through OpenCV
+ * \return The device, nullptr if the source is unknown or the recording could not be read
+ */
+std::shared_ptr<CaptureInterface> capture_source(const std::string& source);
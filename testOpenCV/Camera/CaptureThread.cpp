@@ -0,0 +1,216 @@
+#include "CaptureThread.h"
+#include <chrono>
+
+CaptureThread::CaptureThread(std::shared_ptr<CaptureInterface> capture, size_t capacity, OverflowPolicy policy)
+    : capture_(std::move(capture))
+      , ring_(capacity)
+      , policy_(policy)
+      , exposure_(0)
+      , gain_(0)
+      , generation_(0)
+      , running_(false)
+      , stale_(0)
+      , consumer_waiting_(false)
+      , producer_waiting_(false) { }
+
+CaptureThread::~CaptureThread() {
+    stop();
+}
+
+void CaptureThread::run() {
+    while (running_) {
+        CapturedFrame frame;
+        bool ok;
+
+        {
+            // the settings can not change while the frame is taken, so the tag is always right
+            std::lock_guard<std::mutex> lock(camera_mutex_);
+            frame.exposure = exposure_;
+            frame.roi = roi_;
+            frame.gain = gain_;
+            frame.generation = generation_;
+            ok = capture_->cap_single(frame.image, roi_, 100, frame.frame_id, frame.timestamp);
+        }
+
+        if (!ok)
+            continue;
+
+        if (recorder_)
+            record(frame);
+
+        push(std::move(frame));
+    }
+}
+
+void CaptureThread::record(const CapturedFrame& frame) const {
+    RecordedFrame recorded;
+    recorded.frame_id = frame.frame_id;
+    recorded.timestamp = frame.timestamp;
+    recorded.exposure = frame.exposure;
+    recorded.gain = frame.gain;
+    recorded.roi = frame.roi;
+    recorded.image = frame.image;
+    recorder_->post(recorded);
+}
+
+void CaptureThread::wake(const std::atomic<bool>& waiting, std::condition_variable& condition) {
+    // pairs with the fence of the waiting side, either it sees the change or this side sees it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        condition.notify_one();
+    }
+}
+
+void CaptureThread::push(CapturedFrame&& frame) {
+    if (policy_ == OverflowPolicy::DropOldest) {
+        ring_.push_drop_oldest(std::move(frame));
+        wake(consumer_waiting_, pushed_);
+        return;
+    }
+
+    // the camera keeps its own buffers queued meanwhile, and drops frames when those are full too
+    while (!ring_.try_push(std::move(frame))) {
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        producer_waiting_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        popped_.wait(lock, [this] { return !running_ || ring_.size() < ring_.capacity(); });
+        producer_waiting_.store(false, std::memory_order_relaxed);
+
+        if (!running_)
+            return;
+    }
+
+    wake(consumer_waiting_, pushed_);
+}
+
+bool CaptureThread::next(CapturedFrame& frame, unsigned long timeout) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+    while (true) {
+        if (ring_.try_pop(frame)) {
+            wake(producer_waiting_, popped_);
+            if (frame.generation == generation_)
+                return true;
+            ++stale_;
+            continue;
+        }
+
+        if (!running_)
+            return false;
+
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        consumer_waiting_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto ready = pushed_.wait_until(lock, deadline, [this] { return !ring_.empty() || !running_; });
+        consumer_waiting_.store(false, std::memory_order_relaxed);
+
+        if (!ready)
+            return false;
+    }
+}
+
+void CaptureThread::changed() {
+    ++generation_;
+}
+
+void CaptureThread::start() {
+    if (running_)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(camera_mutex_);
+        roi_ = capture_->region();
+        exposure_ = capture_->exposure();
+        gain_ = capture_->gain();
+        changed();
+    }
+
+    running_ = true;
+    thread_ = std::thread(&CaptureThread::run, this);
+}
+
+void CaptureThread::stop() {
+    running_ = false;
+
+    {
+        // wakes a producer waiting for room and a consumer waiting for a frame
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        popped_.notify_all();
+        pushed_.notify_all();
+    }
+
+    if (thread_.joinable())
+        thread_.join();
+}
+
+bool CaptureThread::running() const {
+    return running_;
+}
+
+void CaptureThread::recorder(std::shared_ptr<FrameRecorder> new_recorder) {
+    recorder_ = std::move(new_recorder);
+}
+
+std::shared_ptr<FrameRecorder> CaptureThread::recorder() const {
+    return recorder_;
+}
+
+OverflowPolicy CaptureThread::policy() const {
+    return policy_;
+}
+
+void CaptureThread::policy(OverflowPolicy new_policy) {
+    policy_ = new_policy;
+}
+
+size_t CaptureThread::cap(int frame_count, std::vector<cv::Mat>& target_vector, unsigned long timeout) {
+    target_vector.reserve(target_vector.size() + frame_count);
+    return consume(frame_count, [&target_vector](const CapturedFrame& frame) {
+                       target_vector.emplace_back(frame.image);
+                   }, timeout);
+}
+
+bool CaptureThread::region(cv::Rect_<unsigned long> new_region) {
+    std::lock_guard<std::mutex> lock(camera_mutex_);
+    if (!capture_->region(new_region))
+        return false;
+    roi_ = new_region;
+    changed();
+    return true;
+}
+
+cv::Rect_<unsigned long> CaptureThread::region() const {
+    std::lock_guard<std::mutex> lock(camera_mutex_);
+    return roi_;
+}
+
+bool CaptureThread::exposure(unsigned long new_value) {
+    std::lock_guard<std::mutex> lock(camera_mutex_);
+    if (!capture_->exposure(new_value))
+        return false;
+    exposure_ = new_value;
+    changed();
+    return true;
+}
+
+unsigned long CaptureThread::exposure() const {
+    std::lock_guard<std::mutex> lock(camera_mutex_);
+    return exposure_;
+}
+
+bool CaptureThread::exposure_mul(unsigned long value) {
+    return exposure(exposure() * value);
+}
+
+bool CaptureThread::exposure_div(unsigned long value) {
+    return exposure(exposure() / value);
+}
+
+size_t CaptureThread::dropped() const {
+    return ring_.dropped();
+}
+
+size_t CaptureThread::stale() const {
+    return stale_;
+}
@@ -0,0 +1,207 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CaptureInterface.h"
+#include "FrameRecording.h"
+#include "Util/SpscRing.h"
+
+/**
+ * \brief A captured frame with the camera settings it was captured with
+ */
+struct CapturedFrame {
+
+    cv::Mat image;
+
+    unsigned long exposure = 0;
+
+    cv::Rect_<unsigned long> roi;
+
+    unsigned long gain = 0;
+
+    // the frame counter of the camera
+    unsigned long frame_id = 0;
+
+    // camera time in microseconds, 0 if the camera does not report it
+    unsigned long long timestamp = 0;
+
+    // the settings generation the frame belongs to, changes with every exposure or region change
+    unsigned long generation = 0;
+
+};
+
+/**
+ * \brief What the capture thread does when the consumer falls behind and the ring is full
+ */
+enum class OverflowPolicy {
+    // wait for the consumer, the camera drops frames once its own buffers are full
+    BackPressure,
+    // discard the oldest frame in the ring, the consumer always sees the most recent frames
+    DropOldest
+};
+
+/**
+ * \brief Captures frames on a dedicated thread into a single producer single consumer ring,
+ * so the capture of the next frame overlaps the analysis of the current one.
+ * While the thread runs all camera control goes through this class, a settings change takes effect
+ * between two frames. The camera discards the frames exposed before the change that are still in the driver,
+ * and the consumer discards the ones that were already in the ring.
+ */
+class CaptureThread {
+
+    std::shared_ptr<CaptureInterface> capture_;
+
+    SpscRing<CapturedFrame> ring_;
+
+    std::atomic<OverflowPolicy> policy_;
+
+    // serializes the camera between the capture thread and settings changes
+    mutable std::mutex camera_mutex_;
+
+    unsigned long exposure_;
+
+    cv::Rect_<unsigned long> roi_;
+
+    unsigned long gain_;
+
+    // every captured frame is recorded if set
+    std::shared_ptr<FrameRecorder> recorder_;
+
+    std::atomic<unsigned long> generation_;
+
+    std::atomic<bool> running_;
+
+    std::atomic<size_t> stale_;
+
+    // only taken to sleep and to wake a sleeping side, never to pass a frame
+    std::mutex wait_mutex_;
+
+    // the consumer waits for a frame, the producer for room in the ring
+    std::condition_variable pushed_;
+
+    std::condition_variable popped_;
+
+    // set while a side is about to sleep, the other side only notifies then
+    std::atomic<bool> consumer_waiting_;
+
+    std::atomic<bool> producer_waiting_;
+
+    std::thread thread_;
+
+    void run();
+
+    void push(CapturedFrame&& frame);
+
+    void record(const CapturedFrame& frame) const;
+
+    /**
+     * \brief Wakes the other side after a push or pop if it sleeps or is about to
+     */
+    void wake(const std::atomic<bool>& waiting, std::condition_variable& condition);
+
+    /**
+     * \brief Takes the next frame of the current settings
+     * \return false on timeout
+     */
+    bool next(CapturedFrame& frame, unsigned long timeout);
+
+    void changed();
+
+public:
+
+    /**
+     * \brief Creates the thread, capture starts with start()
+     * \param capture The capture device, capture and acquisition have to be initialized
+     * \param capacity The number of frames the ring holds
+     * \param policy The overflow policy
+     */
+    CaptureThread(std::shared_ptr<CaptureInterface> capture, size_t capacity, OverflowPolicy policy);
+
+    ~CaptureThread();
+
+    CaptureThread(const CaptureThread&) = delete;
+
+    CaptureThread& operator=(const CaptureThread&) = delete;
+
+    /**
+     * \brief Reads the current camera settings and starts capturing
+     */
+    void start();
+
+    /**
+     * \brief Stops the thread, the camera can be used directly again afterwards
+     */
+    void stop();
+
+    bool running() const;
+
+    /**
+     * \brief Records every captured frame with its settings and timing, including the ones the consumer discards.
+     * The frames are posted to the writer thread of the recorder, they share their pixels with the frames the consumer gets.
+     * Only change the recorder while the thread is stopped.
+     * \param new_recorder The recorder, nullptr stops recording
+     */
+    void recorder(std::shared_ptr<FrameRecorder> new_recorder);
+
+    std::shared_ptr<FrameRecorder> recorder() const;
+
+    OverflowPolicy policy() const;
+
+    void policy(OverflowPolicy new_policy);
+
+    /**
+     * \brief Takes frames of the current settings, in capture order
+     * \param frame_count The number of frames
+     * \param target_vector The target for the frames
+     * \param timeout The maximum wait for each frame in milliseconds
+     * \return The number of frames taken
+     */
+    size_t cap(int frame_count, std::vector<cv::Mat>& target_vector, unsigned long timeout = 1000);
+
+    /**
+     * \brief Calls func(const CapturedFrame&) for frames of the current settings as they arrive,
+     * the next frame is captured while func runs
+     * \return The number of frames consumed
+     */
+    template <typename Func>
+    size_t consume(int frame_count, Func func, unsigned long timeout = 1000);
+
+    bool region(cv::Rect_<unsigned long> new_region);
+
+    cv::Rect_<unsigned long> region() const;
+
+    bool exposure(unsigned long new_value);
+
+    unsigned long exposure() const;
+
+    bool exposure_mul(unsigned long value);
+
+    bool exposure_div(unsigned long value);
+
+    /**
+     * \brief Frames discarded because the ring was full
+     */
+    size_t dropped() const;
+
+    /**
+     * \brief Frames discarded because they were captured with earlier settings
+     */
+    size_t stale() const;
+
+};
+
+template <typename Func>
+size_t CaptureThread::consume(int frame_count, Func func, unsigned long timeout) {
+    size_t consumed = 0;
+    CapturedFrame frame;
+
+    while (consumed < static_cast<size_t>(frame_count) && next(frame, timeout)) {
+        func(static_cast<const CapturedFrame&>(frame));
+        ++consumed;
+    }
+
+    return consumed;
+}
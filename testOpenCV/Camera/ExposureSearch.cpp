@@ -0,0 +1,105 @@
+#include "ExposureSearch.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <opencv2/core.hpp>
+
+namespace {
+
+    // distance in columns between the compared column means, a blurred border spans a few columns
+    const int border_span = 8;
+
+    const double saturated_level = 250.0;
+
+}
+
+double ExposureSearch::border_contrast(const cv::Mat& frame) {
+    CV_Assert(frame.type() == CV_8UC1);
+
+    if (frame.cols <= border_span)
+        return 0.0;
+
+    cv::Mat profile;
+    cv::reduce(frame, profile, 0, cv::REDUCE_AVG, CV_32F);
+
+    auto p = profile.ptr<float>(0);
+    auto step = 0.0f;
+    for (auto x = 0; x + border_span < profile.cols; x++)
+        step = std::max(step, std::abs(p[x + border_span] - p[x]));
+
+    auto saturated = static_cast<double>(cv::countNonZero(frame >= saturated_level)) / frame.total();
+
+    return step * (1.0 - saturated);
+}
+
+unsigned long LinearExposureSearch::search(const ExposureRange& range, const score_func& /*score*/, const accept_func& accept) {
+    for (size_t i = 0; i < range.count(); i++) {
+        if (accept(range.at(i)))
+            return range.at(i);
+    }
+    return 0;
+}
+
+unsigned long GoldenSectionExposureSearch::search(const ExposureRange& range, const score_func& score, const accept_func& accept) {
+    const auto count = static_cast<int>(range.count());
+    if (count == 0)
+        return 0;
+
+    // every exposure is scored at most once, the search revisits its inner points
+    std::map<int, double> scores;
+    auto scored = [&](int index) {
+        auto it = scores.find(index);
+        if (it == scores.end())
+            it = scores.emplace(index, score(range.at(index))).first;
+        return it->second;
+    };
+
+    const auto ratio = 0.381966; // 2 - golden ratio
+
+    auto low = 0;
+    auto high = count - 1;
+
+    while (high - low > 2) {
+        auto inner = static_cast<int>(std::round((high - low) * ratio));
+        auto a = low + inner;
+        auto b = high - inner;
+        if (a >= b)
+            b = a + 1;
+
+        if (scored(a) < scored(b))
+            low = a;
+        else
+            high = b;
+    }
+
+    auto best = low;
+    for (auto i = low + 1; i <= high; i++) {
+        if (scored(i) > scored(best))
+            best = i;
+    }
+
+    // the best contrast usually detects, otherwise widen around it
+    for (auto distance = 0; distance < count; distance++) {
+        if (best + distance < count && accept(range.at(best + distance)))
+            return range.at(best + distance);
+        if (distance > 0 && best - distance >= 0 && accept(range.at(best - distance)))
+            return range.at(best - distance);
+    }
+
+    return 0;
+}
+
+PredictedExposureSearch::PredictedExposureSearch(std::unique_ptr<ExposureSearch> fallback, unsigned long seed)
+    : fallback_(std::move(fallback))
+      , last_(seed) { }
+
+unsigned long PredictedExposureSearch::search(const ExposureRange& range, const score_func& score, const accept_func& accept) {
+    if (last_ >= range.start && last_ <= range.end && accept(last_))
+        return last_;
+
+    auto found = fallback_->search(range, score, accept);
+    if (found > 0)
+        last_ = found;
+
+    return found;
+}
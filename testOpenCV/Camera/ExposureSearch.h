@@ -0,0 +1,137 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <opencv2/core/mat.hpp>
+
+/**
+ * \brief The exposure values a search may visit, start to end (inclusive) in increments
+ */
+struct ExposureRange {
+
+    unsigned long start;
+
+    unsigned long end;
+
+    unsigned long increment;
+
+    /**
+     * \brief The number of exposure values in the range
+     */
+    size_t count() const {
+        return end < start || increment == 0 ? 0 : (end - start) / increment + 1;
+    }
+
+    unsigned long at(size_t index) const {
+        return start + static_cast<unsigned long>(index) * increment;
+    }
+
+};
+
+/**
+ * \brief Strategy for finding an exposure where the marking is detected.
+ * The search has two probes, a cheap score of a single frame, and the full detection which decides if an exposure is accepted.
+ * Both capture frames, so a strategy should call them as few times as possible.
+ */
+class ExposureSearch {
+
+public:
+
+    /**
+     * \brief Captures a frame at the exposure and scores it, higher is better
+     */
+    using score_func = std::function<double(unsigned long)>;
+
+    /**
+     * \brief Captures frames at the exposure and runs the full detection on them
+     */
+    using accept_func = std::function<bool(unsigned long)>;
+
+    virtual ~ExposureSearch() = default;
+
+    /**
+     * \brief Searches the range for an accepted exposure
+     * \param range The exposure values to search
+     * \param score The cheap probe
+     * \param accept The full detection
+     * \return The accepted exposure, 0 if none was accepted
+     */
+    virtual unsigned long search(const ExposureRange& range, const score_func& score, const accept_func& accept) = 0;
+
+    virtual const char* name() const = 0;
+
+    /**
+     * \brief Scores the contrast of the vertical marking borders in a frame.
+     * The frame is reduced to its column means and the strongest step between columns a few pixels apart is taken,
+     * scaled down by the fraction of saturated pixels. Dark frames have no step, and the step shrinks again once
+     * the marking saturates and the road brightens, so the score peaks at a usable exposure.
+     * \param frame The 8 bit frame
+     * \return The score, 0 to 255
+     */
+    static double border_contrast(const cv::Mat& frame);
+
+};
+
+/**
+ * \brief Tries every exposure from start to end until one is accepted, the original phase one behaviour
+ */
+class LinearExposureSearch : public ExposureSearch {
+
+public:
+
+    unsigned long search(const ExposureRange& range, const score_func& score, const accept_func& accept) override;
+
+    const char* name() const override {
+        return "linear";
+    }
+
+};
+
+/**
+ * \brief Golden section search for the exposure with the best border contrast, which is then given to the full detection.
+ * If the detection fails there, the neighbouring exposures are tried in order of their distance to it.
+ * Assumes the score is unimodal over the range, which holds for a single marking in front of darker road.
+ */
+class GoldenSectionExposureSearch : public ExposureSearch {
+
+public:
+
+    unsigned long search(const ExposureRange& range, const score_func& score, const accept_func& accept) override;
+
+    const char* name() const override {
+        return "golden section";
+    }
+
+};
+
+/**
+ * \brief Tries the last accepted exposure first, the light rarely changes much between two measurements.
+ * Falls back to another strategy when the prediction is not accepted.
+ */
+class PredictedExposureSearch : public ExposureSearch {
+
+    std::unique_ptr<ExposureSearch> fallback_;
+
+    unsigned long last_;
+
+public:
+
+    explicit PredictedExposureSearch(std::unique_ptr<ExposureSearch> fallback, unsigned long seed = 0);
+
+    unsigned long search(const ExposureRange& range, const score_func& score, const accept_func& accept) override;
+
+    const char* name() const override {
+        return "predicted";
+    }
+
+    /**
+     * \brief The exposure tried first in the next search, 0 if there is none
+     */
+    unsigned long last() const {
+        return last_;
+    }
+
+    void last(unsigned long exposure) {
+        last_ = exposure;
+    }
+
+};
@@ -0,0 +1,162 @@
+#include "FramePool.h"
+#include <new>
+#include <opencv2/core.hpp>
+#include "Util/HugePageAllocator.h"
+
+namespace {
+
+    // marks the matrix data headers owned by the pool
+    constexpr int pooled_flag = 0x504f4f4c;
+
+}
+
+FramePool::FramePool()
+    : in_use_(0)
+      , slots_(0)
+      , buffer_size_(0) { }
+
+std::shared_ptr<FramePool> FramePool::create() {
+    return std::shared_ptr<FramePool>(new FramePool());
+}
+
+FramePool::~FramePool() {
+    for (auto& slot : free_)
+        release_slot(slot);
+}
+
+FramePool::Slot FramePool::new_slot() const {
+    ++slots_;
+    // the free list never has to grow when buffers are returned
+    free_.reserve(slots_);
+    return Slot{new cv::UMatData(this), static_cast<uchar*>(HugePageAllocator::instance()->allocate_block(buffer_size_)), buffer_size_};
+}
+
+void FramePool::release_slot(const Slot& slot) const {
+    --slots_;
+    HugePageAllocator::instance()->free_block(slot.buffer, slot.size);
+    delete slot.header;
+}
+
+void FramePool::track_allocate() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (in_use_++ == 0)
+        self_ = shared_from_this();
+}
+
+std::shared_ptr<const FramePool> FramePool::track_deallocate() const {
+    std::shared_ptr<const FramePool> keep;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--in_use_ == 0)
+        keep.swap(self_);
+    return keep;
+}
+
+void FramePool::reserve(int rows, int cols, int type, size_t count) {
+    auto size = static_cast<size_t>(rows) * cols * CV_ELEM_SIZE(type);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (size != buffer_size_) {
+        for (auto& slot : free_)
+            release_slot(slot);
+        free_.clear();
+        buffer_size_ = size;
+    }
+
+    while (free_.size() < count)
+        free_.emplace_back(new_slot());
+}
+
+cv::Mat FramePool::get(int rows, int cols, int type) {
+    cv::Mat m;
+    m.allocator = this;
+    m.create(rows, cols, type);
+    return m;
+}
+
+size_t FramePool::free_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+}
+
+size_t FramePool::in_use() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_use_;
+}
+
+cv::UMatData* FramePool::allocate(int dims, const int* sizes, int type, void* data, size_t* step, int /*flags*/, cv::UMatUsageFlags /*usage_flags*/) const {
+    // same layout as the default allocator
+    size_t total = CV_ELEM_SIZE(type);
+    for (auto i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data && step[i] != CV_AUTOSTEP) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            } else
+                step[i] = total;
+        }
+        total *= sizes[i];
+    }
+
+    cv::UMatData* u;
+    Slot slot{nullptr, nullptr, 0};
+
+    if (!data && total > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (total == buffer_size_) {
+            if (free_.empty()) {
+                slot = new_slot();
+            } else {
+                slot = free_.back();
+                free_.pop_back();
+            }
+        }
+    }
+
+    if (slot.header) {
+        // reset the recycled header in place
+        u = slot.header;
+        u->~UMatData();
+        new(u) cv::UMatData(this);
+        u->data = u->origdata = slot.buffer;
+        u->allocatorFlags_ = pooled_flag;
+    } else {
+        u = new cv::UMatData(this);
+        u->data = u->origdata = data ? static_cast<uchar*>(data) : static_cast<uchar*>(cv::fastMalloc(total));
+        if (data)
+            u->flags |= cv::UMatData::USER_ALLOCATED;
+    }
+
+    u->size = total;
+
+    track_allocate();
+
+    return u;
+}
+
+bool FramePool::allocate(cv::UMatData* data, int /*access_flags*/, cv::UMatUsageFlags /*usage_flags*/) const {
+    return data != nullptr;
+}
+
+void FramePool::deallocate(cv::UMatData* data) const {
+    if (!data)
+        return;
+
+    CV_Assert(data->urefcount == 0 && data->refcount == 0);
+
+    if (data->allocatorFlags_ == pooled_flag) {
+        Slot slot{data, data->origdata, data->size};
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (data->size == buffer_size_)
+            free_.emplace_back(slot);
+        else
+            release_slot(slot);
+    } else {
+        if (!(data->flags & cv::UMatData::USER_ALLOCATED))
+            cv::fastFree(data->origdata);
+        delete data;
+    }
+
+    // may destroy the pool if it is no longer referenced, so it has to be the last thing done
+    track_deallocate();
+}
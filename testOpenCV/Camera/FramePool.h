@@ -0,0 +1,102 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <opencv2/core/mat.hpp>
+
+/**
+ * \brief Recycles the pixel buffers of captured frames.
+ * Used as the allocator of a cv::Mat, the buffer is taken from the pool when the matrix is created,
+ * and returned to the pool when the last reference to it is released, the consumer just lets the matrix go.
+ * Only requests of the current frame size are pooled, everything else is allocated as usual.
+ * The pool keeps itself alive as long as any of its buffers are in use, so frames can outlive the capture.
+ * The buffers are blocks of the HugePageAllocator, so full frames are backed by huge pages where possible.
+ */
+class FramePool : public cv::MatAllocator, public std::enable_shared_from_this<FramePool> {
+
+    /**
+     * \brief A pooled buffer with its reused matrix data header
+     */
+    struct Slot {
+        cv::UMatData* header;
+        uchar* buffer;
+        size_t size;
+    };
+
+    mutable std::mutex mutex_;
+
+    mutable std::vector<Slot> free_;
+
+    /**
+     * \brief The number of buffers handed out, pooled or not
+     */
+    mutable size_t in_use_;
+
+    /**
+     * \brief Keeps the pool alive while buffers are in use
+     */
+    mutable std::shared_ptr<const FramePool> self_;
+
+    /**
+     * \brief The number of pooled buffers alive, free or in use, the free list is kept this large
+     */
+    mutable size_t slots_;
+
+    size_t buffer_size_;
+
+    FramePool();
+
+    Slot new_slot() const;
+
+    /**
+     * \brief Frees a pooled buffer, requires the lock
+     */
+    void release_slot(const Slot& slot) const;
+
+    void track_allocate() const;
+
+    std::shared_ptr<const FramePool> track_deallocate() const;
+
+public:
+
+    /**
+     * \brief Creates an empty pool, use reserve() to set the frame size
+     */
+    static std::shared_ptr<FramePool> create();
+
+    ~FramePool();
+
+    FramePool(const FramePool&) = delete;
+
+    FramePool& operator=(const FramePool&) = delete;
+
+    /**
+     * \brief Sets the pooled frame size and makes sure at least count buffers are free.
+     * Free buffers of another size are released, buffers in use of another size are released when they are returned.
+     * \param rows The frame rows
+     * \param cols The frame columns
+     * \param type The frame type
+     * \param count The number of free buffers to have ready
+     */
+    void reserve(int rows, int cols, int type, size_t count);
+
+    /**
+     * \brief Creates a matrix backed by a pooled buffer
+     * \param rows The rows
+     * \param cols The columns
+     * \param type The type
+     * \return The matrix, its buffer returns to the pool when the last reference is gone
+     */
+    cv::Mat get(int rows, int cols, int type);
+
+    size_t free_count() const;
+
+    size_t in_use() const;
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, int flags, cv::UMatUsageFlags usage_flags) const override;
+
+    bool allocate(cv::UMatData* data, int access_flags, cv::UMatUsageFlags usage_flags) const override;
+
+    void deallocate(cv::UMatData* data) const override;
+
+};
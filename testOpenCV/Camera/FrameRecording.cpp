@@ -0,0 +1,204 @@
+#include "FrameRecording.h"
+#include <algorithm>
+
+namespace {
+
+    const char file_magic[8] = {'T', 'G', 'F', 'R', 'A', 'M', 'E', '1'};
+
+    const uint32_t record_magic = 0x52464754; // "TGFR"
+
+    /**
+     * \brief The fixed part of a record, the pixels follow row by row
+     */
+    struct RecordHeader {
+        uint32_t magic;
+        uint32_t frame_id;
+        uint64_t timestamp;
+        uint32_t exposure;
+        uint32_t gain;
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    static_assert(sizeof(RecordHeader) == 40, "the record header is written as is");
+
+}
+
+FrameRecorder::FrameRecorder(const std::string& filename, size_t queue_capacity)
+    : file_(filename, std::ios::binary | std::ios::trunc)
+      , frames_(0)
+      , queue_capacity_(queue_capacity)
+      , writing_(false)
+      , stopping_(false)
+      , dropped_(0) {
+    file_.write(file_magic, sizeof(file_magic));
+}
+
+FrameRecorder::~FrameRecorder() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stopping_ = true;
+    }
+    posted_.notify_one();
+
+    if (writer_.joinable())
+        writer_.join();
+}
+
+void FrameRecorder::write_posted() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+
+    while (true) {
+        posted_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+
+        // the queue is written out before stopping
+        if (queue_.empty())
+            return;
+
+        auto frame = std::move(queue_.front());
+        queue_.pop_front();
+        writing_ = true;
+
+        lock.unlock();
+        write(frame);
+        lock.lock();
+
+        writing_ = false;
+        if (queue_.empty())
+            written_.notify_all();
+    }
+}
+
+bool FrameRecorder::post(const RecordedFrame& frame) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+
+        if (queue_.size() >= queue_capacity_) {
+            ++dropped_;
+            return false;
+        }
+
+        queue_.emplace_back(frame);
+
+        if (!writer_.joinable())
+            writer_ = std::thread(&FrameRecorder::write_posted, this);
+    }
+
+    posted_.notify_one();
+    return true;
+}
+
+void FrameRecorder::flush() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    written_.wait(lock, [this] { return queue_.empty() && !writing_; });
+}
+
+size_t FrameRecorder::dropped() const {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return dropped_;
+}
+
+bool FrameRecorder::write(const RecordedFrame& frame) {
+    if (frame.image.type() != CV_8UC1)
+        return false;
+
+    RecordHeader header;
+    header.magic = record_magic;
+    header.frame_id = static_cast<uint32_t>(frame.frame_id);
+    header.timestamp = frame.timestamp;
+    header.exposure = static_cast<uint32_t>(frame.exposure);
+    header.gain = static_cast<uint32_t>(frame.gain);
+    header.x = static_cast<uint32_t>(frame.roi.x);
+    header.y = static_cast<uint32_t>(frame.roi.y);
+    header.width = static_cast<uint32_t>(frame.image.cols);
+    header.height = static_cast<uint32_t>(frame.image.rows);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (auto r = 0; r < frame.image.rows; r++)
+        file_.write(frame.image.ptr<char>(r), frame.image.cols);
+
+    if (!file_)
+        return false;
+
+    ++frames_;
+    return true;
+}
+
+bool FrameRecorder::good() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.good();
+}
+
+size_t FrameRecorder::frames() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frames_;
+}
+
+bool FrameRecording::open(const std::string& filename) {
+    entries_.clear();
+
+    file_.close();
+    file_.clear();
+    file_.open(filename, std::ios::binary | std::ios::ate);
+
+    auto file_size = static_cast<std::streamoff>(file_.tellg());
+    file_.seekg(0);
+
+    char magic[sizeof(file_magic)];
+    if (!file_.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), file_magic))
+        return false;
+
+    RecordHeader header;
+    while (file_.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.magic == record_magic) {
+        Entry entry;
+        entry.meta.frame_id = header.frame_id;
+        entry.meta.timestamp = header.timestamp;
+        entry.meta.exposure = header.exposure;
+        entry.meta.gain = header.gain;
+        entry.meta.roi = cv::Rect_<unsigned long>(header.x, header.y, header.width, header.height);
+        entry.offset = file_.tellg();
+
+        // the recording may have ended in the middle of a frame
+        auto pixels = static_cast<std::streamoff>(header.width) * header.height;
+        if (entry.offset + pixels > file_size)
+            break;
+
+        file_.seekg(entry.offset + pixels);
+
+        entries_.emplace_back(entry);
+    }
+
+    file_.clear();
+    return true;
+}
+
+size_t FrameRecording::size() const {
+    return entries_.size();
+}
+
+const RecordedFrame& FrameRecording::meta(size_t index) const {
+    return entries_[index].meta;
+}
+
+bool FrameRecording::read(size_t index, RecordedFrame& frame) const {
+    if (index >= entries_.size())
+        return false;
+
+    auto& entry = entries_[index];
+    frame = entry.meta;
+
+    const auto rows = static_cast<int>(entry.meta.roi.height);
+    const auto cols = static_cast<int>(entry.meta.roi.width);
+    frame.image.create(rows, cols, CV_8UC1);
+
+    file_.clear();
+    file_.seekg(entry.offset);
+    for (auto r = 0; r < rows; r++)
+        file_.read(frame.image.ptr<char>(r), cols);
+
+    return static_cast<bool>(file_);
+}
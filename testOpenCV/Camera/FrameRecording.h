@@ -0,0 +1,157 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/core.hpp>
+
+/**
+ * \brief A captured frame with the camera settings and timing it was captured with
+ */
+struct RecordedFrame {
+
+    // the frame counter of the camera
+    unsigned long frame_id = 0;
+
+    // camera time in microseconds, 0 if the camera does not report it
+    unsigned long long timestamp = 0;
+
+    unsigned long exposure = 0;
+
+    unsigned long gain = 0;
+
+    cv::Rect_<unsigned long> roi;
+
+    // 8 bit mono, the size of the region
+    cv::Mat image;
+
+};
+
+/**
+ * \brief Writes frames with their metadata into a single recording file, in the order they are captured.
+ * A recording is a file header followed by one record per frame, each a fixed size header and the pixels.
+ * Writing is thread safe, so the capture thread and the code changing the settings can both record.
+ * The capture thread posts its frames instead, they are written in order by the writer thread of the recorder,
+ * so the disk never holds up the capture.
+ */
+class FrameRecorder {
+
+    std::ofstream file_;
+
+    mutable std::mutex mutex_;
+
+    size_t frames_;
+
+    // frames posted and not yet written, the images share the pixels with the captured frames
+    std::deque<RecordedFrame> queue_;
+
+    size_t queue_capacity_;
+
+    // guards the queue and the writer state
+    mutable std::mutex queue_mutex_;
+
+    std::condition_variable posted_;
+
+    std::condition_variable written_;
+
+    // set while the writer thread writes a frame it took from the queue
+    bool writing_;
+
+    bool stopping_;
+
+    size_t dropped_;
+
+    std::thread writer_;
+
+    void write_posted();
+
+public:
+
+    /**
+     * \brief Creates the recording, an existing file is overwritten
+     * \param filename The recording file
+     * \param queue_capacity The number of posted frames that can wait for the writer
+     */
+    explicit FrameRecorder(const std::string& filename, size_t queue_capacity = 64);
+
+    /**
+     * \brief Writes the posted frames that are still queued and closes the recording
+     */
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    /**
+     * \brief Appends a frame
+     * \return false if the frame is not 8 bit mono or the file could not be written
+     */
+    bool write(const RecordedFrame& frame);
+
+    /**
+     * \brief Queues a frame for the writer thread and returns at once, the writer thread starts with the first frame.
+     * The image is not copied, it must not be written to afterwards.
+     * \return false if the writer is behind by the queue capacity, the frame is dropped then
+     */
+    bool post(const RecordedFrame& frame);
+
+    /**
+     * \brief Waits until all posted frames are written
+     */
+    void flush();
+
+    /**
+     * \brief Posted frames dropped because the writer was behind
+     */
+    size_t dropped() const;
+
+    /**
+     * \brief true while every write succeeded
+     */
+    bool good() const;
+
+    size_t frames() const;
+
+};
+
+/**
+ * \brief Reads a recording written by FrameRecorder.
+ * Opening indexes the records, the pixels are only read when a frame is requested.
+ */
+class FrameRecording {
+
+    struct Entry {
+        RecordedFrame meta;
+        std::streamoff offset;
+    };
+
+    mutable std::ifstream file_;
+
+    std::vector<Entry> entries_;
+
+public:
+
+    /**
+     * \brief Opens a recording and reads its index
+     * \return false if the file is missing or not a recording, a truncated last record is left out
+     */
+    bool open(const std::string& filename);
+
+    size_t size() const;
+
+    /**
+     * \brief The metadata of a frame, without the pixels
+     */
+    const RecordedFrame& meta(size_t index) const;
+
+    /**
+     * \brief Reads a frame with its pixels
+     */
+    bool read(size_t index, RecordedFrame& frame) const;
+
+};
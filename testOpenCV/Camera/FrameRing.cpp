@@ -0,0 +1,179 @@
+#include "FrameRing.h"
+#include <chrono>
+#include <cstring>
+#include "Util/HugePageAllocator.h"
+
+FrameRing::FrameRing(size_t count, unsigned long buffer_size)
+    : buffer_size_(buffer_size)
+      , handle_(nullptr)
+      , queued_(0)
+      , failed_(0)
+      , fence_frame_(0)
+      , fence_timestamp_(0)
+      , last_frame_(0)
+      , stale_(0)
+      , running_(false) {
+
+    frames_.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        auto frame = std::make_unique<tPvFrame>();
+        std::memset(frame.get(), 0, sizeof(tPvFrame));
+        frame->ImageBufferSize = buffer_size_;
+        frame->ImageBuffer = HugePageAllocator::instance()->allocate_block(buffer_size_);
+        frame->Context[0] = this;
+        frames_.emplace_back(std::move(frame));
+    }
+}
+
+FrameRing::~FrameRing() {
+    stop();
+    for (auto& frame : frames_)
+        HugePageAllocator::instance()->free_block(frame->ImageBuffer, buffer_size_);
+}
+
+void PVDECL FrameRing::frame_done(tPvFrame* frame) {
+    static_cast<FrameRing*>(frame->Context[0])->on_frame_done(frame);
+}
+
+void FrameRing::on_frame_done(tPvFrame* frame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --queued_;
+
+    if (running_ && frame->Status == ePvErrSuccess) {
+        last_frame_ = frame->FrameCount;
+        if (!fenced(frame))
+            completed_.emplace_back(frame);
+        else {
+            ++stale_;
+            queue(frame);
+        }
+    } else if (running_ && frame->Status != ePvErrCancelled) {
+        // a broken frame is not worth a round trip to the consumer
+        ++failed_;
+        queue(frame);
+    }
+
+    // notified under the lock, stop() may return and the ring be destroyed as soon as it is released
+    done_.notify_all();
+}
+
+bool FrameRing::fenced(const tPvFrame* frame) const {
+    return frame->FrameCount <= fence_frame_ || timestamp(frame) < fence_timestamp_;
+}
+
+bool FrameRing::queue(tPvFrame* frame) {
+    ++queued_;
+    if (PvCaptureQueueFrame(handle_, frame, frame_done) == ePvErrSuccess)
+        return true;
+    --queued_;
+    return false;
+}
+
+bool FrameRing::start(tPvHandle handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (running_)
+        return true;
+
+    handle_ = handle;
+    running_ = true;
+    completed_.clear();
+
+    // the frame counter and clock may restart with the acquisition
+    fence_frame_ = 0;
+    fence_timestamp_ = 0;
+    last_frame_ = 0;
+
+    auto ok = true;
+    for (auto& frame : frames_)
+        ok &= queue(frame.get());
+
+    return ok;
+}
+
+void FrameRing::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_)
+            return;
+        running_ = false;
+        completed_.clear();
+    }
+
+    // the driver calls back for every cancelled frame, possibly before this returns
+    PvCaptureQueueClear(handle_);
+
+    // the buffers are freed with the ring, so every frame has to be back before the driver lets go of it
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return queued_ == 0; });
+}
+
+bool FrameRing::running() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+tPvFrame* FrameRing::acquire(unsigned long timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!done_.wait_for(lock, std::chrono::milliseconds(timeout), [this] { return !completed_.empty() || !running_; }) || !running_)
+        return nullptr;
+
+    auto frame = completed_.front();
+    completed_.pop_front();
+    return frame;
+}
+
+void FrameRing::release(tPvFrame* frame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_)
+        queue(frame);
+}
+
+size_t FrameRing::fence(unsigned long frame, uint64_t timestamp) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    fence_frame_ = frame;
+    fence_timestamp_ = timestamp;
+
+    size_t dropped = 0;
+    for (auto it = completed_.begin(); it != completed_.end();) {
+        if (fenced(*it)) {
+            queue(*it);
+            it = completed_.erase(it);
+            ++dropped;
+        } else
+            ++it;
+    }
+
+    stale_ += dropped;
+    return dropped;
+}
+
+unsigned long FrameRing::last_frame() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_frame_;
+}
+
+size_t FrameRing::stale() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stale_;
+}
+
+uint64_t FrameRing::timestamp(const tPvFrame* frame) {
+    return static_cast<uint64_t>(frame->TimestampHi) << 32 | frame->TimestampLo;
+}
+
+size_t FrameRing::size() const {
+    return frames_.size();
+}
+
+size_t FrameRing::queued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_;
+}
+
+size_t FrameRing::failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <PvApi.h>
+
+/**
+ * \brief A ring of PvAPI frame buffers that are kept queued in the driver.
+ * All buffers are queued with a completion callback when started, the callback appends the finished frame to the
+ * completed list, and the consumer hands each frame back to the driver as soon as it has copied it.
+ * That way the camera always has buffers to fill while the previous frames are processed,
+ * instead of idling between a queue and the wait for that single frame.
+ * Frames completing with an error are handed back right away and counted as failed.
+ * After a camera setting changes, a fence makes the ring hand back the frames exposed before the change the same way,
+ * so the consumer only sees frames taken with the new settings.
+ */
+class FrameRing {
+
+    std::vector<std::unique_ptr<tPvFrame>> frames_;
+
+    // the buffer size of each frame
+    unsigned long buffer_size_;
+
+    tPvHandle handle_;
+
+    mutable std::mutex mutex_;
+
+    std::condition_variable done_;
+
+    // finished frames, oldest first
+    std::deque<tPvFrame*> completed_;
+
+    // frames owned by the driver
+    size_t queued_;
+
+    size_t failed_;
+
+    // frames up to this frame count are discarded
+    unsigned long fence_frame_;
+
+    // frames stamped before this camera time are discarded
+    uint64_t fence_timestamp_;
+
+    // frame count of the latest completed frame
+    unsigned long last_frame_;
+
+    size_t stale_;
+
+    bool running_;
+
+    /**
+     * \brief If the frame was exposed before the fence, requires the lock
+     */
+    bool fenced(const tPvFrame* frame) const;
+
+    static void PVDECL frame_done(tPvFrame* frame);
+
+    void on_frame_done(tPvFrame* frame);
+
+    /**
+     * \brief Hands a frame to the driver, requires the lock.
+     * The driver calls back from its own thread, so this never re-enters the lock.
+     */
+    bool queue(tPvFrame* frame);
+
+public:
+
+    /**
+     * \brief Allocates the buffers, nothing is queued until start()
+     * \param count The number of buffers
+     * \param buffer_size The size of each buffer, TotalBytesPerFrame of the full sensor
+     */
+    FrameRing(size_t count, unsigned long buffer_size);
+
+    ~FrameRing();
+
+    FrameRing(const FrameRing&) = delete;
+
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    /**
+     * \brief Queues all buffers, capture has to be started on the camera and acquired frames released
+     * \param handle The camera
+     * \return true if all buffers were queued
+     */
+    bool start(tPvHandle handle);
+
+    /**
+     * \brief Clears the driver queue and waits until every cancelled frame has come back,
+     * must be called before the capture is ended on the camera
+     */
+    void stop();
+
+    bool running() const;
+
+    /**
+     * \brief Waits for the oldest completed frame
+     * \param timeout The maximum wait in milliseconds
+     * \return The frame, or nullptr on timeout or when not running. Hand it back with release()
+     */
+    tPvFrame* acquire(unsigned long timeout);
+
+    /**
+     * \brief Hands an acquired frame back to the driver, or keeps it if the ring is stopped
+     */
+    void release(tPvFrame* frame);
+
+    /**
+     * \brief Discards the frames exposed before a camera setting was committed,
+     * completed ones right away and the ones still in the driver as they arrive. Cleared by start()
+     * \param frame Frames with a frame count up to this are discarded
+     * \param timestamp Frames with an earlier camera timestamp are discarded, 0 only fences by frame count
+     * \return The number of completed frames discarded right away
+     */
+    size_t fence(unsigned long frame, uint64_t timestamp);
+
+    /**
+     * \brief The frame count of the latest completed frame, 0 before the first one
+     */
+    unsigned long last_frame() const;
+
+    /**
+     * \brief The number of frames discarded by fences
+     */
+    size_t stale() const;
+
+    /**
+     * \brief The camera timestamp of a frame, in ticks of the camera clock
+     */
+    static uint64_t timestamp(const tPvFrame* frame);
+
+    size_t size() const;
+
+    size_t queued() const;
+
+    size_t failed() const;
+
+};
@@ -3,6 +3,8 @@
 #include "namespaces/filters.h"
 #include "CV/HoughLinesPR.h"
 #include "namespaces/draw.h"
+#include "Util/ChunkedVector.h"
+#include "Util/MemoryTracker.h"
 
 Seeker::Seeker()
     : current_phase_(Phase::ONE)
@@ -19,32 +21,40 @@ Seeker::Seeker(capture_roi phase_one_roi)
 
 bool Seeker::initialize() {
 
-    auto now = tg::get_now_ns();
+    auto now = tg::get_now_ms();
 
     // generate phase frameset pointers
     for (auto i = 0; i < frameset_.size(); i++)
         frameset_[i] = std::make_unique<Frames>(i);
 
-    if (pcapture == nullptr) {
-        // run the basic process for the capture object
-        pcapture = std::make_unique<CapturePvApi>();
-    } else {
-        // double check for weirdness
-        if (pcapture->is_open()) {
-            pcapture->close();
-        }
+    // nothing of the previous measurement carries over, except the camera and the exposure search
+    pdata = std::make_shared<Data<double>>();
+    std::fill(phase_roi_.begin() + 1, phase_roi_.end(), phase_roi_null_);
+    current_phase_ = Phase::ONE;
+
+    if (is_open()) {
+        // restarting discards the frames the stream still holds from the previous measurement
+        pstream->stop();
+    } else if (!open()) {
+        return false;
     }
 
-    // always perform complete re-init.
+    pstream->recorder(recorder_);
+    pstream->start();
 
-    if (pcapture == nullptr) {
-        // run the basic process for the capture object
-        pcapture = std::make_unique<CapturePvApi>();
-    } else {
-        // double check for weirdness
-        if (pcapture->is_open()) {
-            pcapture->close();
-        }
+    log_time << cv::format("Seeker initialize complete, took %lli ms.\n", tg::diff_now_ms(now));
+
+    return true;
+
+}
+
+bool Seeker::open() {
+
+    auto now = tg::get_now_ms();
+
+    // double check for weirdness
+    if (pcapture->is_open()) {
+        pcapture->close();
     }
 
     // always perform complete re-init.
@@ -62,17 +72,11 @@ bool Seeker::initialize() {
 
     if (!capture_device_ok) {
         log_err << "Capture device could not be openened, aborting.\n";
-        pcapture->initialized(false);
+        pcapture->uninitialize();
         return false;
     }
 
-    //capture->print_attr();
-
-    pcapture->pixel_format();
-
-    pcapture->reset_binning();
-
-    pcapture->packet_size(9014);
+    pcapture->prepare();
 
     auto def_roi = cv::Rect_<unsigned long>(0, 1006, 2448, 256);
 
@@ -84,14 +88,31 @@ bool Seeker::initialize() {
 
     pcapture->aquisition_init();
 
-    log_time << cv::format("Seeker initialize complete, took %i ns.\n", tg::diff_now_ns(now));
+    pstream = std::make_unique<CaptureThread>(pcapture, 32, overflow_policy_);
+
+    open_ms_ = tg::diff_now_ms(now);
+
+    log_time << cv::format("Seeker %s cold start complete, took %lli ms.\n", pcapture->name().c_str(), open_ms_);
 
     return true;
+}
+
+void Seeker::close() {
+    if (!is_open())
+        return;
 
+    pstream->stop();
+    pstream.reset();
+    pcapture->aquisition_end();
+    pcapture->cap_end();
+    pcapture->close();
+    pcapture->uninitialize();
 }
 
 double Seeker::phase_finalize() {
 
+    MemoryScope memory_scope(MemoryStage::SeekerFinalize);
+
     // alternate version for phase two, contains computation for both sides.
     // uses closest parallel match to counter misbehaviour of laser.
 
@@ -192,15 +213,7 @@ double Seeker::phase_finalize() {
     return diff;
 }
 
-bool Seeker::shut_down() const {
-    pcapture->aquisition_end();
-    pcapture->cap_end();
-    pcapture->close();
-    pcapture->uninitialize();
-    return true;
-}
-
-void Seeker::process_mat_for_line(cv::Mat& org, std::shared_ptr<HoughLinesPR>& hough, MorphR* morph) const {
+void Seeker::process_mat_for_line(const cv::Mat& org, std::shared_ptr<HoughLinesPR>& hough, MorphR* morph) const {
     pfilter->image(org);
     pfilter->do_filter();
 
@@ -242,6 +255,8 @@ void Seeker::switch_phase() {
 
 bool Seeker::phase_one() {
 
+    MemoryScope memory_scope(MemoryStage::SeekerPhaseOne);
+
     log_time << "Configuring phase one.\n";
 
     auto phase = frameset(current_phase_);
@@ -271,24 +286,23 @@ bool Seeker::phase_one() {
 
     auto failures = 0;
 
-    // clear any buffer
-    log_time << __FUNCTION__ << " clearing the buffer.\n";
-    pcapture->region(buffer_clear_roi);
-    pcapture->cap(3, targets);
-    targets.clear();
-
     // set capture region at camera level
-    pcapture->region(pcapture->default_roi);
+    pstream->region(pcapture->default_roi);
 
-    // populate exposures to check
-    std::vector<ulong> exposures;
-    for (auto i = exposure_levels->exposure_start; i <= exposure_levels->exposure_end; i += exposure_levels->exposure_increment) {
-        exposures.emplace_back(i);
-    }
+    // the exposures the search may visit
+    const ExposureRange exposure_range{exposure_levels->exposure_start, exposure_levels->exposure_end, exposure_levels->exposure_increment};
+
+    // probes and frames taken by the exposure search
+    phase_one_found_ = 0;
+    phase_one_probes_ = 0;
+    phase_one_frames_ = 0;
 
     // default amount of frames to capture to make sure there isnt anything in the camera buffer
     auto const frames_to_capture = 3;
 
+    // bit packed edges for the pepper noise removal
+    BinaryImage edges;
+
     log_time << "Running phase one.\n";
 
     auto now = tg::get_now_ms();
@@ -297,8 +311,11 @@ bool Seeker::phase_one() {
     while (running) {
         try {
 
-            // iterate through all exposure values
-            for (const auto e : exposures) {
+            // the lambdas log with the name of the phase
+            const auto function = __FUNCTION__;
+
+            // full detection at an exposure, accepts it when both borders are found
+            auto detect = [&](ulong e) {
 
                 // clear the data structures
                 markings.clear();
@@ -310,20 +327,25 @@ bool Seeker::phase_one() {
 
                 // if there was an error while switching exposure
                 // wait 150ms before skipping
-                if (!pcapture->exposure(e)) {
-                    log_err << cv::format("%s .. exposure change failed, skipping exposure value %i\n", __FUNCTION__, e);
+                if (!pstream->exposure(e)) {
+                    log_err << cv::format("%s .. exposure change failed, skipping exposure value %i\n", function, e);
                     tg::sleep(150);
-                    continue;
+                    return false;
                 }
 
                 // clear targets and capture the frames
+                ++phase_one_probes_;
                 targets.clear();
-                pcapture->cap(frames_to_capture, targets);
+                phase_one_frames_ += pstream->cap(frames_to_capture, targets);
+                if (targets.empty()) {
+                    log_err << cv::format("%s .. no frames captured at exposure %i\n", function, e);
+                    return false;
+                }
 
                 auto current_frame = targets.back();
                 //cv::imwrite("exposure" + std::to_string(e) + "_1.png", current_frame);
 
-                log_time << __FUNCTION__ << " filter processing..\n";
+                log_time << function << " filter processing..\n";
 
                 // filter the image
                 pfilter->image(current_frame);
@@ -331,7 +353,7 @@ bool Seeker::phase_one() {
 
                 //cv::imwrite("exposure" + std::to_string(e) + "_2.png", pfilter->result());
 
-                log_time << __FUNCTION__ << " canny processing..\n";
+                log_time << function << " canny processing..\n";
 
                 // perform edge detection
                 pcanny->image(pfilter->result());
@@ -340,14 +362,24 @@ bool Seeker::phase_one() {
                 auto t = pcanny->result();
                 //cv::imwrite("exposure" + std::to_string(e) + "_3.png", t);
 
-                // process edge image with houghlines
-                auto tmp = t.clone();
-                hough_vertical->original(tmp);
+                // process edge image with houghlines, the canny result is only read
+                hough_vertical->original(t);
                 hough_vertical->image(t);
 
-                log_time << __FUNCTION__ << " houghline processing..\n";
+                log_time << function << " houghline processing..\n";
+
+                // votes from the canny edges as they are, they are only packed for the pepper noise removal
+                auto hough_result = hough_vertical->hough_vertical_voting();
 
-                auto hough_result = hough_vertical->hough_vertical();
+                // retry once with the pepper noise removed if the lines on either side do not intersect
+                if (hough_result == 0 && !(hough_vertical->is_lines_intersecting(HoughLinesR::Side::Left) && hough_vertical->is_lines_intersecting(HoughLinesR::Side::Right))) {
+                    log_time << function << " removing pepper noise and retrying houghline processing..\n";
+                    edges.pack(t);
+                    edges.remove_islands(edges);
+                    edges.unpack(t);
+                    hough_vertical->image(t);
+                    hough_result = hough_vertical->hough_vertical(edges);
+                }
                 auto all = hough_vertical->all_lines();
 
                 //hough_vertical->draw_lines(all, cv::Scalar(255, 255, 255));
@@ -358,11 +390,11 @@ bool Seeker::phase_one() {
                         // everything ok
                         break;
                     case -1:
-                        log_err << __FUNCTION__ << " No lines detect.\n";
-                        continue;
+                        log_err << function << " No lines detect.\n";
+                        return false;
                     case -2:
-                        log_err << __FUNCTION__ << " No valid lines detected.\n";
-                        continue;
+                        log_err << function << " No valid lines detected.\n";
+                        return false;
                     default:
                         // nada
                         break;
@@ -371,13 +403,13 @@ bool Seeker::phase_one() {
                 // perform intersection check for left side lines
                 if (!hough_vertical->is_lines_intersecting(HoughLinesR::Side::Left)) {
                     log_err << cv::format("Phase one intersection check for left side failed (exposure = %i).\n", phase_one_exposure);
-                    continue;
+                    return false;
                 }
 
                 // perform intersection check for right side lines
                 if (!hough_vertical->is_lines_intersecting(HoughLinesR::Side::Right)) {
                     log_err << cv::format("Phase one intersection check for right side failed (exposure = %i).\n", phase_one_exposure);
-                    continue;
+                    return false;
                 }
 
                 // compute the border values from the lines
@@ -397,10 +429,28 @@ bool Seeker::phase_one() {
                     right_borders.emplace_back(hough_vertical->right_border());
                 }
 
-                // we made it through, allow loop to exit
-                running = false;
-                break;
+                // we made it through, accept the exposure
+                return true;
+            };
 
+            // cheap probe, a single frame scored on the contrast of the marking borders
+            auto score = [&](ulong e) {
+                ++phase_one_probes_;
+                if (!pstream->exposure(e))
+                    return 0.0;
+                targets.clear();
+                phase_one_frames_ += pstream->cap(1, targets);
+                return targets.empty() ? 0.0 : ExposureSearch::border_contrast(targets.back());
+            };
+
+            auto found = exposure_search_->search(exposure_range, score, detect);
+
+            log_time << cv::format("%s %s exposure search found %i after %i probes, %i frames.\n", __FUNCTION__, exposure_search_->name(), found, phase_one_probes_, static_cast<int>(phase_one_frames_));
+
+            if (found > 0) {
+                phase_one_found_ = found;
+                phase_one_exposure = found;
+                running = false;
             }
 
             log_time << cv::format("Scan complete.. took %i ms.\n", tg::diff_now_ms(now));
@@ -483,19 +533,16 @@ bool Seeker::phase_one() {
 
 bool Seeker::phase_two_left() {
 
+    MemoryScope memory_scope(MemoryStage::SeekerPhaseTwo);
+
     log_time << "Phase two configuration started..\n";
 
     switch_phase();
 
     std::vector<cv::Mat> left_frames;
 
-    // clear any buffer
-    pcapture->region(buffer_clear_roi);
-    pcapture->cap(3, left_frames);
-    left_frames.clear();
-
     // prep for next phase
-    pcapture->region(phase_roi_[1]);
+    pstream->region(phase_roi_[1]);
 
     auto phase = frameset(current_phase_);
 
@@ -511,8 +558,10 @@ bool Seeker::phase_two_left() {
     auto left_cutoff = phase_roi_[1].width / 2.0;
 
     // prepare target element structure
-    std::vector<cv::Point2f> elements;
-    elements.reserve(512);
+    ChunkedVector<cv::Point2f> elements;
+
+    // contiguous copy of the elements for the boundry computation
+    std::vector<cv::Point2f> boundry_elements;
 
     // update base exposure for this phase if it hasnt been configured earlier.
     if (phase_two_base_exposure_ == 0) {
@@ -547,13 +596,15 @@ bool Seeker::phase_two_left() {
         for (const auto exp : p2_exposures) {
 
             // adjust exposure and capture frames
-            pcapture->exposure(exp);
-            pcapture->cap(2, left_frames);
+            pstream->exposure(exp);
+            if (pstream->cap(2, left_frames) == 0) {
+                log_err << cv::format("%s no frames captured at exposure %i\n", __FUNCTION__, exp);
+                continue;
+            }
 
-            // configure structures
-            org = left_frames.back().clone();
-            auto h = org.clone();
-            hough_horizontal->original(h);
+            // configure structures, the captured frame is only read
+            org = left_frames.back();
+            hough_horizontal->original(org);
 
             // process matrix for line detection
             process_mat_for_line(org, hough_horizontal, pmorph.get());
@@ -571,7 +622,7 @@ bool Seeker::phase_two_left() {
             // copy found lines to target structure
             for (auto& line : lines) {
                 //if (line.entry_[0] > left_cutoff)                
-                stl::copy_vector(line.elements_, elements);
+                elements.append(line.elements_);
             }
 
             // check if there is enough to work with
@@ -602,12 +653,13 @@ bool Seeker::phase_two_left() {
 
     // adjust capture ROI based on found lines.
 
-    auto line_area = cv::minAreaRect(elements);
+    elements.flatten(boundry_elements);
+    auto line_area = cv::minAreaRect(boundry_elements);
     auto line_area_rect = line_area.boundingRect();
 
     log_time << __FUNCTION__ " left boundry detected : " << line_area_rect << '\n';
 
-    auto old_roi = pcapture->region();
+    auto old_roi = pstream->region();
 
     capture_roi new_roi;
 
@@ -627,17 +679,11 @@ bool Seeker::phase_two_left() {
 
     phase_roi_[1] = new_roi;
 
-    // empty the buffer
-    log_time << __FUNCTION__ << " clearing buffer..\n";
-    pcapture->region(capture_roi(1, 1, 1, 1));
-    pcapture->cap(3, left_frames);
-    left_frames.clear();
-
     // only update region, exposure should be at desired level at this point
-    pcapture->region(new_roi);
+    pstream->region(new_roi);
 
     // multiply the exposure because it's most likely pretty gloomy there
-    pcapture->exposure_mul(DEF_PHASE_TWO_MULTIPLIER);
+    pstream->exposure_mul(DEF_PHASE_TWO_MULTIPLIER);
 
     running = true;
 
@@ -655,19 +701,13 @@ bool Seeker::phase_two_left() {
         elements.clear();
         hough_horizontal->clear();
 
-        pcapture->cap(frame_count, left_frames);
+        // each frame is processed as it arrives, while the capture thread takes the next one
+        pstream->consume(frame_count, [&](const CapturedFrame& frame) {
 
-        if (left_frames.empty()) {
-            log_err << __FUNCTION__ << " fatal error, no frames were captured!\n";
-            continue;
-        }
-
-        // iterate through the captured frames, don't skip any as the buffer should be alright.
-        for (const auto& left : left_frames) {
+            left_frames.emplace_back(frame.image);
 
-            org = left.clone();
-            auto h = left.clone();
-            hough_horizontal->original(h);
+            org = frame.image;
+            hough_horizontal->original(org);
 
             process_mat_for_line(org, hough_horizontal, pmorph.get());
 
@@ -675,9 +715,14 @@ bool Seeker::phase_two_left() {
             const auto& lines = hough_horizontal->all_lines();
 
             for (const auto& line : lines) {
-                stl::copy_vector(line.elements_, elements);
+                elements.append(line.elements_);
             }
 
+        });
+
+        if (left_frames.empty()) {
+            log_err << __FUNCTION__ << " fatal error, no frames were captured!\n";
+            continue;
         }
 
         if (elements.empty()) {
@@ -685,7 +730,8 @@ bool Seeker::phase_two_left() {
             return false;
         }
 
-        auto boundry_area = cv::minAreaRect(elements);
+        elements.flatten(boundry_elements);
+        auto boundry_area = cv::minAreaRect(boundry_elements);
         auto boundry_area_rect = boundry_area.boundingRect2f();
 
         // adjust to reduce crap
@@ -732,7 +778,7 @@ bool Seeker::phase_two_left() {
     log_time << "left baseline: " << pdata->base_lines[1] << '\n';
 
     // return exposure to "normal"
-    pcapture->exposure_div(DEF_PHASE_TWO_MULTIPLIER);
+    pstream->exposure_div(DEF_PHASE_TWO_MULTIPLIER);
 
     // update the phase roi for left side
     //phase_roi<int, 1>(line_area_rect);
@@ -743,20 +789,17 @@ bool Seeker::phase_two_left() {
 
 bool Seeker::phase_two_right() {
 
+    MemoryScope memory_scope(MemoryStage::SeekerPhaseTwo);
+
     log_time << "Phase two configuration started..\n";
 
     switch_phase();
 
     std::vector<cv::Mat> right_frames;
 
-    // clear any buffer
-    pcapture->region(buffer_clear_roi);
-    pcapture->cap(3, right_frames);
-    right_frames.clear();
-
     // prep for next phase
     // TODO : Adjust for right side!
-    pcapture->region(phase_roi_[1]);
+    pstream->region(phase_roi_[1]);
 
     auto phase = frameset(current_phase_);
 
@@ -772,8 +815,10 @@ bool Seeker::phase_two_right() {
     auto right_cutoff = phase_roi_[1].width / 2.0;
 
     // prepare target element structure
-    std::vector<cv::Point2f> elements;
-    elements.reserve(512);
+    ChunkedVector<cv::Point2f> elements;
+
+    // contiguous copy of the elements for the boundry computation
+    std::vector<cv::Point2f> boundry_elements;
 
     // update base exposure for this phase if it hasnt been configured earlier.
     if (phase_two_base_exposure_ == 0) {
@@ -808,13 +853,15 @@ bool Seeker::phase_two_right() {
         for (const auto exp : p2_exposures) {
 
             // adjust exposure and capture frames
-            pcapture->exposure(exp);
-            pcapture->cap(2, right_frames);
+            pstream->exposure(exp);
+            if (pstream->cap(2, right_frames) == 0) {
+                log_err << cv::format("%s no frames captured at exposure %i\n", __FUNCTION__, exp);
+                continue;
+            }
 
-            // configure structures
-            org = right_frames.back().clone();
-            auto h = org.clone();
-            hough_horizontal->original(h);
+            // configure structures, the captured frame is only read
+            org = right_frames.back();
+            hough_horizontal->original(org);
 
             // process matrix for line detection
             process_mat_for_line(org, hough_horizontal, pmorph.get());
@@ -832,7 +879,7 @@ bool Seeker::phase_two_right() {
             // copy found lines to target structure
             for (auto& line : lines) {
                 //if (line.entry_[0] > left_cutoff)                
-                stl::copy_vector(line.elements_, elements);
+                elements.append(line.elements_);
             }
 
             // check if there is enough to work with
@@ -863,12 +910,13 @@ bool Seeker::phase_two_right() {
 
     // adjust capture ROI based on found lines.
 
-    auto line_area = cv::minAreaRect(elements);
+    elements.flatten(boundry_elements);
+    auto line_area = cv::minAreaRect(boundry_elements);
     auto line_area_rect = line_area.boundingRect();
 
     log_time << __FUNCTION__ " right boundry detected : " << line_area_rect << '\n';
 
-    auto old_roi = pcapture->region();
+    auto old_roi = pstream->region();
 
     capture_roi new_roi;
 
@@ -888,17 +936,11 @@ bool Seeker::phase_two_right() {
 
     phase_roi_[1] = new_roi;
 
-    // empty the buffer
-    log_time << __FUNCTION__ << " clearing buffer..\n";
-    pcapture->region(capture_roi(1, 1, 1, 1));
-    pcapture->cap(3, right_frames);
-    right_frames.clear();
-
     // only update region, exposure should be at desired level at this point
-    pcapture->region(new_roi);
+    pstream->region(new_roi);
 
     // multiply the exposure because it's most likely pretty gloomy there
-    pcapture->exposure_mul(DEF_PHASE_TWO_MULTIPLIER);
+    pstream->exposure_mul(DEF_PHASE_TWO_MULTIPLIER);
 
     running = true;
 
@@ -916,19 +958,13 @@ bool Seeker::phase_two_right() {
         elements.clear();
         hough_horizontal->clear();
 
-        pcapture->cap(frame_count, right_frames);
+        // each frame is processed as it arrives, while the capture thread takes the next one
+        pstream->consume(frame_count, [&](const CapturedFrame& frame) {
 
-        if (right_frames.empty()) {
-            log_err << __FUNCTION__ << " fatal error, no frames were captured!\n";
-            continue;
-        }
-
-        // iterate through the captured frames, don't skip any as the buffer should be alright.
-        for (const auto& right : right_frames) {
+            right_frames.emplace_back(frame.image);
 
-            org = right.clone();
-            auto h = right.clone();
-            hough_horizontal->original(h);
+            org = frame.image;
+            hough_horizontal->original(org);
 
             process_mat_for_line(org, hough_horizontal, pmorph.get());
 
@@ -936,9 +972,14 @@ bool Seeker::phase_two_right() {
             const auto& lines = hough_horizontal->all_lines();
 
             for (const auto& line : lines) {
-                stl::copy_vector(line.elements_, elements);
+                elements.append(line.elements_);
             }
 
+        });
+
+        if (right_frames.empty()) {
+            log_err << __FUNCTION__ << " fatal error, no frames were captured!\n";
+            continue;
         }
 
         if (elements.empty()) {
@@ -946,7 +987,8 @@ bool Seeker::phase_two_right() {
             return false;
         }
 
-        auto boundry_area = cv::minAreaRect(elements);
+        elements.flatten(boundry_elements);
+        auto boundry_area = cv::minAreaRect(boundry_elements);
         auto boundry_area_rect = boundry_area.boundingRect2f();
 
         // adjust to reduce crap
@@ -993,7 +1035,7 @@ bool Seeker::phase_two_right() {
     log_time << "right baseline: " << pdata->base_lines[3] << '\n';
 
     // return exposure to "normal"
-    pcapture->exposure_div(DEF_PHASE_TWO_MULTIPLIER);
+    pstream->exposure_div(DEF_PHASE_TWO_MULTIPLIER);
 
     // update the phase roi for right side
     //phase_roi<int, 1>(line_area_rect);
@@ -1012,13 +1054,8 @@ bool Seeker::phase_two_line() {
 
     std::vector<cv::Mat> left_frames;
 
-    // clear any buffer
-    pcapture->region(buffer_clear_roi);
-    pcapture->cap(3, left_frames);
-    left_frames.clear();
-
     // prep for next phase
-    pcapture->region(phase_roi_[1]);
+    pstream->region(phase_roi_[1]);
 
     auto phase = frameset(current_phase_);
 
@@ -1040,10 +1077,12 @@ bool Seeker::phase_two_line() {
 
 bool Seeker::phase_three() {
 
+    MemoryScope memory_scope(MemoryStage::SeekerPhaseThree);
+
     // gogo!
 
     // lower the exposure to 50%
-    pcapture->exposure(pcapture->exposure() / 2);
+    pstream->exposure_div(2);
 
     log_time << __FUNCTION__ << " configuration started.\n";
 
@@ -1062,13 +1101,7 @@ bool Seeker::phase_three() {
     std::vector<cv::Point2d> results(phase_3_roi.width);
     stl::populate_x(results, phase_3_roi.width);
 
-    // capture 3 frames quickly to empty the buffer
-    log_time << __FUNCTION__ << " clearing buffer..\n";
-    pcapture->region(buffer_clear_roi);
-    pcapture->cap(3, frames);
-    frames.clear();
-
-    pcapture->region(phase_3_roi);
+    pstream->region(phase_3_roi);
 
     const auto frame_count = 25;
 
@@ -1085,7 +1118,10 @@ bool Seeker::phase_three() {
 
     frames.clear();
 
-    pcapture->cap(frame_count, frames);
+    if (pstream->cap(frame_count, frames) < static_cast<size_t>(frame_count)) {
+        log_err << cv::format("%s only %i of %i frames captured, aborting.\n", __FUNCTION__, static_cast<int>(frames.size()), frame_count);
+        return false;
+    }
 
     while (running) {
 
@@ -1210,11 +1246,28 @@ int Seeker::frameset(Phase phase) {
     }
 }
 
+ulong Seeker::seek_exposure() {
+
+    if (!initialize())
+        return 0;
+
+    phase_one();
+
+    pstream->stop();
+
+    if (!keep_open_)
+        close();
+
+    return phase_one_found_;
+}
+
 bool Seeker::compute(bool do_null, cv::Rect_<unsigned long>& marking_rect, unsigned long p2_base_exposure) {
 
     if (!initialize())
         return false;
 
+    MemoryTracker::reset_peaks();
+
     auto phase_complete = false;
 
     // check if its a null computation, if so apply stuff
@@ -1268,18 +1321,27 @@ bool Seeker::compute(bool do_null, cv::Rect_<unsigned long>& marking_rect, unsig
         log_err << __FUNCTION__ " phase three FAILED..\n";
     }
 
-    pcapture->aquisition_end();
+    pstream->stop();
 
-    pcapture->cap_end();
+    log_time << cv::format("%s capture thread dropped %i frames, discarded %i stale frames (%i in the camera).\n", __FUNCTION__, static_cast<int>(pstream->dropped()), static_cast<int>(pstream->stale()), static_cast<int>(pcapture->stale_frames()));
 
-    pcapture->close();
+    log_time << __FUNCTION__ << " " << pcapture->name() << " capture device:\n" << pcapture->report();
 
-    pcapture->uninitialize();
+    if (recorder_) {
+        recorder_->flush();
+        log_time << cv::format("%s recorded %i frames, dropped %i the writer was behind on%s.\n", __FUNCTION__, static_cast<int>(recorder_->frames()), static_cast<int>(recorder_->dropped()), recorder_->good() ? "" : ", the recording failed");
+    }
+
+    if (!keep_open_)
+        close();
 
     auto near_height = phase_finalize();
 
     std::cout << "near_height : " << near_height << '\n';
     log_err << "near_height : " << near_height << '\n';
 
+    if (MemoryTracker::enabled())
+        log_time << "Memory usage per stage :\n" << MemoryTracker::report();
+
     return phase_complete;
 }
@@ -2,6 +2,8 @@
 #include <memory>
 #include <array>
 #include "CapturePvApi.h"
+#include "CaptureThread.h"
+#include "ExposureSearch.h"
 #include "CV/Frames.h"
 #include "CV/CannyR.h"
 #include "CV/FilterR.h"
@@ -22,8 +24,9 @@
  * 
  * Phase One - Marking rectangle search
  * --------------------------------------
- * The algorithm will auto-detect the marking rectangle by progressing frames with increasingly
- * longer exposure values, grabbing a single frame for each setting. Each frame recieved is
+ * The algorithm will auto-detect the marking rectangle by searching for an exposure where the marking
+ * borders stand out, scoring single frames on their border contrast and running the full detection
+ * only on the most promising exposures (see ExposureSearch). Each frame recieved is
  * processed through a diagonal image folding matrix before edge detection (canny) is utilized.
  * The resulting data is then processed with hough lines where it only focuses on lines within a specific
  * angle in an attempt to localize the borders of the marking.
@@ -152,7 +155,32 @@ private:
 
     ulong phase_two_base_exposure_ = 0;
 
-    std::shared_ptr<CapturePvApi> pcapture = std::make_shared<CapturePvApi>();
+    std::shared_ptr<CaptureInterface> pcapture = std::make_shared<CapturePvApi>();
+
+    // captures on its own thread while the phases run, all camera control goes through it meanwhile
+    std::unique_ptr<CaptureThread> pstream;
+
+    // keeps the camera open after a measurement, so the next one skips the cold start
+    bool keep_open_ = false;
+
+    // duration of the last cold start in ms
+    long long int open_ms_ = 0;
+
+    OverflowPolicy overflow_policy_ = OverflowPolicy::BackPressure;
+
+    // records the captured frames of every measurement if set
+    std::shared_ptr<FrameRecorder> recorder_;
+
+    // phase one exposure search, remembers the last accepted exposure between measurements
+    std::shared_ptr<ExposureSearch> exposure_search_ = std::make_shared<PredictedExposureSearch>(std::make_unique<GoldenSectionExposureSearch>());
+
+    // exposure accepted by the last phase one, 0 if the search found none
+    ulong phase_one_found_ = 0;
+
+    // probes and frames the last phase one exposure search took
+    int phase_one_probes_ = 0;
+
+    std::size_t phase_one_frames_ = 0;
 
     // common canny with default settings for detecting marking borders
     std::unique_ptr<CannyR> pcanny = std::make_unique<CannyR>(130, 200, 3, true, false, false);
@@ -161,7 +189,7 @@ private:
     std::unique_ptr<FilterR> pfilter = std::make_unique<FilterR>("Baseline filter");
 
     // morph for phase two and three
-    std::unique_ptr<MorphR> pmorph = std::make_unique<MorphR>(cv::MORPH_GRADIENT, 1, false);
+    std::unique_ptr<MorphR> pmorph = std::make_unique<MorphR>(cv::MORPH_GRADIENT, 1, false, true);
 
     std::shared_ptr<Data<double>> pdata = std::make_shared<Data<double>>();
 
@@ -181,8 +209,6 @@ private:
 
     const capture_roi phase_roi_null_ = capture_roi(0UL, 0UL, 0UL, 0UL);
 
-    const capture_roi buffer_clear_roi = capture_roi(1UL, 1UL, 1UL, 1UL);
-
     Phase current_phase_;
 
     // roi for the different phases (3)
@@ -206,8 +232,6 @@ private:
 
     Frames* current_frameset_;
 
-    bool shut_down() const;
-
 private: // internal functions
 
     template <int upper>
@@ -234,7 +258,7 @@ private: // internal functions
      * \param hough The hough extension class used
      * \param morph The morphology extenstion class used
      */
-    void process_mat_for_line(cv::Mat& org, std::shared_ptr<HoughLinesPR>& hough, MorphR* morph) const;
+    void process_mat_for_line(const cv::Mat& org, std::shared_ptr<HoughLinesPR>& hough, MorphR* morph) const;
 
     /**
      * \brief Switches phase (not used for anything atm)
@@ -256,7 +280,7 @@ private: // internal functions
     static int frameset(Phase phase);
 
     /**
-    * \brief Initializes all sekker class data members
+    * \brief Initializes all sekker class data members, and opens the camera unless it already is
     */
     bool initialize();
 
@@ -268,4 +292,100 @@ public:
 
     bool compute(bool do_null, cv::Rect_<unsigned long>& marking_rect, unsigned long p2_base_exposure);
 
+    /**
+     * \brief Runs phase one alone, the exposure search with the full marking detection.
+     * Opens the camera unless it already is, and leaves it open if keep_open is set.
+     * \return The accepted exposure, 0 if the search found none or the camera could not be opened
+     */
+    ulong seek_exposure();
+
+    /**
+     * \brief Cold start of the camera, initializes the driver, opens the camera and starts acquisition.
+     * compute() does this when the camera is not open.
+     */
+    bool open();
+
+    /**
+     * \brief Ends acquisition, closes the camera and uninitializes the driver
+     */
+    void close();
+
+    bool is_open() const {
+        return pstream != nullptr;
+    }
+
+    /**
+     * \brief If set, compute() leaves the camera open and acquiring for the next measurement
+     */
+    bool keep_open() const {
+        return keep_open_;
+    }
+
+    void keep_open(bool new_value) {
+        keep_open_ = new_value;
+    }
+
+    /**
+     * \brief Duration of the last cold start in ms
+     */
+    long long int open_ms() const {
+        return open_ms_;
+    }
+
+    OverflowPolicy overflow_policy() const {
+        return overflow_policy_;
+    }
+
+    void overflow_policy(OverflowPolicy new_policy) {
+        overflow_policy_ = new_policy;
+    }
+
+    std::shared_ptr<CaptureInterface> capture() const {
+        return pcapture;
+    }
+
+    /**
+     * \brief Replaces the capture device, only while the camera is closed
+     * \return false if the camera is open or the device is nullptr
+     */
+    bool capture(std::shared_ptr<CaptureInterface> new_capture) {
+        if (is_open() || new_capture == nullptr)
+            return false;
+        pcapture = std::move(new_capture);
+        return true;
+    }
+
+    std::shared_ptr<FrameRecorder> recorder() const {
+        return recorder_;
+    }
+
+    /**
+     * \brief Records the frames captured from the next measurement on, nullptr stops recording
+     */
+    void recorder(std::shared_ptr<FrameRecorder> new_recorder) {
+        recorder_ = std::move(new_recorder);
+    }
+
+    std::shared_ptr<ExposureSearch> exposure_search() const {
+        return exposure_search_;
+    }
+
+    void exposure_search(std::shared_ptr<ExposureSearch> new_search) {
+        exposure_search_ = std::move(new_search);
+    }
+
+    /**
+     * \brief Probes the last phase one exposure search took, scored and fully detected
+     */
+    int phase_one_probes() const {
+        return phase_one_probes_;
+    }
+
+    /**
+     * \brief Frames the last phase one exposure search captured for its probes
+     */
+    std::size_t phase_one_frames() const {
+        return phase_one_frames_;
+    }
+
 };
@@ -1,5 +1,6 @@
 #include <opencv2/opencv.hpp>
 #include <iostream>
+#include <numeric>
 
 #include "tclap/CmdLine.h"
 
@@ -17,6 +18,12 @@
 #include "Camera/Calib.h"
 #include "ArgClasses/args.h"
 #include "Camera/Seeker.h"
+#include "Camera/CaptureSource.h"
+#include "Testing/Benchmark.h"
+#include "Testing/Tuner.h"
+#include "namespaces/str.h"
+#include "Util/HugePageAllocator.h"
+#include "Util/MemoryTracker.h"
 
 using namespace tg;
 
@@ -29,6 +36,83 @@ using namespace tg;
  * -4	= Test mode exception
  */
 
+/**
+ * \brief Measures once for every line read from stdin, keeping the camera open in between.
+ * "measure" runs a regular measurement, "zero" a zero height measurement with the marking rectangle,
+ * "quit" or the end of the input ends the session. Cold starts and measurements are timed separately.
+ */
+static void run_session(std::shared_ptr<Seeker>& seeker, cv::Rect_<unsigned long>& zero_measure_mr, unsigned long phase_two_exposure) {
+
+    seeker->keep_open(true);
+
+    std::vector<long long int> cold_ms;
+    std::vector<long long int> measure_ms;
+    auto failed = 0;
+
+    std::string request;
+    while (std::getline(std::cin, request)) {
+        str::trim(request);
+
+        if (request.empty())
+            continue;
+
+        if (request == "quit")
+            break;
+
+        auto do_zero = request == "zero";
+
+        if (!do_zero && request != "measure") {
+            log_err << cv::format("Unknown session request \"%s\", expected measure, zero or quit.\n", request.c_str());
+            continue;
+        }
+
+        if (!seeker->is_open()) {
+            if (!seeker->open()) {
+                ++failed;
+                std::cout << "measurement failed : camera not available\n";
+                continue;
+            }
+            cold_ms.emplace_back(seeker->open_ms());
+        }
+
+        auto now = tg::get_now_ms();
+        auto ok = false;
+
+        try {
+            ok = seeker->compute(do_zero, zero_measure_mr, phase_two_exposure);
+        } catch (cv::Exception& e) {
+            log_err << cv::format("cv::Exception caught in session : %s\n", e.msg.c_str());
+        }
+
+        auto took = tg::diff_now_ms(now);
+
+        if (ok) {
+            measure_ms.emplace_back(took);
+        } else {
+            ++failed;
+            // the camera state is unknown, the next request starts cold
+            seeker->close();
+        }
+
+        std::cout << cv::format("measurement %s : took %lli ms\n", ok ? "ok" : "failed", took);
+    }
+
+    seeker->close();
+
+    auto mean = [](std::vector<long long int>::const_iterator first, std::vector<long long int>::const_iterator last) {
+        return first == last ? 0.0 : static_cast<double>(std::accumulate(first, last, 0LL)) / std::distance(first, last);
+    };
+
+    log_time << cv::format("Session : %i cold starts, mean %.1f ms\n", static_cast<int>(cold_ms.size()), mean(cold_ms.cbegin(), cold_ms.cend()));
+    log_time << cv::format("Session : %i measurements ok, %i failed\n", static_cast<int>(measure_ms.size()), failed);
+
+    // the first measurement still allocates the frame buffers and settles the exposure search
+    if (!measure_ms.empty()) {
+        log_time << cv::format("Session : first measurement %lli ms, warm mean %.1f ms\n",
+                               measure_ms.front(), mean(measure_ms.cbegin() + 1, measure_ms.cend()));
+    }
+}
+
 
 int main(int argc, char** argv) {
 
@@ -49,16 +133,37 @@ int main(int argc, char** argv) {
             }
         }
 
+        HugePageAllocator::instance()->enabled(options->huge_pages());
+
+        // counts the heap and the matrix buffers of each stage, frame buffers keep their own allocator
+        if (options->track_memory()) {
+            MemoryTracker::enabled(true);
+            cv::Mat::setDefaultAllocator(MemoryTracker::mat_allocator());
+        }
+
         auto thickness_gauge = std::make_unique<ThicknessGauge>(options->frames(), options->show_windows(), options->record_video(), 100, 100);
 
         //thicknessGauge->setFrameCount(options.getFrames());
         //thicknessGauge->setShowWindows(options.isShowWindows());
         //thicknessGauge->setSaveVideo(options.isRecordVideo());
         thickness_gauge->init_calibration_settings(options->camera_file());
+        thickness_gauge->stack_frames(options->stack_frames());
         cv::setNumThreads(options->num_open_cv_threads());
 
+        // the capture device of the glob and demo modes, a source that can not be created ends the run
+        auto make_capture = [&options]() {
+            auto capture = capture_source(options->capture());
+            if (capture == nullptr)
+                log_err << cv::format("Capture source %s could not be created.\n", options->capture().c_str());
+            return capture;
+        };
+
         if (options->glob_mode()) {
-            // TODO : use capture for file reading?!
+            auto capture = make_capture();
+            if (capture == nullptr)
+                return -1;
+            thickness_gauge->capture(capture);
+
             thickness_gauge->init_video_capture();
             auto glob_name = options->glob_folder();
             thickness_gauge->glob_generate(glob_name);
@@ -68,6 +173,17 @@ int main(int argc, char** argv) {
 
             auto seeker = std::make_shared<Seeker>();
 
+            if (!options->record_frames().empty())
+                seeker->recorder(std::make_shared<FrameRecorder>(options->record_frames()));
+
+            auto capture = make_capture();
+            if (capture == nullptr)
+                return -1;
+
+            // the seeker and the frame sets read from the same device, never at the same time
+            seeker->capture(capture);
+            thickness_gauge->capture(capture);
+
             /* **********************************************************
              * To measure zero height, perform a regular height measure,
              * remove the thing that was measured, then input the resulting
@@ -94,7 +210,11 @@ int main(int argc, char** argv) {
             unsigned long phase_two_exposure = 10000;
 
             //// determin camera or file storage
-            if (glob_name == "camera") {
+            if (glob_name == "camera" && options->session()) {
+
+                run_session(seeker, zero_measure_mr, phase_two_exposure);
+
+            } else if (glob_name == "camera") {
 
                 while (true) {
                     try {
@@ -118,6 +238,17 @@ int main(int argc, char** argv) {
 
             } else {
 
+                // the hand-set defaults are used unless a settings file is given
+                if (!options->settings_file().empty()) {
+                    ThicknessGaugeSettings settings;
+                    if (!settings.load(options->settings_file())) {
+                        log_err << cv::format("Settings file %s could not be loaded or holds invalid settings.\n", options->settings_file().c_str());
+                        return -1;
+                    }
+                    log_time << "Loaded settings : " << settings << '\n';
+                    thickness_gauge->settings(settings);
+                }
+
                 thickness_gauge->glob_add_nulls();
 
                 while (true) {
@@ -146,8 +277,10 @@ int main(int argc, char** argv) {
             Calib calib;
             calib.run_calib();
         } else if (options->test_mode()) {
-            //c.initVideoCapture();
-            //c.testAggressive();
+            if (options->test_suite() == "tune")
+                tuner::run(str::split(options->glob_folder(), ','), options->settings_file().empty() ? "settings.yml" : options->settings_file(), options->tune_samples());
+            else
+                benchmark::run(options->test_suite());
         }
     } catch
     (TCLAP::ArgException& ae) {
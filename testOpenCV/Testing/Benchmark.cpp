@@ -0,0 +1,350 @@
+//          Copyright Rudy Alex Kohn 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "Benchmark.h"
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include "namespaces/tg.h"
+#include "namespaces/calc.h"
+#include "namespaces/filters.h"
+#include "namespaces/stl.h"
+#include "CV/BinaryImage.h"
+#include "CV/HoughLinesR.h"
+#include "Camera/CaptureSimulated.h"
+#include "Camera/CaptureSource.h"
+#include "Camera/CaptureThread.h"
+#include "Camera/FrameRecording.h"
+#include "Camera/ExposureSearch.h"
+#include "Camera/Seeker.h"
+#include "Util/ChunkedVector.h"
+#include "Exceptions/TestException.h"
+
+namespace benchmark {
+
+    using namespace tg;
+
+    namespace {
+
+        const std::map<std::string, std::function<void()>> suites = {
+            { "box_filter", box_filter },
+            { "binary_edges", binary_edges },
+            { "point_accumulation", point_accumulation },
+            { "exposure_search", exposure_search },
+            { "simulated_camera", simulated_camera },
+            { "capture_backends", capture_backends }
+        };
+
+        /**
+         * \brief Runs a function a number of times
+         * \return The average time per run in ms
+         */
+        double time_ms(const std::function<void()>& func, int runs) {
+            auto start = cv::getTickCount();
+            for (auto i = 0; i < runs; i++)
+                func();
+            auto ticks = static_cast<double>(cv::getTickCount() - start);
+            return ticks / cv::getTickFrequency() * 1000.0 / runs;
+        }
+
+    }
+
+    void run(const std::string& suite) {
+        if (suite == "default") {
+            for (auto& s : suites) {
+                log_time << cv::format("benchmark: %s\n", s.first.c_str());
+                s.second();
+            }
+            return;
+        }
+
+        auto it = suites.find(suite);
+        if (it == suites.end())
+            throw TestException("Unknown benchmark suite : " + suite);
+
+        log_time << cv::format("benchmark: %s\n", suite.c_str());
+        it->second();
+    }
+
+    void box_filter() {
+        const auto runs = 20;
+
+        // same size as the marking area of the camera
+        cv::Mat image(256, 2448, CV_8UC1);
+        cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+
+        cv::Mat direct;
+        cv::Mat box;
+
+        for (auto size = 3; size <= 31; size += 2) {
+            auto scale = 1.0 / (size * size);
+            cv::Mat kernel = cv::Mat::ones(size, size, CV_32F) * scale;
+
+            auto direct_ms = time_ms([&]() { cv::filter2D(image, direct, -1, kernel); }, runs);
+            auto box_ms = time_ms([&]() { filters::box_filter(image, box, -1, kernel.size(), cv::Point(-1, -1), scale, 0.0, cv::BORDER_DEFAULT); }, runs);
+
+            cv::Mat diff;
+            cv::absdiff(direct, box, diff);
+            double max_diff;
+            cv::minMaxLoc(diff, nullptr, &max_diff);
+
+            log_time << cv::format("%2ix%2i filter2D: %7.3f ms, box: %7.3f ms, speedup: %5.2f, max diff: %.0f\n", size, size, direct_ms, box_ms, direct_ms / box_ms, max_diff);
+        }
+    }
+
+    void binary_edges() {
+        const auto runs = 20;
+
+        // sparse edges with two vertical marking borders, similar to the canny output
+        cv::Mat edges(256, 2448, CV_8UC1);
+        cv::randu(edges, cv::Scalar::all(0), cv::Scalar::all(255));
+        cv::threshold(edges, edges, 250, 255, cv::THRESH_BINARY);
+        cv::line(edges, cv::Point(800, 0), cv::Point(805, 255), cv::Scalar::all(255));
+        cv::line(edges, cv::Point(1600, 0), cv::Point(1595, 255), cv::Scalar::all(255));
+
+        BinaryImage packed;
+        BinaryImage packed_result;
+        cv::Mat result;
+        cv::Mat unpacked;
+
+        auto element = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+
+        auto morph_ms = time_ms([&]() { cv::morphologyEx(edges, result, cv::MORPH_GRADIENT, element); }, runs);
+        auto pack_ms = time_ms([&]() { packed.pack(edges); }, runs);
+        auto gradient_ms = time_ms([&]() { packed.gradient(packed_result, 1); }, runs);
+        auto unpack_ms = time_ms([&]() { packed_result.unpack(unpacked); }, runs);
+
+        log_time << cv::format("gradient morphologyEx: %7.3f ms, packed: %7.3f ms (pack %7.3f ms, unpack %7.3f ms), equal: %s\n",
+                               morph_ms, gradient_ms, pack_ms, unpack_ms, cv::countNonZero(result != unpacked) == 0 ? "yes" : "no");
+
+        HoughLinesR hough(1, static_cast<const int>(calc::DEGREES), 40, false);
+        hough.angle_limit(30);
+        hough.image(edges);
+
+        size_t direct_count = 0;
+        size_t packed_count = 0;
+        size_t byte_count = 0;
+
+        auto direct_ms = time_ms([&]() {
+            direct_count = hough.hough_vertical() == 0 ? hough.all_lines().size() : 0;
+        }, runs);
+
+        auto voting_ms = time_ms([&]() {
+            packed_count = hough.hough_vertical(packed) == 0 ? hough.all_lines().size() : 0;
+        }, runs);
+
+        auto byte_ms = time_ms([&]() {
+            byte_count = hough.hough_vertical_voting() == 0 ? hough.all_lines().size() : 0;
+        }, runs);
+
+        log_time << cv::format("hough vertical HoughLines: %7.3f ms (%i vertical lines), packed voting: %7.3f ms (%i vertical lines), byte voting: %7.3f ms (%i vertical lines)\n",
+                               direct_ms, static_cast<int>(direct_count), voting_ms, static_cast<int>(packed_count), byte_ms, static_cast<int>(byte_count));
+    }
+
+    void point_accumulation() {
+        const auto runs = 5;
+
+        // about the length of a horizontal base line element vector
+        const auto line_length = 200;
+
+        std::vector<cv::Point2f> line(line_length);
+        for (auto i = 0; i < line_length; i++)
+            line[i] = cv::Point2f(static_cast<float>(i), 10.0f);
+
+        std::vector<cv::Point2f> vector_elements;
+        ChunkedVector<cv::Point2f> chunked_elements;
+        std::vector<cv::Point2f> flat;
+
+        for (auto lines = 64; lines <= 4096; lines *= 2) {
+            auto vector_ms = time_ms([&]() {
+                vector_elements.clear();
+                for (auto i = 0; i < lines; i++)
+                    stl::copy_vector(line, vector_elements);
+            }, runs);
+
+            auto chunked_ms = time_ms([&]() {
+                chunked_elements.clear();
+                for (auto i = 0; i < lines; i++)
+                    chunked_elements.append(line);
+                chunked_elements.flatten(flat);
+            }, runs);
+
+            auto points = static_cast<double>(lines) * line_length;
+
+            log_time << cv::format("%4i lines copy_vector: %9.3f ms (%6.2f ns/point), chunked + flatten: %7.3f ms (%5.2f ns/point), equal size: %s\n",
+                                   lines, vector_ms, vector_ms * 1e6 / points, chunked_ms, chunked_ms * 1e6 / points,
+                                   vector_elements.size() == flat.size() ? "yes" : "no");
+        }
+    }
+
+    void exposure_search() {
+        const auto seeks = 10;
+
+        // the simulated camera carries the marking and the laser, phase one runs its full detection on it
+        SimulatedScene scene;
+        auto capture = std::make_shared<CaptureSimulated>(scene);
+
+        auto predicted = std::make_shared<PredictedExposureSearch>(std::make_unique<GoldenSectionExposureSearch>());
+
+        const std::vector<std::shared_ptr<ExposureSearch>> searches = {
+            std::make_shared<LinearExposureSearch>(),
+            std::make_shared<GoldenSectionExposureSearch>(),
+            predicted
+        };
+
+        for (auto& search : searches) {
+            auto seeker = std::make_shared<Seeker>();
+            seeker->capture(capture);
+            seeker->exposure_search(search);
+            seeker->keep_open(true);
+
+            auto probes = 0;
+            std::size_t frames = 0;
+            auto failed = 0;
+
+            predicted->last(0);
+
+            auto ms = time_ms([&]() {
+                for (auto i = 0; i < seeks; i++) {
+                    // the light drifts slowly over the day with a cloud passing now and then
+                    scene.light = 1.0 + 0.5 * std::sin(i * 0.5) - (i % 4 == 3 ? 0.2 : 0.0);
+                    capture->scene(scene);
+                    if (seeker->seek_exposure() == 0)
+                        ++failed;
+                    probes += seeker->phase_one_probes();
+                    frames += seeker->phase_one_frames();
+                }
+            }, 1);
+
+            seeker->close();
+
+            log_time << cv::format("%-15s: %5.2f probes, %6.2f frames captured per seek, %i of %i failed, %8.3f ms per seek\n",
+                                   search->name(), static_cast<double>(probes) / seeks, static_cast<double>(frames) / seeks, failed, seeks, ms / seeks);
+        }
+    }
+
+    void simulated_camera() {
+        const auto frames = 25;
+
+        // road to the left of the marking, and the inner part of the marking, away from the blurred borders
+        const cv::Range road(100, 700);
+        const cv::Range marking(900, 1500);
+
+        SimulatedScene scene;
+        scene.laser_tilt = 0.002;
+
+        CaptureSimulated capture(scene);
+        capture.exposure(5000);
+
+        std::vector<cv::Mat> images;
+        std::vector<cv::Point2d> points;
+        cv::Mat laser;
+
+        // row of the laser line in a part of the frame, the background below the laser is cut away first
+        auto laser_row = [&](const cv::Mat& frame, const cv::Range& cols) {
+            cv::threshold(frame.colRange(cols), laser, 0, 255, cv::THRESH_TOZERO | cv::THRESH_OTSU);
+            return calc::real_intensity_line(laser, points);
+        };
+
+        for (auto height = 2.0; height <= 10.0; height += 2.0) {
+            scene.marking_height = height;
+            capture.scene(scene);
+
+            images.clear();
+            auto render_ms = time_ms([&]() { capture.cap(frames, images); }, 1);
+
+            auto error = 0.0;
+            auto worst = 0.0;
+
+            auto measure_ms = time_ms([&]() {
+                for (auto& frame : images) {
+                    // the tilt moves the line between the centers of the two parts as well
+                    auto measured = laser_row(frame, road) - laser_row(frame, marking);
+                    auto expected = capture.truth().height + scene.laser_tilt * ((road.start + road.end) - (marking.start + marking.end)) / 2.0;
+                    error += std::abs(measured - expected);
+                    worst = std::max(worst, std::abs(measured - expected));
+                }
+            }, 1);
+
+            log_time << cv::format("height %4.1f rows: mean error %6.3f rows, worst %6.3f rows, render %6.2f ms/frame, measure %6.2f ms/frame, camera %5.2f fps\n",
+                                   height, error / frames, worst, render_ms / frames, measure_ms / frames,
+                                   capture.frame_count() * 1e6 / capture.timestamp());
+        }
+    }
+
+
+    void capture_backends() {
+        const auto frames = 100;
+        const std::string recording = "capture_backends.tgf";
+        const std::string sequence = "capture_backends_%03d.png";
+
+        // the direct captures and the capture thread each take their frames, and the thread reads ahead into its ring
+        const auto recorded = 3 * frames;
+
+        // the simulated frames are written as a recording and as an image sequence, so every backend serves the same scene
+        {
+            CaptureSimulated capture;
+            FrameRecorder recorder(recording);
+            RecordedFrame frame;
+
+            for (auto i = 0; i < recorded; i++) {
+                frame.roi = capture.region();
+                frame.exposure = capture.exposure();
+                frame.gain = capture.gain();
+                capture.cap_single(frame.image, frame.roi, 100, frame.frame_id, frame.timestamp);
+                recorder.write(frame);
+                cv::imwrite(cv::format(sequence.c_str(), i), frame.image);
+            }
+        }
+
+        const std::vector<std::shared_ptr<CaptureInterface>> backends = {
+            std::make_shared<CaptureSimulated>(),
+            capture_source("replay:" + recording),
+            capture_source("opencv:" + sequence)
+        };
+
+        for (auto& capture : backends) {
+            if (capture == nullptr || !capture->initialize() || !capture->open()) {
+                log_err << "capture_backends: a backend could not be opened.\n";
+                continue;
+            }
+
+            capture->prepare();
+            capture->region(capture->default_roi);
+            capture->frame_init();
+            capture->cap_init();
+            capture->aquisition_init();
+
+            cv::Mat frame;
+            auto direct_ms = time_ms([&]() { capture->cap_single(frame); }, frames);
+
+            size_t taken = 0;
+            auto threaded_ms = 0.0;
+
+            {
+                CaptureThread stream(capture, 32, OverflowPolicy::BackPressure);
+                stream.start();
+                threaded_ms = time_ms([&]() { taken = stream.consume(frames, [](const CapturedFrame&) {}); }, 1);
+                stream.stop();
+            }
+
+            capture->aquisition_end();
+            capture->cap_end();
+            capture->close();
+            capture->uninitialize();
+
+            log_time << cv::format("%-9s: direct %6.3f ms/frame, capture thread %6.3f ms/frame over %i frames, %s",
+                                   capture->name().c_str(), direct_ms, threaded_ms / std::max(taken, size_t(1)), static_cast<int>(taken), capture->report().c_str());
+        }
+
+        std::remove(recording.c_str());
+        for (auto i = 0; i < recorded; i++)
+            std::remove(cv::format(sequence.c_str(), i).c_str());
+    }
+
+}
@@ -0,0 +1,54 @@
+//          Copyright Rudy Alex Kohn 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#include <string>
+
+/**
+ * \brief Micro benchmarks for the processing pipeline, selected with --test_suite in test mode (-t)
+ */
+namespace benchmark {
+
+    /**
+     * \brief Runs a benchmark suite, "default" runs all of them
+     * \param suite The name of the suite
+     * \throws TestException if the suite is unknown
+     */
+    void run(const std::string& suite);
+
+    /**
+     * \brief Compares filter2D against the running sum box filter for kernel sizes 3 to 31
+     */
+    void box_filter();
+
+    /**
+     * \brief Compares byte and bit packed morphological gradient and hough voting on a synthetic edge image
+     */
+    void binary_edges();
+
+    /**
+     * \brief Compares accumulating line elements with stl::copy_vector against ChunkedVector for growing line counts
+     */
+    void point_accumulation();
+
+    /**
+     * \brief Compares the probes and frames per phase one exposure search of the linear, golden section and predicted searches,
+     * running the seeker's full marking detection on the simulated camera under slowly changing light
+     */
+    void exposure_search();
+
+    /**
+     * \brief Measures the laser line height on frames of the simulated camera against the ground truth,
+     * with the time to render and to measure a frame
+     */
+    void simulated_camera();
+
+    /**
+     * \brief Compares the simulated, replay and OpenCV image sequence backends serving the same simulated frames,
+     * captured directly and through the capture thread
+     */
+    void capture_backends();
+
+}
@@ -0,0 +1,207 @@
+//          Copyright Rudy Alex Kohn 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "Tuner.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <opencv2/core.hpp>
+#include "ThicknessGauge.h"
+#include "namespaces/tg.h"
+#include "Exceptions/TestException.h"
+
+namespace tuner {
+
+    using namespace tg;
+
+    namespace {
+
+        /**
+         * \brief A tunable setting and the values to try for it
+         */
+        struct Axis {
+            int ThicknessGaugeSettings::* member;
+            std::vector<int> values;
+        };
+
+        // the values are centered on the hand-set defaults, canny threshold 1 is always below threshold 2
+        const std::vector<Axis> axes = {
+            { &ThicknessGaugeSettings::marking_canny_threshold_1, { 100, 130, 160 } },
+            { &ThicknessGaugeSettings::marking_canny_threshold_2, { 170, 200, 230 } },
+            { &ThicknessGaugeSettings::baseline_canny_threshold_1, { 170, 200 } },
+            { &ThicknessGaugeSettings::baseline_canny_threshold_2, { 220, 250 } },
+            { &ThicknessGaugeSettings::hough_threshold, { 30, 40, 50 } },
+            { &ThicknessGaugeSettings::hough_angle_limit, { 20, 30 } },
+            { &ThicknessGaugeSettings::binary_threshold, { 80, 100, 120 } },
+            { &ThicknessGaugeSettings::bilateral_diameter, { 3, 5 } },
+            { &ThicknessGaugeSettings::gaussian_size, { 3, 5, 7 } }
+        };
+
+        // fixed, so runs with the same sample count try the same settings
+        const unsigned int seed = 0x5eed;
+
+        /**
+         * \brief Decodes a grid index, the first axis changes fastest
+         */
+        ThicknessGaugeSettings grid_point(size_t index) {
+            ThicknessGaugeSettings settings;
+            for (auto& axis : axes) {
+                settings.*axis.member = axis.values[index % axis.values.size()];
+                index /= axis.values.size();
+            }
+            return settings;
+        }
+
+        /**
+         * \brief Runs the measurement for all globs with the settings
+         * \return true if all globs were measured, otherwise false
+         */
+        bool evaluate(const ThicknessGaugeSettings& settings, const std::vector<std::string>& globs, Score& score) {
+            std::vector<double> heights;
+            heights.reserve(globs.size());
+
+            auto runtime = 0.0;
+
+            for (auto glob : globs) {
+                try {
+                    auto gauge = std::make_unique<ThicknessGauge>(25, false, false, settings.binary_threshold, 100);
+                    gauge->settings(settings);
+
+                    if (!gauge->initialize(glob) || !gauge->compute_marking_height(1))
+                        return false;
+
+                    heights.emplace_back(gauge->pdata->difference);
+                    runtime += gauge->frame_time();
+                } catch (cv::Exception& e) {
+                    log_err << cv::format("tuner: %s failed.\n%s\n", glob.c_str(), e.msg.c_str());
+                    return false;
+                } catch (std::exception& e) {
+                    log_err << cv::format("tuner: %s failed.\n%s\n", glob.c_str(), e.what());
+                    return false;
+                }
+            }
+
+            cv::Scalar mean;
+            cv::Scalar deviation;
+            cv::meanStdDev(heights, mean, deviation);
+
+            score.settings = settings;
+            score.runtime = runtime / globs.size();
+            score.deviation = deviation[0];
+            score.mean = mean[0];
+            return true;
+        }
+
+        void write(cv::FileStorage& fs, const Score& score) {
+            fs << "{"
+                << "runtime" << score.runtime
+                << "deviation" << score.deviation
+                << "mean" << score.mean
+                << "settings";
+            score.settings.write(fs);
+            fs << "}";
+        }
+
+    }
+
+    std::vector<ThicknessGaugeSettings> candidates(int samples) {
+        size_t grid_size = 1;
+        for (auto& axis : axes)
+            grid_size *= axis.values.size();
+
+        std::vector<size_t> indices(grid_size);
+        std::iota(indices.begin(), indices.end(), 0);
+
+        if (samples > 0 && static_cast<size_t>(samples) < grid_size) {
+            std::mt19937 rng(seed);
+            std::shuffle(indices.begin(), indices.end(), rng);
+            indices.resize(samples);
+        }
+
+        std::vector<ThicknessGaugeSettings> output;
+        output.reserve(indices.size());
+        for (auto index : indices)
+            output.emplace_back(grid_point(index));
+
+        return output;
+    }
+
+    std::vector<Score> pareto_front(const std::vector<Score>& scores) {
+        auto sorted = scores;
+        std::sort(sorted.begin(), sorted.end(), [](const Score& a, const Score& b) {
+            return a.runtime < b.runtime || (a.runtime == b.runtime && a.deviation < b.deviation);
+        });
+
+        // going from fast to slow, a configuration is only kept if it is more repeatable than all faster ones
+        std::vector<Score> front;
+        for (auto& s : sorted) {
+            if (front.empty() || s.deviation < front.back().deviation)
+                front.emplace_back(s);
+        }
+
+        std::sort(front.begin(), front.end(), [](const Score& a, const Score& b) {
+            return a.deviation < b.deviation;
+        });
+
+        return front;
+    }
+
+    void run(const std::vector<std::string>& globs, const std::string& output_file, int samples) {
+        if (globs.empty())
+            throw TestException("No globs to tune against, use --glob_name=a,b,c");
+
+        if (std::find(globs.begin(), globs.end(), "camera") != globs.end())
+            throw TestException("The tuner only replays recorded globs, not the camera.");
+
+        if (globs.size() < 2)
+            log_err << "tuner: only one glob, the repeatability of all settings is 0.\n";
+
+        auto settings = candidates(samples);
+
+        log_time << cv::format("tuner: %i settings against %i globs\n", static_cast<int>(settings.size()), static_cast<int>(globs.size()));
+
+        std::vector<Score> scores;
+        scores.reserve(settings.size());
+
+        for (size_t i = 0; i < settings.size(); i++) {
+            Score score;
+            if (!evaluate(settings[i], globs, score)) {
+                log_err << "tuner: rejected " << settings[i] << '\n';
+                continue;
+            }
+
+            log_time << cv::format("tuner: %i/%i runtime: %.4f s, deviation: %.4f, mean: %.4f\n",
+                                   static_cast<int>(i + 1), static_cast<int>(settings.size()), score.runtime, score.deviation, score.mean);
+            scores.emplace_back(score);
+        }
+
+        if (scores.empty())
+            throw TestException("No settings could measure all globs.");
+
+        auto front = pareto_front(scores);
+
+        cv::FileStorage fs(output_file, cv::FileStorage::WRITE);
+        if (!fs.isOpened())
+            throw TestException("Unable to write settings file : " + output_file);
+
+        fs << "globs" << "[";
+        for (auto& glob : globs)
+            fs << glob;
+        fs << "]";
+
+        fs << "front" << "[";
+        for (auto& s : front)
+            write(fs, s);
+        fs << "]";
+
+        fs.release();
+
+        log_ok << cv::format("tuner: %i of %i settings on the pareto front, written to %s\n",
+                             static_cast<int>(front.size()), static_cast<int>(scores.size()), output_file.c_str());
+        for (auto& s : front)
+            log_ok << cv::format("runtime: %.4f s, deviation: %.4f : ", s.runtime, s.deviation) << s.settings << '\n';
+    }
+
+}
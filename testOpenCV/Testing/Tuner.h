@@ -0,0 +1,57 @@
+//          Copyright Rudy Alex Kohn 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#include <string>
+#include <vector>
+#include "ThicknessGaugeSettings.h"
+
+/**
+ * \brief Offline parameter tuning, replays recorded globs through ThicknessGauge::compute_marking_height()
+ * for a set of settings and keeps the ones that are not beaten on both runtime and repeatability.
+ * Selected with --test_suite=tune in test mode (-t).
+ */
+namespace tuner {
+
+    /**
+     * \brief The outcome of one configuration over all globs
+     */
+    struct Score {
+        ThicknessGaugeSettings settings;
+
+        // average compute time per glob in seconds
+        double runtime;
+
+        // standard deviation of the measured height over the globs, in pixels
+        double deviation;
+
+        // mean measured height over the globs, in pixels
+        double mean;
+    };
+
+    /**
+     * \brief Generates the candidate settings, the full grid or a random subset of it
+     * \param samples The number of random samples, 0 or more than the grid size uses the full grid
+     * \return The settings to try
+     */
+    std::vector<ThicknessGaugeSettings> candidates(int samples);
+
+    /**
+     * \brief Extracts the configurations where no other configuration is both faster and more repeatable
+     * \param scores The scores of all configurations
+     * \return The pareto front, ordered by deviation
+     */
+    std::vector<Score> pareto_front(const std::vector<Score>& scores);
+
+    /**
+     * \brief Scores the candidates against the globs and writes the pareto front as a settings file
+     * \param globs The glob names, each a recording of the same marking
+     * \param output_file The settings file to write, readable with ThicknessGaugeSettings::load()
+     * \param samples The number of random samples, 0 uses the full grid
+     * \throws TestException if no globs are given or no configuration succeeds
+     */
+    void run(const std::vector<std::string>& globs, const std::string& output_file, int samples);
+
+}
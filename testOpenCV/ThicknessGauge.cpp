@@ -32,10 +32,38 @@
 #include "namespaces/validate.h"
 #include "namespaces/cvr.h"
 #include "namespaces/draw.h"
-#include <future>
+#include "Util/ChunkedVector.h"
+#include "Util/MemoryTracker.h"
+#include <functional>
 
 using namespace tg;
 
+namespace {
+
+    /**
+     * \brief Runs a function over the ranges cv::parallel_for_ hands out, each range on one of the OpenCV worker threads
+     */
+    class RangeBody : public cv::ParallelLoopBody {
+
+        const std::function<void(const cv::Range&)>& body_;
+
+    public:
+
+        explicit RangeBody(const std::function<void(const cv::Range&)>& body)
+            : body_(body) { }
+
+        void operator()(const cv::Range& range) const override {
+            body_(range);
+        }
+    };
+
+}
+
+#ifdef TG_HEADLESS
+// passed by reference to make_shared, which needs a definition
+constexpr bool ThicknessGauge::show_windows_;
+#endif
+
 /**
  * \brief Initializes the class and loads any aditional information
  * \param glob_name if "camera", use camera, otherwise load from glob folder
@@ -47,71 +75,90 @@ bool ThicknessGauge::initialize(std::string& glob_name) {
     // determin where to get the frames from.
     if (glob_name == "camera") {
 
-        if (pcapture == nullptr) {
-            // run the basic process for the capture object
-            pcapture = std::make_unique<CapturePvApi>();
-        } else {
-            // double check for weirdness
-            if (pcapture->is_open()) {
-                pcapture->close();
-            }
-        }
+        if (!open_capture())
+            return false;
 
-        // always perform complete re-init.
+        auto def_roi = cv::Rect_<unsigned long>(0, 1006, 2448, 256);
 
-        auto capture_device_ok = pcapture->initialize();
+        pcapture->region(def_roi);
 
-        if (!capture_device_ok) {
-            log_err << "Capture device could not be initialized, aborting.\n";
-            return false;
-        }
+        start_acquisition();
 
-        //initVideoCapture(); // for opencv capture object
+        for (auto& fs : frameset_) {
+            pcapture->exposure(fs->exp_ms_);
+            pcapture->cap(25, fs->edit_frames());
+            if (stack_frames_)
+                fs->stack();
+        }
 
-        capture_device_ok = pcapture->open();
+        close_capture();
 
-        if (!capture_device_ok) {
-            log_err << "Capture device could not be openened, aborting.\n";
-            pcapture->initialized(false);
-            return false;
-        }
+        //captureFrames(0, frameCount_, 5000);
+    } else
+        glob_load(glob_name);
 
-        //capture->print_attr();
+    return true;
+}
 
-        pcapture->pixel_format();
+/**
+ * \brief Opens the capture device, the PvAPI camera unless another one was set with capture()
+ * \return true if the device is open, otherwise false and the device is left uninitialized
+ */
+bool ThicknessGauge::open_capture() {
+    if (pcapture == nullptr) {
+        // run the basic process for the capture object
+        pcapture = std::make_shared<CapturePvApi>();
+    } else {
+        // double check for weirdness
+        if (pcapture->is_open()) {
+            pcapture->close();
+        }
+    }
 
-        pcapture->reset_binning();
+    // always perform complete re-init.
 
-        pcapture->packet_size(8228);
+    auto capture_device_ok = pcapture->initialize();
 
-        auto def_roi = cv::Rect_<unsigned long>(0, 1006, 2448, 256);
+    if (!capture_device_ok) {
+        log_err << "Capture device could not be initialized, aborting.\n";
+        return false;
+    }
 
-        pcapture->region(def_roi);
+    capture_device_ok = pcapture->open();
 
-        pcapture->frame_init();
+    if (!capture_device_ok) {
+        log_err << "Capture device could not be openened, aborting.\n";
+        pcapture->uninitialize();
+        return false;
+    }
 
-        pcapture->cap_init();
+    pcapture->prepare();
 
-        pcapture->aquisition_init();
+    return true;
+}
 
-        for (auto& fs : frameset_) {
-            pcapture->exposure(fs->exp_ms_);
-            pcapture->cap(25, fs->frames_);
-        }
+/**
+ * \brief Starts the acquisition of the open capture device, with the region it currently has
+ */
+void ThicknessGauge::start_acquisition() const {
+    pcapture->frame_init();
 
-        pcapture->aquisition_end();
+    pcapture->cap_init();
 
-        pcapture->cap_end();
+    pcapture->aquisition_init();
+}
 
-        pcapture->close();
+/**
+ * \brief Ends the acquisition and closes the capture device
+ */
+void ThicknessGauge::close_capture() const {
+    pcapture->aquisition_end();
 
-        pcapture->uninitialize();
+    pcapture->cap_end();
 
-        //captureFrames(0, frameCount_, 5000);
-    } else
-        glob_load(glob_name);
+    pcapture->close();
 
-    return true;
+    pcapture->uninitialize();
 }
 
 /**
@@ -158,16 +205,20 @@ void ThicknessGauge::glob_generate(std::string& name) {
 
     cv::Mat t;
 
-    cv::VideoCapture cap;
-    cap.open(CV_CAP_PVAPI);
+    // the glob keeps the region the device has
+    if (!open_capture())
+        return;
+
+    start_acquisition();
 
     unsigned long progress = 0;
     for (auto i = 0; i < frame_count_; ++i) {
         pb.progressed(++progress);
-        cap >> t;
+        pcapture->cap_single(t);
         cv::imwrite(name + "/img" + to_string(i) + ".png", t);
     }
-    cap.release();
+
+    close_capture();
     pb.progressed(frame_count_);
 }
 
@@ -175,13 +226,33 @@ void ThicknessGauge::glob_generate(std::string& name) {
  * \brief Determins the marking boundries
  * \return 2 Float vector with the points marking the boundries as pair, where first = left, second = right
  */
-void ThicknessGauge::compute_marking_height() {
+bool ThicknessGauge::compute_marking_height(int max_attempts) {
 
-    // test print for all framesets
-    for (auto& f: frameset_) {
-        f->compute();
-        //log_time << f << endl;
-    }
+    // the frame statistics are computed when first read
+    //for (auto& f: frameset_)
+    //    log_time << f << endl;
+
+    // the stages are configured once and shared by all passes, the per frame state lives in their workspaces
+
+    // houghlines to determin where the actual marking is in the frame
+    auto hough_vertical = make_shared<HoughLinesR>(1, static_cast<const int>(calc::DEGREES), settings_.hough_threshold, show_windows_);
+    hough_vertical->angle_limit(settings_.hough_angle_limit);
+
+    // horizontal houghline extension class, the minimum line length depends on the marking and is set for each pass
+    auto hough_horizontal = make_shared<HoughLinesPR>(1, calc::round(calc::DEGREES), 40, 10, show_windows_);
+    hough_horizontal->max_line_gab(12);
+
+    // morph extension class
+    auto morph = make_shared<MorphR>(cv::MORPH_GRADIENT, 1, show_windows_, true);
+
+    // filter for laser detection
+    auto filter_laser = make_shared<FilterR>("Laser Filter", show_windows_);
+
+    auto attempts = 0;
+
+    // the arena peak covers the passes of this measurement
+    arena_.reset();
+    arena_.reset_peak();
 
     while (true) {
 
@@ -189,6 +260,10 @@ void ThicknessGauge::compute_marking_height() {
 
             uint64 time_start = cv::getTickCount();
 
+            bytes_copied_ = 0;
+            arena_.reset();
+            MemoryTracker::reset_peaks();
+
             // configure frames based on center vertical splitting of the original frames
             //vector<cv::Mat> leftFrames(frameCount_);
             //vector<cv::Mat> rightFrames(frameCount_);
@@ -198,11 +273,7 @@ void ThicknessGauge::compute_marking_height() {
             pfilter_marking->show_windows(show_windows_);
             pfilter_baseline->show_windows(show_windows_);
 
-            // houghlines to determin where the actual marking is in the frame
-            auto hough_vertical = make_shared<HoughLinesR>(1, static_cast<const int>(calc::DEGREES), 40, show_windows_);
-
             // configure the diffrent functionalities
-            hough_vertical->angle_limit(30);
             hough_vertical->show_windows(show_windows_);
 
             hough_vertical->marking_rect(compute_marking_rectangle(hough_vertical));
@@ -220,20 +291,15 @@ void ThicknessGauge::compute_marking_height() {
 
             log_time << "2 ok\n";
 
-            // horizontal houghline extension class
-            auto hough_horizontal = make_shared<HoughLinesPR>(1, calc::round(calc::DEGREES), 40, calc::round(min_line_len), show_windows_);
+            hough_horizontal->min_line_len(calc::round(min_line_len));
 
             log_time << "3 ok\n";
 
-            hough_horizontal->max_line_gab(12);
             hough_horizontal->marking_rect(pdata->marking_rect);
             hough_horizontal->show_windows(show_windows_);
 
             log_time << "4 ok\n";
 
-            // morph extension class
-            auto morph = make_shared<MorphR>(cv::MORPH_GRADIENT, 1, show_windows_);
-
             compute_base_line_areas(hough_horizontal, morph);
             //std::cout << cv::format("Base line Y [left] : %f\n", data->baseLines[1]);
             //std::cout << cv::format("Base line Y [right]: %f\n", data->baseLines[3]);
@@ -282,8 +348,6 @@ void ThicknessGauge::compute_marking_height() {
             //std::cout << cv::format("Adjusted base line Y [left] : %f\n", data->baseLines[1]);
             //std::cout << cv::format("Adjusted base line Y [right]: %f\n", data->baseLines[3]);
 
-            // filter for laser detection
-            auto filter_laser = make_shared<FilterR>("Laser Filter", show_windows_);
             filter_laser->show_windows(show_windows_);
 
             // main laser class
@@ -311,17 +375,27 @@ void ThicknessGauge::compute_marking_height() {
             frame_time_ = static_cast<double>((time_end - time_start) / cv::getTickFrequency());
 
             log_ok << "Total compute time (seconds) : " << frame_time_ << endl;
+            log_ok << "Total bytes copied : " << bytes_copied_ << endl;
+            log_ok << cv::format("Arena bytes used : %i (peak %i)\n", static_cast<int>(arena_.used()), static_cast<int>(arena_.peak()));
+            log_ok << cv::format("Resident frame bytes : %i\n", static_cast<int>(resident_bytes()));
+            if (MemoryTracker::enabled())
+                log_ok << "Memory usage per stage :\n" << MemoryTracker::report();
+
+            arena_.reset();
 
             if (show_windows_ && !draw::is_escape_pressed(30))
                 continue;
 
-            break;
+            return true;
         } catch (cv::Exception& e) {
             log_err << cv::format("CV Exception caught in computeMarkingHeight().\n%s\n", e.msg.c_str());
         } catch (std::exception& ex) {
             log_err << cv::format("Exception caught in computeMarkingHeight().\n%s\n", ex.what());
         }
 
+        if (max_attempts > 0 && ++attempts >= max_attempts)
+            return false;
+
     }
 
 }
@@ -333,13 +407,15 @@ void ThicknessGauge::compute_marking_height() {
  */
 void ThicknessGauge::compute_base_line_areas(shared_ptr<HoughLinesPR>& hough, shared_ptr<MorphR>& morph) {
 
+    MemoryScope memory_scope(MemoryStage::BaseLines);
+
     pfilter_baseline->kernel(filters::kernel_line_left_to_right);
 
     morph->method(cv::MORPH_GRADIENT);
     morph->iterations(1);
 
-    pcanny->threshold_1(200);
-    pcanny->threshold_2(250);
+    pcanny->threshold_1(settings_.baseline_canny_threshold_1);
+    pcanny->threshold_2(settings_.baseline_canny_threshold_2);
 
     const std::string window_left = "test baseline left";
     const std::string window_right = "test baseline right";
@@ -376,8 +452,9 @@ void ThicknessGauge::compute_base_line_areas(shared_ptr<HoughLinesPR>& hough, sh
         log_time << "Validation error for right_baseline in computeBaseLineAreas()." << endl;
     }
 
-    vector<cv::Mat> left_frames;
-    vector<cv::Mat> right_frames;
+    // views of the baseline areas
+    auto left_frames = make_arena_vector<cv::Mat>(arena_, frame_count_);
+    auto right_frames = make_arena_vector<cv::Mat>(arena_, frame_count_);
 
     //frame pointer for the desired frame set
     unsigned int frame_index = 2;
@@ -388,8 +465,8 @@ void ThicknessGauge::compute_base_line_areas(shared_ptr<HoughLinesPR>& hough, sh
 
     // generate baseline images..
     for (auto i = frame_count_; i--;) {
-        left_frames.emplace_back(frames->frames_[i](left_baseline));
-        right_frames.emplace_back(frames->frames_[i](right_baseline));
+        left_frames.emplace_back(frames->frames()[i](left_baseline));
+        right_frames.emplace_back(frames->frames()[i](right_baseline));
     }
 
     auto left_size = left_frames.front().size();
@@ -400,8 +477,17 @@ void ThicknessGauge::compute_base_line_areas(shared_ptr<HoughLinesPR>& hough, sh
     auto left_y = 0.0;
     auto right_y = 0.0;
 
-    std::vector<cv::Point2f> left_elements(left_size.area());
-    std::vector<cv::Point2f> right_elements(right_size.area());
+    // the line elements of all frames, appended per line
+    ChunkedVector<cv::Point2f, 1024, ArenaAllocator<cv::Point2f>> left_elements{ArenaAllocator<cv::Point2f>(arena_)};
+    ChunkedVector<cv::Point2f, 1024, ArenaAllocator<cv::Point2f>> right_elements{ArenaAllocator<cv::Point2f>(arena_)};
+
+    // contiguous copy of the elements for the boundry computation
+    auto boundry_elements = make_arena_vector<cv::Point2f>(arena_);
+
+    // InputArray only takes vectors with the default allocator, the elements are passed as a single column instead
+    auto boundry_of = [&boundry_elements]() {
+        return cv::minAreaRect(cv::Mat(static_cast<int>(boundry_elements.size()), 1, CV_32FC2, boundry_elements.data()));
+    };
 
     auto offset_y = image_size_.height - quarter;
 
@@ -421,23 +507,23 @@ void ThicknessGauge::compute_base_line_areas(shared_ptr<HoughLinesPR>& hough, sh
         left_avg = 0.0;
         right_avg = 0.0;
 
+        // view of the last processed frame, the frames are never written to
         cv::Mat org;
 
         try {
 
             // left
 
-            for (auto& left : left_frames) {
-                org = left.clone();
-                auto h = left.clone();
-                hough->original(h);
+            for (const auto& left : left_frames) {
+                org = left;
+                hough->original(left);
 
-                process_mat_for_line(org, hough, morph);
+                process_mat_for_line(left, hough, morph);
 
                 const auto& lines = hough->right_lines(); // inner most side
                 for (auto& line : lines)
                     if (line.entry_[0] > left_cutoff)
-                        stl::copy_vector(line.elements_, left_elements);
+                        left_elements.append(line.elements_);
 
                 if (show_windows_ && draw::is_escape_pressed(30))
                     running = false;
@@ -445,7 +531,8 @@ void ThicknessGauge::compute_base_line_areas(shared_ptr<HoughLinesPR>& hough, sh
             }
 
             // generate real boundry
-            auto left_boundry = cv::minAreaRect(left_elements);
+            left_elements.flatten(boundry_elements);
+            auto left_boundry = boundry_of();
             auto left_boundry_rect = left_boundry.boundingRect();
 
             log_time << "left_boundry_rect: " << left_boundry_rect.y << endl;
@@ -453,8 +540,9 @@ void ThicknessGauge::compute_base_line_areas(shared_ptr<HoughLinesPR>& hough, sh
             left_boundry_rect.width -= 40;
 
             if (show_windows_) {
-                draw::drawRectangle(org, left_boundry_rect, cv::Scalar(255, 255, 255));
-                draw::showImage(window_left, org);
+                auto display = cvr::copy_counted(org, bytes_copied_);
+                draw::drawRectangle(display, left_boundry_rect, cv::Scalar(255, 255, 255));
+                draw::showImage(window_left, display);
                 if (draw::is_escape_pressed(30))
                     running = false;
             }
@@ -468,17 +556,16 @@ void ThicknessGauge::compute_base_line_areas(shared_ptr<HoughLinesPR>& hough, sh
 
             // right
 
-            for (auto& right : right_frames) {
-                org = right.clone();
-                auto h1 = right.clone();
-                hough->original(h1);
+            for (const auto& right : right_frames) {
+                org = right;
+                hough->original(right);
 
-                process_mat_for_line(org, hough, morph);
+                process_mat_for_line(right, hough, morph);
 
                 const auto& lines = hough->left_lines(); // inner most side
                 for (auto& h : lines) {
                     if (h.entry_[2] < right_cutoff)
-                        stl::copy_vector(h.elements_, right_elements);
+                        right_elements.append(h.elements_);
                 }
 
                 if (show_windows_ && draw::is_escape_pressed(30))
@@ -487,14 +574,16 @@ void ThicknessGauge::compute_base_line_areas(shared_ptr<HoughLinesPR>& hough, sh
             }
 
             // generate real boundry
-            auto right_boundry = cv::minAreaRect(right_elements);
+            right_elements.flatten(boundry_elements);
+            auto right_boundry = boundry_of();
             auto right_boundry_rect = right_boundry.boundingRect();
 
             right_boundry_rect.x += 40;
 
             if (show_windows_) {
-                draw::drawRectangle(org, right_boundry_rect, cv::Scalar(255, 255, 255));
-                draw::showImage(window_right, org);
+                auto display = cvr::copy_counted(org, bytes_copied_);
+                draw::drawRectangle(display, right_boundry_rect, cv::Scalar(255, 255, 255));
+                draw::showImage(window_right, display);
                 if (draw::is_escape_pressed(30))
                     running = false;
             }
@@ -542,7 +631,7 @@ void ThicknessGauge::compute_base_line_areas(shared_ptr<HoughLinesPR>& hough, sh
  * \param hough The hough extension class used
  * \param morph The morphology extenstion class used
  */
-void ThicknessGauge::process_mat_for_line(cv::Mat& org, shared_ptr<HoughLinesPR>& hough, shared_ptr<MorphR>& morph) const {
+void ThicknessGauge::process_mat_for_line(const cv::Mat& org, shared_ptr<HoughLinesPR>& hough, shared_ptr<MorphR>& morph) const {
     pfilter_baseline->image(org);
     pfilter_baseline->do_filter();
 
@@ -563,6 +652,8 @@ void ThicknessGauge::process_mat_for_line(cv::Mat& org, shared_ptr<HoughLinesPR>
  */
 cv::Rect2d ThicknessGauge::compute_marking_rectangle(shared_ptr<HoughLinesR>& hough) {
 
+    MemoryScope memory_scope(MemoryStage::MarkingRect);
+
     const std::string window_name = "test marking out";
 
     if (show_windows_)
@@ -570,9 +661,13 @@ cv::Rect2d ThicknessGauge::compute_marking_rectangle(shared_ptr<HoughLinesR>& ho
 
     pfilter_marking->kernel(filters::kernel_line_right_to_left);
 
-    vector<cv::Rect2d> markings(frame_count_);
-    vector<cv::Vec4d> left_borders(frame_count_);
-    vector<cv::Vec4d> right_borders(frame_count_);
+    // the base line search changes the thresholds of the shared canny
+    pcanny->threshold_1(settings_.marking_canny_threshold_1);
+    pcanny->threshold_2(settings_.marking_canny_threshold_2);
+
+    auto markings = make_arena_vector<cv::Rect2d>(arena_, frame_count_);
+    auto left_borders = make_arena_vector<cv::Vec4d>(arena_, frame_count_);
+    auto right_borders = make_arena_vector<cv::Vec4d>(arena_, frame_count_);
 
     cv::Rect2d output(0.0, 0.0, 0.0, 0.0);
     cv::Vec4d left_border_result(0.0, 0.0, 0.0, 0.0);
@@ -588,7 +683,7 @@ cv::Rect2d ThicknessGauge::compute_marking_rectangle(shared_ptr<HoughLinesR>& ho
 
     log_time << cv::format("computerMarkingRectangle using exposure set %i : %s (%i)\n", frame_index, frames->exp_ext_, frames->exp_ms_);
 
-    auto accuRects = [image_height](const vector<cv::Rect2d>& rects, cv::Rect2d& out) {
+    auto accuRects = [image_height](const arena_vector<cv::Rect2d>& rects, cv::Rect2d& out) {
         out.x = 0.0;
         out.y = 0.0;
         out.width = 0.0;
@@ -603,7 +698,7 @@ cv::Rect2d ThicknessGauge::compute_marking_rectangle(shared_ptr<HoughLinesR>& ho
         out.width /= rects.size();
     };
 
-    auto accuVecs = [image_height](const vector<cv::Vec4d>& vecs, cv::Vec4d& out) {
+    auto accuVecs = [image_height](const arena_vector<cv::Vec4d>& vecs, cv::Vec4d& out) {
         out[0] = 0.0;
         out[1] = image_height;
         out[2] = 0.0;
@@ -623,6 +718,32 @@ cv::Rect2d ThicknessGauge::compute_marking_rectangle(shared_ptr<HoughLinesR>& ho
         //log_time << __FUNCTION__ << " accuVecs 0 : " << out << std::endl;
     };
 
+    const auto frame_count = static_cast<int>(frames->frames().size());
+
+    // per frame results, each frame is processed with its own workspaces through the shared stages
+    auto frame_markings = make_arena_vector<cv::Rect2d>(arena_, frame_count);
+    auto frame_left_borders = make_arena_vector<cv::Vec4d>(arena_, frame_count);
+    auto frame_right_borders = make_arena_vector<cv::Vec4d>(arena_, frame_count);
+    auto frame_errors = make_arena_vector<std::exception_ptr>(arena_, frame_count);
+    auto frame_ok = make_arena_vector<char>(arena_, frame_count);
+
+    // the log is written after the workers are done, so the messages of a frame stay together
+    auto frame_messages = make_arena_vector<std::string>(arena_, frame_count);
+
+    frame_markings.resize(frame_count);
+    frame_left_borders.resize(frame_count);
+    frame_right_borders.resize(frame_count);
+    frame_errors.resize(frame_count);
+    frame_ok.resize(frame_count);
+    frame_messages.resize(frame_count);
+
+    // the workspaces of one worker, reused for the frames of its range
+    struct FrameWorkspaces {
+        FilterR::Workspace filter;
+        CannyR::Workspace canny;
+        HoughLinesR::Workspace hough;
+    };
+
     while (running) {
         try {
 
@@ -630,58 +751,86 @@ cv::Rect2d ThicknessGauge::compute_marking_rectangle(shared_ptr<HoughLinesR>& ho
             left_borders.clear();
             right_borders.clear();
 
-            cv::Mat sparse;
-            for (auto i = 0; i < frames->frames_.size(); i++) {
-
-                //log_time << "frame : " << i << " / " << frames->frames.size() << std::endl;
-
-                //canny->setImage(frames->frames[i].clone());
-                //canny->doCanny();
-
-                pfilter_marking->image(frames->frames_[i].clone());
-                pfilter_marking->do_filter();
-                pcanny->image(pfilter_marking->result());
-                pcanny->do_canny();
-
-                auto t = pcanny->result();
-
-                //log_time << "hough\n";
-
-                auto tmp = t.clone();
-                hough->original(tmp);
-                hough->image(t);
-
-                //log_time << "hough2\n";
-
-                if (hough->hough_vertical() < 0) {
-                    log_err << "No lines detected from houghR\n";
-                    //continue;
+            std::fill(frame_errors.begin(), frame_errors.end(), nullptr);
+            std::fill(frame_ok.begin(), frame_ok.end(), 0);
+            for (auto& messages : frame_messages)
+                messages.clear();
+
+            auto process_frame = [&](int i, FrameWorkspaces& ws) {
+                try {
+                    pfilter_marking->process(frames->frames()[i], ws.filter);
+                    pcanny->process(ws.filter.result, ws.canny);
+
+                    if (show_windows_)
+                        hough->original(ws.canny.edges.clone());
+
+                    // a frame without lines has no borders of its own, it is left out of the averages
+                    if (hough->process_voting(ws.canny.edges, ws.hough) < 0) {
+                        frame_messages[i] += "No lines detected from houghR\n";
+                        return;
+                    }
+
+                    ws.hough.log.clear();
+                    try {
+                        hough->compute_borders(ws.hough);
+                    } catch (...) {
+                        frame_messages[i] += ws.hough.log;
+                        throw;
+                    }
+                    frame_messages[i] += ws.hough.log;
+
+                    hough->show_borders(ws.hough);
+
+                    frame_markings[i] = ws.hough.marking_rect;
+                    frame_left_borders[i] = ws.hough.left_border;
+                    frame_right_borders[i] = ws.hough.right_border;
+                    frame_ok[i] = 1;
+                } catch (...) {
+                    frame_errors[i] = std::current_exception();
                 }
+            };
 
-                //log_time << "hough3\n";
-
-                hough->compute_borders();
+            if (show_windows_) {
+                FrameWorkspaces ws;
+                for (auto i = 0; i < frame_count; i++) {
+                    process_frame(i, ws);
+                    if (draw::is_escape_pressed(30)) {
+                        running = false;
+                        break;
+                    }
+                }
+            } else {
+                // one range per worker thread, each range reuses its workspaces for its frames
+                std::function<void(const cv::Range&)> process_range = [&](const cv::Range& range) {
+                    // the stage is per thread, the workers count with this one
+                    MemoryScope worker_scope(MemoryStage::MarkingRect);
+                    FrameWorkspaces ws;
+                    for (auto i = range.start; i < range.end; i++)
+                        process_frame(i, ws);
+                };
+                cv::parallel_for_(cv::Range(0, frame_count), RangeBody(process_range), cv::getNumThreads());
+            }
 
-                auto lb = hough->left_border();
-                auto rb = hough->right_border();
-                auto mr = hough->marking_rect();
+            for (auto i = 0; i < frame_count; i++) {
+                if (!frame_messages[i].empty())
+                    log_err << frame_messages[i];
+            }
 
-                //markings.emplace_back(mr);
-                //left_borders.emplace_back(lb);
-                //right_borders.emplace_back(rb);
+            for (auto i = 0; i < frame_count; i++) {
+                if (frame_errors[i])
+                    std::rethrow_exception(frame_errors[i]);
 
-                if (validate::validate_rect(mr))
-                    markings.emplace_back(mr);
+                if (!frame_ok[i])
+                    continue;
 
-                if (validate::valid_vec(lb))
-                    left_borders.emplace_back(lb);
+                if (validate::validate_rect(frame_markings[i]))
+                    markings.emplace_back(frame_markings[i]);
 
-                if (validate::valid_vec(rb))
-                    right_borders.emplace_back(rb);
-
-                if (show_windows_ && draw::is_escape_pressed(30))
-                    running = false;
+                if (validate::valid_vec(frame_left_borders[i]))
+                    left_borders.emplace_back(frame_left_borders[i]);
 
+                if (validate::valid_vec(frame_right_borders[i]))
+                    right_borders.emplace_back(frame_right_borders[i]);
             }
 
             accuRects(markings, output);
@@ -703,7 +852,7 @@ cv::Rect2d ThicknessGauge::compute_marking_rectangle(shared_ptr<HoughLinesR>& ho
             if (!show_windows_)
                 running = false;
             else {
-                auto marking_test = frames->frames_.front().clone();
+                auto marking_test = cvr::copy_counted(frames->frames().front(), bytes_copied_);
                 draw::drawRectangle(marking_test, output, cv::Scalar(128, 128, 128));
                 draw::showImage(window_name, marking_test);
                 if (draw::is_escape_pressed(30))
@@ -711,10 +860,10 @@ cv::Rect2d ThicknessGauge::compute_marking_rectangle(shared_ptr<HoughLinesR>& ho
             }
         } catch (cv::Exception& e) {
             log_err << "CV Exception\n" << e.what();
-            exit(-991);
+            throw;
         } catch (NoLineDetectedException& e) {
             log_err << cv::format("NoLineDetectedException : %s\n", e.what());
-            exit(-100);
+            throw;
         }
 
     }
@@ -744,8 +893,10 @@ cv::Rect2d ThicknessGauge::compute_marking_rectangle(shared_ptr<HoughLinesR>& ho
  */
 void ThicknessGauge::compute_laser_locations(shared_ptr<LaserR>& laser, shared_ptr<FilterR>& filter) {
 
+    MemoryScope memory_scope(MemoryStage::Laser);
+
     // generate frames with marking
-    std::vector<cv::Mat> marking_frames;
+    auto marking_frames = make_arena_vector<cv::Mat>(arena_, frame_count_);
 
     unsigned int frame_index = 0;
 
@@ -753,7 +904,7 @@ void ThicknessGauge::compute_laser_locations(shared_ptr<LaserR>& laser, shared_p
 
     log_time << cv::format("computeLaserLocations using exposure set %i : %s (%i)\n", frame_index, frames->exp_ext_, frames->exp_ms_);
 
-    for (auto& frame : frames->frames_)
+    for (auto& frame : frames->frames())
         marking_frames.emplace_back(frame(pdata->marking_rect));
 
     const std::string window_name = "test height";
@@ -771,7 +922,8 @@ void ThicknessGauge::compute_laser_locations(shared_ptr<LaserR>& laser, shared_p
 
     auto running = true;
 
-    std::vector<cv::Point2d> results(image_size.width);
+    // the summed center points of all frames, one per column
+    auto results = make_arena_vector<cv::Point2d>(arena_, image_size.width);
 
     stl::populate_x(results, image_size.width);
 
@@ -792,14 +944,14 @@ void ThicknessGauge::compute_laser_locations(shared_ptr<LaserR>& laser, shared_p
                 cv::Mat base_frame;
 
                 // TODO : replace with custom filter if needed
-                cv::bilateralFilter(marking_frames[i], base_frame, 3, 20, 10);
+                cv::bilateralFilter(marking_frames[i], base_frame, settings_.bilateral_diameter, 20, 10);
 
                 //cv::Mat t;
                 //GenericCV::adaptiveThreshold(baseFrame, t, &thresholdLevel);
 
-                threshold(base_frame, base_frame, binary_threshold_, 255, CV_THRESH_BINARY);
+                threshold(base_frame, base_frame, settings_.binary_threshold, 255, CV_THRESH_BINARY);
 
-                GaussianBlur(base_frame, base_frame, cv::Size(5, 5), 0, 10, cv::BORDER_DEFAULT);
+                GaussianBlur(base_frame, base_frame, cv::Size(settings_.gaussian_size, settings_.gaussian_size), 0, 10, cv::BORDER_DEFAULT);
 
                 /* RECT CUT METHOD */
                 avg_height += calc::weighted_avg(base_frame, base_frame, pdata->center_points, laser_y_out);
@@ -836,8 +988,7 @@ void ThicknessGauge::compute_laser_locations(shared_ptr<LaserR>& laser, shared_p
         }
 
         // since theres some issues with using results vector, this works just as fine.
-        pdata->center_points.clear();
-        stl::copy_vector(results, pdata->center_points);
+        pdata->center_points.assign(results.begin(), results.end());
 
         auto highest_total = avg_height / static_cast<unsigned int>(frame_count_);
 
@@ -893,7 +1044,7 @@ void ThicknessGauge::computer_in_between(shared_ptr<FilterR>& filter, shared_ptr
 
     auto frame = frameset_[frame_index].get();
 
-    auto image_size = frame->frames_.front().size();
+    auto image_size = frame->frames().front().size();
 
     auto quarter = image_size.height >> 2;
 
@@ -919,13 +1070,13 @@ void ThicknessGauge::computer_in_between(shared_ptr<FilterR>& filter, shared_ptr
     log_time << "in between: left_laser_roi -> " << left_laser_roi << endl;
 
     // grab the left left baseline
-    for (auto& f : frame->frames_)
+    for (auto& f : frame->frames())
         base.emplace_back(f(left_base_roi));
 
     // switch to lower exposure and grab left right side
     frame_index = 0;
     frame = frameset_[frame_index].get();
-    for (auto& f : frame->frames_)
+    for (auto& f : frame->frames())
         mark.emplace_back(f(left_laser_roi));
 
     cv::imwrite("__left_.png", base.front());
@@ -983,17 +1134,20 @@ void ThicknessGauge::glob_load(std::string& glob_name) {
         if (size != frame_count_)
             frame_count(size);
 
-        frames->frames_.clear();
-        frames->frames_.reserve(size);
+        auto& target = frames->edit_frames();
+        target.clear();
+        target.reserve(size);
 
         for (auto& file : files)
-            frames->frames_.emplace_back(cv::imread(file, CV_8UC1));
+            target.emplace_back(cv::imread(file, CV_8UC1));
 
-        frames->frames_.shrink_to_fit();
+        target.shrink_to_fit();
+        if (stack_frames_)
+            frames->stack();
 
     }
 
-    image_size(frameset_.front()->frames_.front().size());
+    image_size(frameset_.front()->frames().front().size());
 
 }
 
@@ -1023,8 +1177,9 @@ void ThicknessGauge::capture_frames(unsigned int frame_index, unsigned int captu
     auto pb_pos = 1;
 
     for (auto& f : frameset_) {
-        f->frames_.clear();
-        f->frames_.reserve(capture_count);
+        auto& target = f->edit_frames();
+        target.clear();
+        target.reserve(capture_count);
         //capture->cap(capture_count, f->frames, static_cast<unsigned long>(f->exp_ms));
         //log_time << f << '\n';
 
@@ -1066,7 +1221,7 @@ bool ThicknessGauge::save_data(string filename) {
 
     cv::Vec3i sizes(static_cast<int>(pdata->left_points.size()), static_cast<int>(pdata->center_points.size()), static_cast<int>(pdata->right_points.size()));
 
-    auto& tmp_mat = frameset_.front()->frames_.front();
+    auto& tmp_mat = frameset_.front()->frames().front();
 
     fs << "Filename" << filename;
     fs << "TimeSaved" << get_time_date();
@@ -1112,9 +1267,12 @@ bool ThicknessGauge::save_data(string filename) {
     auto total_width = static_cast<int>(pdata->left_points.size() + pdata->center_points.size() + pdata->right_points.size());
 
     // generate image for output overview and save it.
+    // the averaged burst, without the speckle of a single frame
+    cv::Mat background;
+    frameset_.back()->average(background);
     cv::Mat overlay;
-    cv::cvtColor(frameset_.back()->frames_.front(), overlay, CV_GRAY2BGR);
-    cv::Mat overview = cv::Mat::zeros(overlay.rows, overlay.cols, frameset_[0]->frames_.front().type());
+    cv::cvtColor(background, overlay, CV_GRAY2BGR);
+    cv::Mat overview = cv::Mat::zeros(overlay.rows, overlay.cols, frameset_[0]->frames().front().type());
 
 #ifdef _MSC_VER
 #pragma message("MSC compatible compiler detected -- turning off warning 4309")
@@ -1167,10 +1325,10 @@ bool ThicknessGauge::save_data(string filename) {
     //paintY(overlay, data->rightPoints, base_right_p1.x, -data->difference, default_col);
     //paintY(overview, data->rightPoints, base_right_p1.x, -data->difference, default_bw);
 
-    cv::imshow("overlay", overlay);
-    cv::imshow("overview", overview);
+    draw::showImage("overlay", overlay);
+    draw::showImage("overview", overview);
 
-    cv::waitKey(0);
+    draw::get_key(0);
 
     cv::imwrite("_overlay.png", overlay);
     cv::imwrite("_overview.png", overview);
@@ -1180,20 +1338,27 @@ bool ThicknessGauge::save_data(string filename) {
 
 void ThicknessGauge::test_edge() {
 
-    cv::VideoCapture cap(CV_CAP_PVAPI); // open the default camera
-    if (!cap.isOpened()) // check if we succeeded
+    // only shows the video, there is nothing to see without windows
+    if (draw::headless)
+        return;
+
+    if (!open_capture())
         return;
 
-    cv::namedWindow("Video", 1);
+    start_acquisition();
+
+    draw::makeWindow("Video", true);
     while (true) {
         cv::Mat frame;
-        cap >> frame; // get a new frame from camera
-        imshow("Video", frame);
+        pcapture->cap_single(frame); // get a new frame from camera
+        draw::showImage("Video", frame);
 
         // Press 'c' to escape
-        if (cv::waitKey(30) == 'c')
+        if (draw::get_key(30) == 'c')
             break;
     }
+
+    close_capture();
     return;
 }
 
@@ -1272,11 +1437,35 @@ bool ThicknessGauge::sparse_y(cv::Mat& image, std::vector<cv::Point>& output) co
 }
 
 int ThicknessGauge::binary_threshold() const {
-    return binary_threshold_;
+    return settings_.binary_threshold;
 }
 
 void ThicknessGauge::binary_threshold(int binaryThreshold) {
-    binary_threshold_ = binaryThreshold;
+    settings_.binary_threshold = binaryThreshold;
+}
+
+std::shared_ptr<CaptureInterface> ThicknessGauge::capture() const {
+    return pcapture;
+}
+
+void ThicknessGauge::capture(std::shared_ptr<CaptureInterface> new_capture) {
+    pcapture = std::move(new_capture);
+}
+
+const ThicknessGaugeSettings& ThicknessGauge::settings() const {
+    return settings_;
+}
+
+void ThicknessGauge::settings(const ThicknessGaugeSettings& new_settings) {
+    settings_ = new_settings;
+}
+
+bool ThicknessGauge::stack_frames() const {
+    return stack_frames_;
+}
+
+void ThicknessGauge::stack_frames(bool new_stack_frames) {
+    stack_frames_ = new_stack_frames;
 }
 
 int ThicknessGauge::frame_count() const {
@@ -1294,6 +1483,10 @@ double ThicknessGauge::frame_time() const {
     return frame_time_;
 }
 
+size_t ThicknessGauge::bytes_copied() const {
+    return bytes_copied_;
+}
+
 bool ThicknessGauge::save_video() const {
     return save_video_;
 }
@@ -1307,5 +1500,7 @@ bool ThicknessGauge::show_windows() const {
 }
 
 void ThicknessGauge::show_windows(bool showWindows) {
+#ifndef TG_HEADLESS
     show_windows_ = showWindows;
+#endif
 }
@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "ThicknessGaugeData.h"
+#include "ThicknessGaugeSettings.h"
 
 #include "Calibrate/CalibrationSettings.h"
 
@@ -19,6 +20,7 @@
 
 #include "namespaces/tg.h"
 #include "Camera/CapturePvApi.h"
+#include "Util/Arena.h"
 #include "CV/Data.h"
 #include "namespaces/draw.h"
 
@@ -35,12 +37,12 @@ public:
     ThicknessGauge(int frameCount, bool showWindows, bool saveVideo, int binaryThreshold, int lineThreshold)
         : pdata(std::make_shared<Data<double>>())
         , frame_count_(frameCount)
-        , show_windows_(showWindows)
         , save_video_(saveVideo)
-        , binary_threshold_(binaryThreshold)
         , line_threshold_(lineThreshold) {
         base_colour_ = cv::Scalar(255, 255, 255);
-        pcanny = std::make_shared<CannyR>(130, 200, 3, true, showWindows, false);
+        settings_.binary_threshold = binaryThreshold;
+        show_windows(showWindows);
+        pcanny = std::make_shared<CannyR>(settings_.marking_canny_threshold_1, settings_.marking_canny_threshold_2, 3, true, showWindows, false);
         //draw::showWindows = showWindows;
     }
 
@@ -52,7 +54,7 @@ public:
 
 private:
 
-    std::unique_ptr<CapturePvApi> pcapture; // initialized in initVideoCapture()
+    std::shared_ptr<CaptureInterface> pcapture; // the PvAPI camera unless set, created in initialize()
 
     // common canny with default settings for detecting marking borders
     std::shared_ptr<CannyR> pcanny;
@@ -65,13 +67,27 @@ private:
 
     double frame_time_ = 0.0;
 
+    // pixel bytes deep copied during the last measurement, frames are otherwise only read through views
+    size_t bytes_copied_ = 0;
+
+    // the transient containers of one measurement, reset when the measurement starts and ends
+    Arena arena_;
+
     int frame_count_;
 
-    bool show_windows_;
+#ifdef TG_HEADLESS
+    // visualization is compiled out, all branches on this are removed
+    static constexpr bool show_windows_ = false;
+#else
+    bool show_windows_ = false;
+#endif
 
     bool save_video_;
 
-    int binary_threshold_;
+    // frame sets are moved into one contiguous stack after they are captured or loaded
+    bool stack_frames_ = false;
+
+    ThicknessGaugeSettings settings_;
 
     int line_threshold_;
 
@@ -92,7 +108,12 @@ public: // basic stuff to extract information
 
     void glob_generate(std::string& name);
 
-    void compute_marking_height();
+    /**
+     * \brief Computes the marking height from the loaded frames
+     * \param max_attempts The number of failed attempts before giving up, 0 retries until it succeeds
+     * \return true if the height was computed, otherwise false
+     */
+    bool compute_marking_height(int max_attempts = 0);
 
     /**
     * \brief Loads all null images from "./null/" folder.
@@ -103,11 +124,17 @@ public: // basic stuff to extract information
 
 private:
 
+    bool open_capture();
+
+    void start_acquisition() const;
+
+    void close_capture() const;
+
     void test_edge();
 
     void compute_base_line_areas(shared_ptr<HoughLinesPR>& hough, shared_ptr<MorphR>& morph);
 
-    void process_mat_for_line(cv::Mat& org, shared_ptr<HoughLinesPR>& hough, shared_ptr<MorphR>& morph) const;
+    void process_mat_for_line(const cv::Mat& org, shared_ptr<HoughLinesPR>& hough, shared_ptr<MorphR>& morph) const;
 
     cv::Rect2d compute_marking_rectangle(shared_ptr<HoughLinesR>& hough);
 
@@ -133,6 +160,8 @@ public: // getters and setters
 
     double frame_time() const;
 
+    size_t bytes_copied() const;
+
     bool save_video() const;
 
     void save_video(bool new_save_video_val);
@@ -145,4 +174,22 @@ public: // getters and setters
 
     void binary_threshold(int binaryThreshold);
 
+    std::shared_ptr<CaptureInterface> capture() const;
+
+    /**
+     * \brief Sets the capture device initialize() reads the frames from with "camera"
+     */
+    void capture(std::shared_ptr<CaptureInterface> new_capture);
+
+    const ThicknessGaugeSettings& settings() const;
+
+    void settings(const ThicknessGaugeSettings& new_settings);
+
+    bool stack_frames() const;
+
+    /**
+     * \brief Sets whether frame sets are stacked (Frames::stack()) after they are captured or loaded, off by default
+     */
+    void stack_frames(bool new_stack_frames);
+
 };
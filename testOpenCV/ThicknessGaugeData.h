@@ -39,6 +39,11 @@ public:
 
     void image_size(const int width, const int height);
 
+    /**
+     * \brief The bytes held by all framesets and null frames, these stay resident between measurements
+     */
+    size_t resident_bytes() const;
+
 };
 
 inline void ThicknessGaugeData::image_size(cv::Size size) {
@@ -49,3 +54,12 @@ inline void ThicknessGaugeData::image_size(const int width, const int height) {
     image_size_.width = width;
     image_size_.height = height;
 }
+
+inline size_t ThicknessGaugeData::resident_bytes() const {
+    size_t total = 0;
+    for (auto& frames : frameset_)
+        total += frames->bytes();
+    for (auto& null : nulls_)
+        total += null.total() * null.elemSize();
+    return total;
+}
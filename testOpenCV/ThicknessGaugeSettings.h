@@ -0,0 +1,124 @@
+#pragma once
+#include <string>
+#include <ostream>
+#include <opencv2/core/persistence.hpp>
+
+/**
+ * \brief The tunable processing parameters of ThicknessGauge.
+ * The defaults are the hand-set values, the tuner (Testing/Tuner.h) writes alternatives to a settings file.
+ * The exposures are not part of this, as recorded globs are fixed to the exposures they were captured with.
+ */
+struct ThicknessGaugeSettings {
+
+    // canny thresholds for the marking rectangle search
+    int marking_canny_threshold_1 = 130;
+    int marking_canny_threshold_2 = 200;
+
+    // canny thresholds for the base line search
+    int baseline_canny_threshold_1 = 200;
+    int baseline_canny_threshold_2 = 250;
+
+    // vertical hough lines for the marking borders
+    int hough_threshold = 40;
+    int hough_angle_limit = 30;
+
+    // laser location filtering
+    int binary_threshold = 100;
+    int bilateral_diameter = 3;
+    int gaussian_size = 5;
+
+    void write(cv::FileStorage& fs) const {
+        fs << "{"
+            << "marking_canny_threshold_1" << marking_canny_threshold_1
+            << "marking_canny_threshold_2" << marking_canny_threshold_2
+            << "baseline_canny_threshold_1" << baseline_canny_threshold_1
+            << "baseline_canny_threshold_2" << baseline_canny_threshold_2
+            << "hough_threshold" << hough_threshold
+            << "hough_angle_limit" << hough_angle_limit
+            << "binary_threshold" << binary_threshold
+            << "bilateral_diameter" << bilateral_diameter
+            << "gaussian_size" << gaussian_size
+            << "}";
+    }
+
+    /**
+     * \brief Reads the settings from a node, missing entries keep their current value
+     * \param node The node written by write()
+     */
+    void read(const cv::FileNode& node) {
+        auto get = [&node](const char* name, int& value) {
+            auto n = node[name];
+            if (!n.empty())
+                n >> value;
+        };
+        get("marking_canny_threshold_1", marking_canny_threshold_1);
+        get("marking_canny_threshold_2", marking_canny_threshold_2);
+        get("baseline_canny_threshold_1", baseline_canny_threshold_1);
+        get("baseline_canny_threshold_2", baseline_canny_threshold_2);
+        get("hough_threshold", hough_threshold);
+        get("hough_angle_limit", hough_angle_limit);
+        get("binary_threshold", binary_threshold);
+        get("bilateral_diameter", bilateral_diameter);
+        get("gaussian_size", gaussian_size);
+    }
+
+    /**
+     * \brief Whether the settings can be used, kernel sizes are positive (and odd for the gaussian),
+     * canny threshold 1 is not above threshold 2, and the thresholds are within their ranges
+     */
+    bool valid() const {
+        auto canny_ok = [](int threshold_1, int threshold_2) {
+            return threshold_1 >= 0 && threshold_1 <= threshold_2;
+        };
+        return canny_ok(marking_canny_threshold_1, marking_canny_threshold_2)
+            && canny_ok(baseline_canny_threshold_1, baseline_canny_threshold_2)
+            && hough_threshold > 0
+            && hough_angle_limit > 0 && hough_angle_limit <= 90
+            && binary_threshold >= 0 && binary_threshold <= 255
+            && bilateral_diameter > 0
+            && gaussian_size > 0 && gaussian_size % 2 == 1;
+    }
+
+    /**
+     * \brief Loads settings from a file written by the tuner, or a file with a single "settings" entry
+     * \param file_name The settings file
+     * \param index The index in the tuner front, which is ordered by deviation
+     * \return true if the settings were loaded, otherwise false and the settings are unchanged, also if the loaded settings are not valid()
+     */
+    bool load(const std::string& file_name, int index = 0) {
+        cv::FileStorage fs(file_name, cv::FileStorage::READ);
+        if (!fs.isOpened())
+            return false;
+
+        auto loaded = *this;
+
+        auto front = fs["front"];
+        if (front.isSeq()) {
+            if (index < 0 || index >= static_cast<int>(front.size()))
+                return false;
+            loaded.read(front[index]["settings"]);
+        } else {
+            auto settings = fs["settings"];
+            if (settings.empty())
+                return false;
+            loaded.read(settings);
+        }
+
+        if (!loaded.valid())
+            return false;
+
+        *this = loaded;
+        return true;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const ThicknessGaugeSettings& obj) {
+        return os
+            << "canny marking: " << obj.marking_canny_threshold_1 << '/' << obj.marking_canny_threshold_2
+            << " canny baseline: " << obj.baseline_canny_threshold_1 << '/' << obj.baseline_canny_threshold_2
+            << " hough: " << obj.hough_threshold << '/' << obj.hough_angle_limit
+            << " binary: " << obj.binary_threshold
+            << " bilateral: " << obj.bilateral_diameter
+            << " gaussian: " << obj.gaussian_size;
+    }
+
+};
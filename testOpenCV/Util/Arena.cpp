@@ -0,0 +1,78 @@
+#include "Arena.h"
+#include <algorithm>
+#include <cstdint>
+
+Arena::Arena(size_t block_size)
+    : block_(0)
+      , offset_(0)
+      , used_(0)
+      , peak_(0)
+      , block_size_(block_size) { }
+
+void Arena::add_block(size_t size) {
+    // not value initialized, the memory is written by whoever allocates it
+    blocks_.emplace_back(Block{std::unique_ptr<char[]>(new char[size]), size});
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment) {
+    if (bytes == 0)
+        bytes = 1;
+
+    while (true) {
+        if (block_ == blocks_.size())
+            add_block(std::max(block_size_, bytes + alignment));
+
+        auto& block = blocks_[block_];
+        auto base = reinterpret_cast<uintptr_t>(block.data.get());
+        auto aligned = (base + offset_ + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        auto end = aligned + bytes - base;
+
+        if (end <= block.size) {
+            used_ += end - offset_;
+            peak_ = std::max(peak_, used_);
+            offset_ = end;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        // the rest of the block is left unused
+        used_ += block.size - offset_;
+        offset_ = 0;
+        ++block_;
+    }
+}
+
+void Arena::reset() {
+    if (blocks_.size() > 1) {
+        // merge into one block, so the next measurement of the same size does not allocate
+        auto total = capacity();
+        blocks_.clear();
+        add_block(total);
+    }
+
+    block_ = 0;
+    offset_ = 0;
+    used_ = 0;
+}
+
+size_t Arena::used() const {
+    return used_;
+}
+
+size_t Arena::peak() const {
+    return peak_;
+}
+
+void Arena::reset_peak() {
+    peak_ = used_;
+}
+
+size_t Arena::capacity() const {
+    size_t total = 0;
+    for (auto& block : blocks_)
+        total += block.size;
+    return total;
+}
+
+size_t Arena::blocks() const {
+    return blocks_.size();
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * \brief Monotonic memory arena for the short-lived containers of a single measurement.
+ * Allocation bumps a pointer inside the current block and deallocation does nothing,
+ * the memory is handed back all at once by reset().
+ * After a reset the blocks are merged into one block large enough for everything used since the last reset,
+ * so a repeated measurement of the same size runs from a single block without allocating.
+ * Not thread safe, allocate from one thread and only hand the containers to workers once sized.
+ */
+class Arena {
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+
+    // the block currently allocated from
+    size_t block_;
+
+    // the next free byte in the current block
+    size_t offset_;
+
+    // bytes handed out since the last reset, including alignment padding
+    size_t used_;
+
+    // the highest used_ seen since the last reset_peak(), kept by reset() so it covers repeated measurements
+    size_t peak_;
+
+    size_t block_size_;
+
+    void add_block(size_t size);
+
+public:
+
+    /**
+     * \brief Creates an arena, no memory is allocated until the first allocation
+     * \param block_size The minimum size of a block
+     */
+    explicit Arena(size_t block_size = 1 << 20);
+
+    Arena(const Arena&) = delete;
+
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * \brief Allocates memory that stays valid until the next reset()
+     * \param bytes The number of bytes
+     * \param alignment The alignment, must be a power of two
+     * \return The memory
+     */
+    void* allocate(size_t bytes, size_t alignment);
+
+    /**
+     * \brief Releases everything allocated at once, containers using the arena must be gone before this
+     */
+    void reset();
+
+    size_t used() const;
+
+    size_t peak() const;
+
+    /**
+     * \brief Starts the peak over from the bytes currently used
+     */
+    void reset_peak();
+
+    size_t capacity() const;
+
+    size_t blocks() const;
+
+};
+
+/**
+ * \brief Standard allocator handing out memory from an arena, deallocation is a no-op
+ */
+template <typename T>
+class ArenaAllocator {
+
+    template <typename U>
+    friend class ArenaAllocator;
+
+    Arena* arena_;
+
+public:
+
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena& arena) noexcept
+        : arena_(&arena) { }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : arena_(other.arena_) { }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept { }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.arena_;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ != other.arena_;
+    }
+
+};
+
+template <typename T>
+using arena_vector = std::vector<T, ArenaAllocator<T>>;
+
+/**
+ * \brief Creates an empty vector allocating from the arena
+ * \param arena The arena
+ * \param capacity The capacity to reserve up front
+ * \return The vector
+ */
+template <typename T>
+arena_vector<T> make_arena_vector(Arena& arena, size_t capacity = 0) {
+    arena_vector<T> output{ArenaAllocator<T>(arena)};
+    output.reserve(capacity);
+    return output;
+}
@@ -0,0 +1,241 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+/**
+ * \brief Append-only container stored as a list of fixed size chunks.
+ * Appending never moves existing elements, so their addresses stay valid until clear(),
+ * and the cost of accumulating many small ranges is linear in the total element count.
+ * Cleared chunks are kept for reuse, so a container that is filled and cleared in a loop stops allocating.
+ * Use flatten() when a contiguous range is required, for example for cv::minAreaRect().
+ * \tparam T The element type, must be default constructible and copy assignable
+ * \tparam ChunkSize The number of elements per chunk
+ * \tparam Allocator The allocator for the chunks and the chunk list, an ArenaAllocator keeps them in the measurement arena
+ */
+template <typename T, size_t ChunkSize = 1024, typename Allocator = std::allocator<T>>
+class ChunkedVector {
+
+    static_assert(ChunkSize > 0, "Chunk size must be positive.");
+
+    using traits = std::allocator_traits<Allocator>;
+
+    using chunk_list_allocator = typename traits::template rebind_alloc<T*>;
+
+    Allocator allocator_;
+
+    std::vector<T*, chunk_list_allocator> chunks_;
+
+    size_t size_ = 0;
+
+    T* slot() {
+        auto chunk = size_ / ChunkSize;
+        if (chunk == chunks_.size()) {
+            // grown before the chunk is made so it can not leak, and geometrically so appends stay linear
+            if (chunks_.size() == chunks_.capacity())
+                chunks_.reserve(std::max<size_t>(2 * chunks_.capacity(), 1));
+            chunks_.emplace_back(make_chunk());
+        }
+        return &chunks_[chunk][size_ % ChunkSize];
+    }
+
+    T* make_chunk() {
+        auto chunk = traits::allocate(allocator_, ChunkSize);
+        for (size_t i = 0; i < ChunkSize; i++)
+            traits::construct(allocator_, chunk + i);
+        return chunk;
+    }
+
+    void free_chunks() {
+        for (auto chunk : chunks_) {
+            for (size_t i = 0; i < ChunkSize; i++)
+                traits::destroy(allocator_, chunk + i);
+            traits::deallocate(allocator_, chunk, ChunkSize);
+        }
+        chunks_.clear();
+    }
+
+public:
+
+    /**
+     * \brief Forward iterator over all elements, chunk by chunk
+     */
+    class const_iterator {
+
+        const ChunkedVector* owner_;
+
+        size_t index_;
+
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator(const ChunkedVector* owner, size_t index)
+            : owner_(owner)
+              , index_(index) { }
+
+        reference operator*() const {
+            return (*owner_)[index_];
+        }
+
+        pointer operator->() const {
+            return &(*owner_)[index_];
+        }
+
+        const_iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            ++index_;
+            return tmp;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return index_ == other.index_ && owner_ == other.owner_;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    ChunkedVector() = default;
+
+    explicit ChunkedVector(const Allocator& allocator)
+        : allocator_(allocator)
+          , chunks_(chunk_list_allocator(allocator)) { }
+
+    ChunkedVector(ChunkedVector&& other) noexcept
+        : allocator_(other.allocator_)
+          , chunks_(std::move(other.chunks_))
+          , size_(other.size_) {
+        other.chunks_.clear();
+        other.size_ = 0;
+    }
+
+    ChunkedVector& operator=(ChunkedVector&& other) noexcept {
+        if (this != &other) {
+            free_chunks();
+            allocator_ = other.allocator_;
+            chunks_ = std::move(other.chunks_);
+            size_ = other.size_;
+            other.chunks_.clear();
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    ~ChunkedVector() {
+        free_chunks();
+    }
+
+    ChunkedVector(const ChunkedVector&) = delete;
+
+    ChunkedVector& operator=(const ChunkedVector&) = delete;
+
+    void push_back(const T& value) {
+        *slot() = value;
+        ++size_;
+    }
+
+    /**
+     * \brief Appends a range, filling the current chunk before starting a new one
+     * \param first The first element
+     * \param last One past the last element
+     */
+    template <typename It>
+    void append(It first, It last) {
+        while (first != last) {
+            auto target = slot();
+            auto room = ChunkSize - size_ % ChunkSize;
+            for (; room > 0 && first != last; --room, ++first, ++target, ++size_)
+                *target = *first;
+        }
+    }
+
+    template <typename Container>
+    void append(const Container& source) {
+        append(std::begin(source), std::end(source));
+    }
+
+    const T& operator[](size_t index) const {
+        return chunks_[index / ChunkSize][index % ChunkSize];
+    }
+
+    T& operator[](size_t index) {
+        return chunks_[index / ChunkSize][index % ChunkSize];
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    /**
+     * \brief Removes all elements, the chunks are kept for reuse
+     */
+    void clear() {
+        size_ = 0;
+    }
+
+    /**
+     * \brief Removes all elements and releases the chunks
+     */
+    void release() {
+        size_ = 0;
+        free_chunks();
+        chunks_.shrink_to_fit();
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, size_);
+    }
+
+    /**
+     * \brief Calls func(const T* data, size_t count) for each used part of a chunk, in order
+     */
+    template <typename Func>
+    void for_each_chunk(Func func) const {
+        auto remaining = size_;
+        for (size_t i = 0; remaining > 0; i++) {
+            auto count = std::min(remaining, ChunkSize);
+            func(chunks_[i], count);
+            remaining -= count;
+        }
+    }
+
+    /**
+     * \brief Copies all elements into a contiguous vector, replacing its content
+     * \param output The vector to copy to, its capacity is reused, any allocator
+     */
+    template <typename Vector>
+    void flatten(Vector& output) const {
+        output.clear();
+        output.reserve(size_);
+        for_each_chunk([&output](const T* data, size_t count) {
+            output.insert(output.end(), data, data + count);
+        });
+    }
+
+    std::vector<T> flatten() const {
+        std::vector<T> output;
+        flatten(output);
+        return output;
+    }
+
+};
@@ -0,0 +1,196 @@
+#include "HugePageAllocator.h"
+#include <cstdlib>
+#include <opencv2/core.hpp>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+    // marks the matrix data headers whose buffer is a block
+    constexpr int block_flag = 0x48554745;
+
+    constexpr size_t page_size = 4096;
+
+    /**
+     * \brief The alignment and size granularity of a block, only depends on the size so it is the same when freed
+     */
+    size_t block_alignment(size_t size) {
+        auto huge_page = HugePageAllocator::huge_page_size();
+        return huge_page > 0 && size >= huge_page ? huge_page : page_size;
+    }
+
+#if defined(_WIN32)
+
+    /**
+     * \brief Large pages on Windows require the lock pages in memory right to be enabled for the process
+     */
+    bool enable_lock_memory_privilege() {
+        HANDLE token;
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+            return false;
+
+        TOKEN_PRIVILEGES privileges;
+        privileges.PrivilegeCount = 1;
+        privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+        auto ok = LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid)
+                && AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr)
+                && GetLastError() == ERROR_SUCCESS;
+
+        CloseHandle(token);
+        return ok;
+    }
+
+    bool large_pages_allowed() {
+        static const auto allowed = GetLargePageMinimum() > 0 && enable_lock_memory_privilege();
+        return allowed;
+    }
+
+#endif
+
+}
+
+HugePageAllocator::HugePageAllocator()
+    : enabled_(true)
+      , min_size_(1 << 20)
+      , block_bytes_(0) { }
+
+HugePageAllocator* HugePageAllocator::instance() {
+    static HugePageAllocator allocator;
+    return &allocator;
+}
+
+size_t HugePageAllocator::huge_page_size() {
+#if defined(_WIN32)
+    return large_pages_allowed() ? GetLargePageMinimum() : 0;
+#elif defined(__linux__) && defined(MADV_HUGEPAGE)
+    return 2 << 20;
+#else
+    return 0;
+#endif
+}
+
+bool HugePageAllocator::enabled() const {
+    return enabled_;
+}
+
+void HugePageAllocator::enabled(bool enabled) {
+    enabled_ = enabled;
+}
+
+size_t HugePageAllocator::min_size() const {
+    return min_size_;
+}
+
+void HugePageAllocator::min_size(size_t min_size) {
+    min_size_ = min_size;
+}
+
+size_t HugePageAllocator::block_bytes() const {
+    return block_bytes_;
+}
+
+void* HugePageAllocator::allocate_block(size_t size) const {
+    auto alignment = block_alignment(size);
+    auto rounded = cv::alignSize(size, static_cast<int>(alignment));
+    auto huge = enabled_ && alignment > page_size;
+
+    void* block = nullptr;
+
+#if defined(_WIN32)
+    if (huge)
+        block = VirtualAlloc(nullptr, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    // no large pages left, regular pages are still page aligned
+    if (!block)
+        block = VirtualAlloc(nullptr, rounded, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+    if (posix_memalign(&block, alignment, rounded) != 0)
+        block = nullptr;
+#if defined(MADV_HUGEPAGE)
+    // fails when transparent huge pages are disabled, the block then simply uses regular pages
+    if (block && huge)
+        madvise(block, rounded, MADV_HUGEPAGE);
+#endif
+#else
+    (void)huge;
+    block = cv::fastMalloc(rounded);
+#endif
+
+    if (!block)
+        CV_Error(cv::Error::StsNoMem, cv::format("Failed to allocate %i bytes.", static_cast<int>(rounded)));
+
+    block_bytes_ += rounded;
+
+    return block;
+}
+
+void HugePageAllocator::free_block(void* block, size_t size) const {
+    if (!block)
+        return;
+
+#if defined(_WIN32)
+    VirtualFree(block, 0, MEM_RELEASE);
+#elif defined(__linux__)
+    free(block);
+#else
+    cv::fastFree(block);
+#endif
+
+    block_bytes_ -= cv::alignSize(size, static_cast<int>(block_alignment(size)));
+}
+
+cv::UMatData* HugePageAllocator::allocate(int dims, const int* sizes, int type, void* data, size_t* step, int /*flags*/, cv::UMatUsageFlags /*usage_flags*/) const {
+    // same layout as the default allocator
+    size_t total = CV_ELEM_SIZE(type);
+    for (auto i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data && step[i] != CV_AUTOSTEP) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            } else
+                step[i] = total;
+        }
+        total *= sizes[i];
+    }
+
+    auto u = new cv::UMatData(this);
+    u->size = total;
+
+    if (data) {
+        u->data = u->origdata = static_cast<uchar*>(data);
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+    } else if (total >= min_size_) {
+        u->data = u->origdata = static_cast<uchar*>(allocate_block(total));
+        u->allocatorFlags_ = block_flag;
+    } else
+        u->data = u->origdata = static_cast<uchar*>(cv::fastMalloc(total));
+
+    return u;
+}
+
+bool HugePageAllocator::allocate(cv::UMatData* data, int /*access_flags*/, cv::UMatUsageFlags /*usage_flags*/) const {
+    return data != nullptr;
+}
+
+void HugePageAllocator::deallocate(cv::UMatData* data) const {
+    if (!data)
+        return;
+
+    CV_Assert(data->urefcount == 0 && data->refcount == 0);
+
+    if (!(data->flags & cv::UMatData::USER_ALLOCATED)) {
+        if (data->allocatorFlags_ == block_flag)
+            free_block(data->origdata, data->size);
+        else
+            cv::fastFree(data->origdata);
+    }
+
+    delete data;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <opencv2/core/mat.hpp>
+
+/**
+ * \brief Serves large buffers from huge pages to reduce TLB misses on full frames and frame stacks.
+ * Buffers of at least min_size() bytes are page aligned blocks, blocks of at least one huge page are rounded up
+ * to whole huge pages. When huge pages are enabled, those are backed by huge pages where the system allows it:
+ * madvise(MADV_HUGEPAGE) on Linux, and MEM_LARGE_PAGES on Windows if the process holds SeLockMemoryPrivilege.
+ * If huge pages are not available, the block silently uses regular pages. Smaller buffers use cv::fastMalloc.
+ * Used as the allocator of a cv::Mat, or through allocate_block() for buffers that are not matrices.
+ */
+class HugePageAllocator : public cv::MatAllocator {
+
+    std::atomic<bool> enabled_;
+
+    std::atomic<size_t> min_size_;
+
+    // bytes currently allocated as blocks
+    mutable std::atomic<size_t> block_bytes_;
+
+    HugePageAllocator();
+
+public:
+
+    /**
+     * \brief The process wide allocator, huge pages are enabled by default
+     */
+    static HugePageAllocator* instance();
+
+    /**
+     * \brief The huge page size of the system
+     * \return The size in bytes, 0 if huge pages are not supported
+     */
+    static size_t huge_page_size();
+
+    HugePageAllocator(const HugePageAllocator&) = delete;
+
+    HugePageAllocator& operator=(const HugePageAllocator&) = delete;
+
+    bool enabled() const;
+
+    /**
+     * \brief Enables or disables huge pages for new blocks, existing blocks are not affected
+     */
+    void enabled(bool enabled);
+
+    size_t min_size() const;
+
+    /**
+     * \brief Sets the smallest matrix buffer that is allocated as a block
+     */
+    void min_size(size_t min_size);
+
+    size_t block_bytes() const;
+
+    /**
+     * \brief Allocates a page aligned block, backed by huge pages if enabled and possible
+     * \param size The size in bytes
+     * \return The block, release it with free_block()
+     */
+    void* allocate_block(size_t size) const;
+
+    /**
+     * \brief Releases a block from allocate_block()
+     * \param block The block
+     * \param size The size given to allocate_block()
+     */
+    void free_block(void* block, size_t size) const;
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, int flags, cv::UMatUsageFlags usage_flags) const override;
+
+    bool allocate(cv::UMatData* data, int access_flags, cv::UMatUsageFlags usage_flags) const override;
+
+    void deallocate(cv::UMatData* data) const override;
+
+};
@@ -0,0 +1,349 @@
+#include "MemoryTracker.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <opencv2/core.hpp>
+
+#include <malloc.h>
+
+#ifdef _MSC_VER
+#define tracked_usable_size _msize
+#else
+#define tracked_usable_size malloc_usable_size
+#endif
+
+namespace {
+
+    constexpr int stage_count = static_cast<int>(MemoryStage::Count);
+
+    const char* stage_names[stage_count] = {
+        "other",
+        "marking rect",
+        "baselines",
+        "laser",
+        "seeker phase one",
+        "seeker phase two",
+        "seeker phase three",
+        "seeker finalize"
+    };
+
+    // a cache line each, so the workers of different stages do not invalidate each other's counters
+    struct alignas(64) Counters {
+        std::atomic<int64_t> current;
+        std::atomic<int64_t> peak;
+        std::atomic<int64_t> allocated;
+        std::atomic<int64_t> allocations;
+    };
+
+    struct alignas(64) Gauge {
+        std::atomic<int64_t> value;
+    };
+
+    struct alignas(64) Switch {
+        std::atomic<bool> on;
+    };
+
+    // static storage, so they are zero before the first operator new of the process
+    Counters heap_counters[stage_count];
+    Counters mat_counters[stage_count];
+    Counters total_counters;
+
+    // heap bytes in use by the process, as far as they went through operator new
+    Gauge heap_current;
+
+    // read on every allocation, so it shares its line with nothing that is written
+    Switch tracking;
+
+    // each thread measures in its own stage, constant initialized so it is valid before the first operator new
+    thread_local int active_stage = 0;
+
+    void raise_peak(Counters& counters, int64_t current) {
+        auto peak = counters.peak.load(std::memory_order_relaxed);
+        while (current > peak && !counters.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) { }
+    }
+
+    void add(Counters& counters, int64_t bytes) {
+        auto current = counters.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        counters.allocated.fetch_add(bytes, std::memory_order_relaxed);
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        raise_peak(counters, current);
+    }
+
+    void remove(Counters& counters, int64_t bytes) {
+        counters.current.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Counts an allocation against the active stage
+     * \return The stage, to hand back to released()
+     */
+    int allocated(Counters* stages, size_t bytes) {
+        auto stage = active_stage;
+        add(stages[stage], static_cast<int64_t>(bytes));
+        add(total_counters, static_cast<int64_t>(bytes));
+        return stage;
+    }
+
+    void released(Counters* stages, int stage, size_t bytes) {
+        remove(stages[stage], static_cast<int64_t>(bytes));
+        remove(total_counters, static_cast<int64_t>(bytes));
+    }
+
+    MemoryTracker::Usage usage(const Counters& counters) {
+        return MemoryTracker::Usage{
+            counters.current.load(std::memory_order_relaxed),
+            counters.peak.load(std::memory_order_relaxed),
+            counters.allocated.load(std::memory_order_relaxed),
+            counters.allocations.load(std::memory_order_relaxed)
+        };
+    }
+
+    void reset(Counters& counters) {
+        counters.peak.store(counters.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        counters.allocated.store(0, std::memory_order_relaxed);
+        counters.allocations.store(0, std::memory_order_relaxed);
+    }
+
+    // operator new
+
+    // The returned pointer is the one from malloc, so blocks allocated by the operator new of another module,
+    // like the OpenCV dlls resizing an output vector, can be freed here and the other way around.
+    // The size is taken from the heap itself, which also works for the blocks of the other modules as they share the crt heap.
+    // A block allocated in one module and freed in the other is only counted on one side, the current bytes drift by that much.
+
+    void* tracked_malloc(size_t size) noexcept {
+        auto memory = std::malloc(size);
+        if (!memory || !tracking.on.load(std::memory_order_relaxed))
+            return memory;
+
+        auto bytes = static_cast<int64_t>(tracked_usable_size(memory));
+        auto& counters = heap_counters[active_stage];
+        counters.current.fetch_add(bytes, std::memory_order_relaxed);
+        counters.allocated.fetch_add(bytes, std::memory_order_relaxed);
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        raise_peak(counters, heap_current.value.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+        add(total_counters, bytes);
+        return memory;
+    }
+
+    void tracked_free(void* memory) noexcept {
+        if (!memory)
+            return;
+
+        if (!tracking.on.load(std::memory_order_relaxed)) {
+            std::free(memory);
+            return;
+        }
+
+        // the freeing stage, the block has no record of the stage that allocated it
+        auto bytes = static_cast<int64_t>(tracked_usable_size(memory));
+        heap_counters[active_stage].current.fetch_sub(bytes, std::memory_order_relaxed);
+        heap_current.value.fetch_sub(bytes, std::memory_order_relaxed);
+        remove(total_counters, bytes);
+        std::free(memory);
+    }
+
+    void* tracked_new(size_t size) {
+        if (size == 0)
+            size = 1;
+
+        while (true) {
+            auto memory = tracked_malloc(size);
+            if (memory)
+                return memory;
+
+            auto handler = std::get_new_handler();
+            if (!handler)
+                throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    void* tracked_new(size_t size, const std::nothrow_t&) noexcept {
+        try {
+            return tracked_new(size);
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    // matrices
+
+    struct TrackedData : cv::UMatData {
+
+        int stage;
+
+        explicit TrackedData(const cv::MatAllocator* allocator)
+            : UMatData(allocator)
+              , stage(0) { }
+    };
+
+    /**
+     * \brief Same layout and memory as the default allocator, with the buffer counted against the active stage
+     */
+    class TrackingMatAllocator : public cv::MatAllocator {
+
+    public:
+
+        cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, int /*flags*/, cv::UMatUsageFlags /*usage_flags*/) const override {
+            size_t total = CV_ELEM_SIZE(type);
+            for (auto i = dims - 1; i >= 0; i--) {
+                if (step) {
+                    if (data && step[i] != CV_AUTOSTEP) {
+                        CV_Assert(total <= step[i]);
+                        total = step[i];
+                    } else
+                        step[i] = total;
+                }
+                total *= sizes[i];
+            }
+
+            auto u = new TrackedData(this);
+            u->size = total;
+
+            if (data) {
+                u->data = u->origdata = static_cast<uchar*>(data);
+                u->flags |= cv::UMatData::USER_ALLOCATED;
+            } else {
+                u->data = u->origdata = static_cast<uchar*>(cv::fastMalloc(total));
+                u->stage = allocated(mat_counters, total);
+            }
+
+            return u;
+        }
+
+        bool allocate(cv::UMatData* data, int /*access_flags*/, cv::UMatUsageFlags /*usage_flags*/) const override {
+            return data != nullptr;
+        }
+
+        void deallocate(cv::UMatData* data) const override {
+            if (!data)
+                return;
+
+            CV_Assert(data->urefcount == 0 && data->refcount == 0);
+
+            auto tracked = static_cast<TrackedData*>(data);
+
+            if (!(tracked->flags & cv::UMatData::USER_ALLOCATED)) {
+                cv::fastFree(tracked->origdata);
+                released(mat_counters, tracked->stage, tracked->size);
+            }
+
+            delete tracked;
+        }
+
+    };
+
+}
+
+void* operator new(size_t size) {
+    return tracked_new(size);
+}
+
+void* operator new[](size_t size) {
+    return tracked_new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t& tag) noexcept {
+    return tracked_new(size, tag);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return tracked_new(size, tag);
+}
+
+void operator delete(void* memory) noexcept {
+    tracked_free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    tracked_free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    tracked_free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    tracked_free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    tracked_free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    tracked_free(memory);
+}
+
+const char* MemoryTracker::name(MemoryStage stage) {
+    return stage_names[static_cast<int>(stage)];
+}
+
+void MemoryTracker::enabled(bool new_value) {
+    tracking.on.store(new_value, std::memory_order_relaxed);
+}
+
+bool MemoryTracker::enabled() {
+    return tracking.on.load(std::memory_order_relaxed);
+}
+
+MemoryStage MemoryTracker::stage() {
+    return static_cast<MemoryStage>(active_stage);
+}
+
+void MemoryTracker::stage(MemoryStage stage) {
+    CV_Assert(stage != MemoryStage::Count);
+    active_stage = static_cast<int>(stage);
+}
+
+MemoryTracker::Usage MemoryTracker::heap(MemoryStage stage) {
+    return usage(heap_counters[static_cast<int>(stage)]);
+}
+
+MemoryTracker::Usage MemoryTracker::mat(MemoryStage stage) {
+    return usage(mat_counters[static_cast<int>(stage)]);
+}
+
+MemoryTracker::Usage MemoryTracker::total() {
+    return usage(total_counters);
+}
+
+void MemoryTracker::reset_peaks() {
+    auto heap_now = heap_current.value.load(std::memory_order_relaxed);
+    for (auto i = 0; i < stage_count; i++) {
+        reset(heap_counters[i]);
+        heap_counters[i].peak.store(heap_now, std::memory_order_relaxed);
+        reset(mat_counters[i]);
+    }
+    reset(total_counters);
+}
+
+cv::MatAllocator* MemoryTracker::mat_allocator() {
+    static TrackingMatAllocator allocator;
+    return &allocator;
+}
+
+std::string MemoryTracker::report() {
+    std::string output = cv::format("%-20s %14s %14s %14s %14s %10s\n", "memory stage", "heap peak", "heap alloc", "mat peak", "mat alloc", "count");
+
+    for (auto i = 0; i < stage_count; i++) {
+        auto stage = static_cast<MemoryStage>(i);
+        auto h = heap(stage);
+        auto m = mat(stage);
+
+        if (h.allocations == 0 && m.allocations == 0)
+            continue;
+
+        output += cv::format("%-20s %14lld %14lld %14lld %14lld %10lld\n", name(stage),
+                             static_cast<long long>(h.peak), static_cast<long long>(h.allocated),
+                             static_cast<long long>(m.peak), static_cast<long long>(m.allocated),
+                             static_cast<long long>(h.allocations + m.allocations));
+    }
+
+    auto t = total();
+    output += cv::format("%-20s %14lld (current %lld)\n", "total peak", static_cast<long long>(t.peak), static_cast<long long>(t.current));
+
+    return output;
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <opencv2/core/mat.hpp>
+
+/**
+ * \brief The parts of a measurement memory is attributed to
+ */
+enum class MemoryStage : int {
+    Other,
+    MarkingRect,
+    BaseLines,
+    Laser,
+    SeekerPhaseOne,
+    SeekerPhaseTwo,
+    SeekerPhaseThree,
+    SeekerFinalize,
+    Count
+};
+
+/**
+ * \brief Process wide accounting of heap and matrix memory per measurement stage, off unless enabled (--track_memory).
+ * While enabled, every operator new and every matrix buffer from mat_allocator() is counted against the active stage of the allocating thread.
+ * Matrix buffers are released against the stage they were allocated in, so a stage holding matrices after it ends shows up as current bytes.
+ * Heap blocks carry no bookkeeping of their own, operator new hands out plain malloc blocks so they can cross module boundaries,
+ * so they are released against the stage active when they are freed. The heap current of a stage is therefore the net change
+ * while it was active, and is negative for a stage that frees more than it allocates, only the total current is the heap in use.
+ * The active stage is per thread, workers of a stage open a MemoryScope of their own. Within a thread the innermost MemoryScope wins.
+ * Matrices with their own allocator, like the frame stacks from HugePageAllocator, are not counted here.
+ */
+class MemoryTracker {
+
+public:
+
+    struct Usage {
+        // matrices : bytes allocated in the stage that are still held
+        // heap : bytes allocated minus bytes freed while the stage was active, whichever stage allocated them, may be negative
+        int64_t current;
+
+        // matrices : the highest current since the last reset_peaks()
+        // heap : the highest heap use of the process while the stage was active, since the last reset_peaks()
+        int64_t peak;
+
+        // bytes allocated since the last reset_peaks()
+        int64_t allocated;
+
+        // number of allocations since the last reset_peaks()
+        int64_t allocations;
+    };
+
+    MemoryTracker() = delete;
+
+    static const char* name(MemoryStage stage);
+
+    /**
+     * \brief Turns the counting on or off, off by default so operator new costs no more than malloc.
+     * Turn it on at startup before other threads run, blocks allocated while it was off are subtracted when freed.
+     */
+    static void enabled(bool new_value);
+
+    static bool enabled();
+
+    static MemoryStage stage();
+
+    /**
+     * \brief Sets the active stage, prefer MemoryScope
+     */
+    static void stage(MemoryStage stage);
+
+    /**
+     * \brief The operator new usage of a stage
+     */
+    static Usage heap(MemoryStage stage);
+
+    /**
+     * \brief The matrix buffer usage of a stage
+     */
+    static Usage mat(MemoryStage stage);
+
+    /**
+     * \brief The combined heap and matrix usage of all stages
+     */
+    static Usage total();
+
+    /**
+     * \brief Starts a new measurement, peaks are lowered to the current bytes and the allocation counts cleared
+     */
+    static void reset_peaks();
+
+    /**
+     * \brief The counting matrix allocator, install it with cv::Mat::setDefaultAllocator()
+     */
+    static cv::MatAllocator* mat_allocator();
+
+    /**
+     * \brief Formats the usage of every stage that allocated since the last reset_peaks()
+     */
+    static std::string report();
+
+};
+
+/**
+ * \brief Makes a stage active for the lifetime of the scope
+ */
+class MemoryScope {
+
+    MemoryStage previous_;
+
+public:
+
+    explicit MemoryScope(MemoryStage stage)
+        : previous_(MemoryTracker::stage()) {
+        MemoryTracker::stage(stage);
+    }
+
+    ~MemoryScope() {
+        MemoryTracker::stage(previous_);
+    }
+
+    MemoryScope(const MemoryScope&) = delete;
+
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+};
@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * \brief Bounded lock-free ring between one producer thread and one consumer thread.
+ * Each slot carries a sequence number, so a slot is only written once it has been read and only read once written,
+ * no locks are taken on either side. The capacity is rounded up to a power of two.
+ * push_drop_oldest() lets the producer discard the oldest element when the ring is full,
+ * the pop it uses for that is safe against the concurrent pop of the consumer.
+ * \tparam T The element type, must be default constructible and move assignable
+ */
+template <typename T>
+class SpscRing {
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+
+    size_t mask_;
+
+    // the producer and consumer positions are kept on their own cache lines
+    char pad0_[64];
+
+    // next position to write, only changed by the producer
+    std::atomic<size_t> head_;
+
+    char pad1_[64];
+
+    // next position to read
+    std::atomic<size_t> tail_;
+
+    char pad2_[64];
+
+    std::atomic<size_t> dropped_;
+
+    static size_t round_up(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        return size;
+    }
+
+public:
+
+    explicit SpscRing(size_t capacity)
+        : slots_(std::make_unique<Slot[]>(round_up(capacity)))
+          , mask_(round_up(capacity) - 1)
+          , head_(0)
+          , tail_(0)
+          , dropped_(0) {
+        for (size_t i = 0; i <= mask_; i++)
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * \brief Adds an element, producer only
+     * \param value The element, only moved from if it was added
+     * \return false if the ring is full
+     */
+    bool try_push(T&& value) {
+        auto pos = head_.load(std::memory_order_relaxed);
+        auto& slot = slots_[pos & mask_];
+
+        if (slot.sequence.load(std::memory_order_acquire) != pos)
+            return false;
+
+        slot.value = std::move(value);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * \brief Adds an element, discarding the oldest elements while the ring is full, producer only
+     * \return The number of elements discarded
+     */
+    size_t push_drop_oldest(T&& value) {
+        size_t dropped = 0;
+        T discarded;
+        while (!try_push(std::move(value))) {
+            // the consumer may be reading the oldest slot, then the next attempt finds room
+            if (try_pop(discarded))
+                ++dropped;
+        }
+        dropped_.fetch_add(dropped, std::memory_order_relaxed);
+        return dropped;
+    }
+
+    /**
+     * \brief Takes the oldest element
+     * \param value Receives the element
+     * \return false if the ring is empty
+     */
+    bool try_pop(T& value) {
+        auto pos = tail_.load(std::memory_order_relaxed);
+
+        while (true) {
+            auto& slot = slots_[pos & mask_];
+            auto diff = static_cast<intptr_t>(slot.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos + 1);
+
+            if (diff < 0)
+                return false;
+
+            if (diff == 0 && tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                value = std::move(slot.value);
+                // releases what the moved from element still holds before the slot is handed back
+                slot.value = T();
+                slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+
+            if (diff > 0)
+                pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * \brief The number of elements, only a snapshot while the other side is active
+     */
+    size_t size() const {
+        // tail first, it never passes head
+        auto tail = tail_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_acquire) - tail;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_t capacity() const {
+        return mask_ + 1;
+    }
+
+    /**
+     * \brief The number of elements discarded by push_drop_oldest()
+     */
+    size_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+};
@@ -33,60 +33,52 @@
 
 #pragma once
 
+#include <cmath>
+#include <cstddef>
+#include <functional>
 #include <ostream>
+#include <type_traits>
 
 using namespace std;
 
-template <typename T>
-class v2 {
+// The vector types are plain values: no virtual functions and all components in the same class,
+// so they are trivially copyable, standard layout and without padding.
+// A contiguous array of them can be copied with memcpy and processed as a flat array of components,
+// see the span functions at the end.
+// Align raises the alignment of the whole vector, e.g. 16 lets a v4<float> load as a single SSE register and never
+// straddle a cache line. An alignment above the size pads the vector, which the span functions refuse.
+
+template <typename T, std::size_t Align = alignof(T)>
+class alignas(Align) v2 {
 public:
-    virtual ~v2() = default;
 
-    v2(T x1, T y1, T x2, T y2) {
-        x = x2 - x1;
-        y = y2 - y1;
-    }
+    v2(T x1, T y1, T x2, T y2)
+        : x(x2 - x1)
+        , y(y2 - y1) { }
 
-    v2(T x_, T y_) {
-        x = x_;
-        y = y_;
-    }
+    v2(T x_, T y_)
+        : x(x_)
+        , y(y_) { }
 
-    v2(const v2& other)
-        : x(other.x)
-        , y(other.y) { }
+    v2()
+        : x(0)
+        , y(0) { }
 
-    v2(v2&& other) noexcept
-        : x(std::move(other.x))
-        , y(std::move(other.y)) { }
+    v2(const v2& other) = default;
 
-    v2& operator=(const v2& other) {
-        if (this == &other)
-            return *this;
-        x = other.x;
-        y = other.y;
-        return *this;
-    }
+    v2(v2&& other) noexcept = default;
 
-    v2& operator=(v2&& other) noexcept {
-        if (this == &other)
-            return *this;
-        x = std::move(other.x);
-        y = std::move(other.y);
-        return *this;
-    }
+    v2& operator=(const v2& other) = default;
 
-    v2() {
-        x = 0;
-        y = 0;
-    }
+    v2& operator=(v2&& other) noexcept = default;
+
+    ~v2() = default;
 
     // OpenCV copy constructor
 #ifdef CV_VERSION
-    explicit v2(cv::Point_<T>& p) {
-        x = p.x;
-        y = p.y;
-    }
+    explicit v2(cv::Point_<T>& p)
+        : x(p.x)
+        , y(p.y) { }
 
     template <typename Y>
     explicit v2(cv::Point_<Y>& p) {
@@ -95,24 +87,23 @@ public:
         y = static_cast<T>(p.y);
     }
 
-    explicit v2(cv::Vec<T, 2>& p) {
-        x = p[0];
-        y = p[1];
-    }
+    explicit v2(cv::Vec<T, 2>& p)
+        : x(p[0])
+        , y(p[1]) { }
 
     template <typename Y>
-    explicit v2(cv::Vec<T, 2>& p) {
+    explicit v2(cv::Vec<Y, 2>& p) {
         static_assert(std::is_convertible<Y, T>::value, "Invalid type.");
-        x = static_cast<T>(p.x);
-        y = static_cast<T>(p.y);
+        x = static_cast<T>(p[0]);
+        y = static_cast<T>(p[1]);
     }
 
-    v2 operator+(const cv::Point_<T>& that) {
-        return v2<T>(x + that.x, y + that.y);
+    v2 operator+(const cv::Point_<T>& that) const {
+        return v2(x + that.x, y + that.y);
     }
 
-    v2 operator+(const cv::Vec<T, 2>& that) {
-        return v2<T>(x + that.x, y + that.y);
+    v2 operator+(const cv::Vec<T, 2>& that) const {
+        return v2(x + that[0], y + that[1]);
     }
 
 #endif
@@ -129,8 +120,8 @@ public:
         return !(lhs == rhs);
     }
 
-    v2 operator+(const v2& that) {
-        return v2<T>(x + that.x, y + that.y);
+    v2 operator+(const v2& that) const {
+        return v2(x + that.x, y + that.y);
     }
 
     void operator+=(const v2& that) {
@@ -138,8 +129,8 @@ public:
         this->y += that.y;
     }
 
-    v2 operator-(const v2& that) {
-        return v2<T>(x - that.x, y - that.y);
+    v2 operator-(const v2& that) const {
+        return v2(x - that.x, y - that.y);
     }
 
     void operator-=(const v2& that) {
@@ -147,18 +138,18 @@ public:
         this->y -= that.y;
     }
 
-    T operator*(const v2& that) {
+    T operator*(const v2& that) const {
         // Operator : Scalarproduct (dotproduct)
         return (x * that.x) + (y * that.y);
     }
 
-    virtual v2 operator*(const T& k) {
-        return v2<T>(k * x, k * y);
+    v2 operator*(const T& k) const {
+        return v2(k * x, k * y);
     }
 
     void operator*=(const v2& that) {
-        this->x *= that->x;
-        this->y *= that->y;
+        this->x *= that.x;
+        this->y *= that.y;
     }
 
     template <typename Y>
@@ -168,131 +159,113 @@ public:
         this->y *= k;
     }
 
-    template <typename Y>
-    bool operator/(const v2<Y>& that) {
-        static_assert(std::is_arithmetic<Y>::value, "Not a valid type");
-        return this * that == 0 ? true : false;
-    }
-
-    template <typename Y>
-    bool operator<(const v2& that) {
-        static_assert(std::is_arithmetic<Y>::value, "Not a valid type");
+    bool operator<(const v2& that) const {
         return len() < that.len();
     }
 
-    template <typename Y>
-    bool operator>(const v2& that) {
+    bool operator>(const v2& that) const {
         return len() > that.len();
     }
 
-    bool operator==(const v2& that) {
-        return x == that.x & y == that.y;
-    }
-
     void operator!() {
         x = -x;
         y = -y;
     }
 
-    v2 project_onto(const v2& that) {
-        return this * (v2(x, y) * that / pow(len(), 2));
+    v2 project_onto(const v2& that) const {
+        return that * ((*this * that) / (that * that));
     }
 
-    T project_len(const v2& that) {
-        return abs(v2(x, y) * that / len());
+    T project_len(const v2& that) const {
+        return std::abs(*this * that / that.len());
     }
 
-    T angle(const v2& that) {
-        return (this * that) / (len() * that.len());
+    T angle(const v2& that) const {
+        return (*this * that) / (len() * that.len());
     }
 
-    virtual T len() const {
-        return static_cast<T>(abs(sqrt((x * x) + (y * y))));
+    T len() const {
+        return static_cast<T>(std::sqrt((x * x) + (y * y)));
     }
 
-    v2 cross() {
-        return v2<T>(-y, x);
+    v2 cross() const {
+        return v2(-y, x);
     }
 
-    void crossTo(v2& that) {
+    void crossTo(v2& that) const {
         that.x = -this->y;
         that.y = this->x;
     }
 
-    T det(const v2& that) {
+    T det(const v2& that) const {
         return cross() * that;
     }
 
-    int parallel(const v2& that) {
+    int parallel(const v2& that) const {
         return det(that) == 0 ? 1 : 0;
     }
 
-    virtual bool real() {
+    bool real() const {
         return this->x + this->y == 0;
     }
 
     friend std::size_t hash_value(const v2& obj) {
         std::size_t seed = 0x379D1D39;
-        seed ^= (seed << 6) + (seed >> 2) + 0x6689D690 + hash_value(obj.x);
-        seed ^= (seed << 6) + (seed >> 2) + 0x4ABF5DE9 + hash_value(obj.y);
+        seed ^= (seed << 6) + (seed >> 2) + 0x6689D690 + std::hash<T>()(obj.x);
+        seed ^= (seed << 6) + (seed >> 2) + 0x4ABF5DE9 + std::hash<T>()(obj.y);
         return seed;
     }
 
 };
 
-template <class T>
-ostream& operator<<(ostream& stream, v2<T> v) {
+template <class T, std::size_t Align>
+ostream& operator<<(ostream& stream, const v2<T, Align>& v) {
     stream << '[' << v.x << ',' << v.y << ']';
     return stream;
 }
 
-template <class T>
-class v3 : public v2<T> {
+template <class T, std::size_t Align = alignof(T)>
+class alignas(Align) v3 {
 public:
 
     v3(T x1, T y1, T z1, T x2, T y2, T z2)
-        : v2<T>(x1, y1, x2, y2) {
-        z = z2 - z1;
-    }
+        : x(x2 - x1)
+        , y(y2 - y1)
+        , z(z2 - z1) { }
 
     v3(T x_, T y_, T z_)
-        : v2<T>(x_, y_) {
-        z = z_;
-    }
+        : x(x_)
+        , y(y_)
+        , z(z_) { }
 
     v3()
-        : v2<T>(0, 0) {
-        z = 0;
-    }
+        : x(0)
+        , y(0)
+        , z(0) { }
 
-    v3(const v3& other)
-        : v2<T>(other)
-        , z(other.z) { }
+    v3(const v3& other) = default;
 
-    v3(v3&& other) noexcept
-        : v2<T>(std::move(other))
-        , z(std::move(other.z)) { }
+    v3(v3&& other) noexcept = default;
 
-    v3& operator=(const v3& other) {
-        if (this == &other)
-            return *this;
-        v2<T>::operator =(other);
-        z = other.z;
-        return *this;
-    }
+    v3& operator=(const v3& other) = default;
 
-    v3& operator=(v3&& other) noexcept {
-        if (this == &other)
-            return *this;
-        v2<T>::operator =(std::move(other));
-        z = std::move(other.z);
-        return *this;
-    }
+    v3& operator=(v3&& other) noexcept = default;
+
+    ~v3() = default;
+
+    T x;
+
+    T y;
 
     T z;
 
+    v2<T> xy() const {
+        return v2<T>(x, y);
+    }
+
     friend bool operator==(const v3& lhs, const v3& rhs) {
-        return static_cast<const v2<T>&>(lhs) == static_cast<const v2<T>&>(rhs)
+        return lhs.x == rhs.x
+                && lhs.y == rhs.y
                 && lhs.z == rhs.z;
     }
 
@@ -300,106 +273,119 @@ public:
         return !(lhs == rhs);
     }
 
-    virtual v3 operator+(const v3& that) {
-        return v3<T>(this->x + that.x, this->y + that.y, this->z + that.z);
+    v3 operator+(const v3& that) const {
+        return v3(this->x + that.x, this->y + that.y, this->z + that.z);
     }
 
-    v3 operator-(const v3& that) {
-        return v3<T>(this->x - that.x, this->y - that.y, this->z - that.z);
+    void operator+=(const v3& that) {
+        this->x += that.x;
+        this->y += that.y;
+        this->z += that.z;
+    }
+
+    v3 operator-(const v3& that) const {
+        return v3(this->x - that.x, this->y - that.y, this->z - that.z);
+    }
+
+    void operator-=(const v3& that) {
+        this->x -= that.x;
+        this->y -= that.y;
+        this->z -= that.z;
     }
 
     // Operator : Scalarproduct (dotproduct)
-    //T operator*(const v3 &that) override {
-    //	return (this->x * that.x) + (this->y * that.y) + (this->z * that.z);
-    //}
+    T operator*(const v3& that) const {
+        return (this->x * that.x) + (this->y * that.y) + (this->z * that.z);
+    }
 
-    v3 operator*(const double k) {
-        return v3<T>(static_cast<T>(k * this->x), static_cast<T>(k * this->y), static_cast<T>(k * this->z));
+    v3 operator*(const double k) const {
+        return v3(static_cast<T>(k * this->x), static_cast<T>(k * this->y), static_cast<T>(k * this->z));
     }
 
-    T len() const override {
-        return abs(sqrt(this->x * this->x + this->y * this->y + this->z * this->z));
+    T len() const {
+        return static_cast<T>(std::sqrt(this->x * this->x + this->y * this->y + this->z * this->z));
     }
 
-    v3 cross(const v3& that) {
-        return v3<T>(this->y * that.z - this->z * this->y, this->z * that.x - this->x * that.z, this->x * that.y - that.y - this->x);
+    v3 cross(const v3& that) const {
+        return v3(this->y * that.z - this->z * that.y, this->z * that.x - this->x * that.z, this->x * that.y - this->y * that.x);
     }
 
-    T parallelogram_area(const v3& that) {
-        return abs(cross(that).len());
+    T parallelogram_area(const v3& that) const {
+        return std::abs(cross(that).len());
     }
 
-    T angle(const v3& that) {
-        return v3<T>(this->x, this->y, this->z) * that / (len() * that.len());
+    T angle(const v3& that) const {
+        return (*this * that) / (len() * that.len());
     }
 
-    bool real() override {
+    bool real() const {
         return this->x + this->y + this->z == 0;
     }
 
     friend std::size_t hash_value(const v3& obj) {
         std::size_t seed = 0x021F39B2;
-        seed ^= (seed << 6) + (seed >> 2) + 0x0AB3178C + hash_value(static_cast<const v2<T>&>(obj));
-        seed ^= (seed << 6) + (seed >> 2) + 0x41691B84 + hash_value(obj.z);
+        seed ^= (seed << 6) + (seed >> 2) + 0x0AB3178C + hash_value(obj.xy());
+        seed ^= (seed << 6) + (seed >> 2) + 0x41691B84 + std::hash<T>()(obj.z);
         return seed;
     }
 };
 
-template <class T>
-ostream& operator<<(ostream& stream, v3<T> v) {
+template <class T, std::size_t Align>
+ostream& operator<<(ostream& stream, const v3<T, Align>& v) {
     stream << '[' << v.x << ',' << v.y << ',' << v.z << ']';
     return stream;
 }
 
 /////////////////////////////////////
 
-template <class T>
-class v4 : public v3<T> {
+template <class T, std::size_t Align = alignof(T)>
+class alignas(Align) v4 {
 public:
 
     v4(T x1, T y1, T z1, T w1, T x2, T y2, T z2, T w2)
-        : v3<T>(x1, y1, z1, x2, y2, z2) {
-        w = z2 - z1;
-    }
+        : x(x2 - x1)
+        , y(y2 - y1)
+        , z(z2 - z1)
+        , w(w2 - w1) { }
 
     v4(T x_, T y_, T z_, T w_)
-        : v3<T>(x_, y_, z_) {
-        w = w_;
-    }
+        : x(x_)
+        , y(y_)
+        , z(z_)
+        , w(w_) { }
 
     v4()
-        : v3<T>(0, 0, 0) {
-        w = 0;
-    }
+        : x(0)
+        , y(0)
+        , z(0)
+        , w(0) { }
 
-    v4(const v4& other)
-        : v3<T>(other)
-        , w(other.w) { }
+    v4(const v4& other) = default;
 
-    v4(v4&& other) noexcept
-        : v3<T>(std::move(other))
-        , w(std::move(other.w)) { }
+    v4(v4&& other) noexcept = default;
 
-    v4& operator=(const v4& other) {
-        if (this == &other)
-            return *this;
-        v3<T>::operator =(other);
-        w = other.w;
-        return *this;
-    }
+    v4& operator=(const v4& other) = default;
 
-    v4& operator=(v4&& other) noexcept {
-        if (this == &other)
-            return *this;
-        v3<T>::operator =(std::move(other));
-        w = std::move(other.w);
-        return *this;
-    }
+    v4& operator=(v4&& other) noexcept = default;
+
+    ~v4() = default;
+
+    T x;
+
+    T y;
+
+    T z;
 
     T w;
 
+    v3<T> xyz() const {
+        return v3<T>(x, y, z);
+    }
+
     friend bool operator==(const v4& lhs, const v4& rhs) {
-        return static_cast<const v3<T>&>(lhs) == static_cast<const v3<T>&>(rhs)
+        return lhs.x == rhs.x
+                && lhs.y == rhs.y
+                && lhs.z == rhs.z
                 && lhs.w == rhs.w;
     }
 
@@ -407,53 +393,152 @@ public:
         return !(lhs == rhs);
     }
 
-    v4 operator+(const v4& that) {
-        return v4<T>(this->x + that.x, this->y + that.y, this->z + that.z, this->w + that.w);
+    v4 operator+(const v4& that) const {
+        return v4(this->x + that.x, this->y + that.y, this->z + that.z, this->w + that.w);
     }
 
-    v4 operator-(const v4& that) {
-        return v4<T>(this->x - that.x, this->y - that.y, this->z - that.z, this->w - that.w);
+    v4 operator-(const v4& that) const {
+        return v4(this->x - that.x, this->y - that.y, this->z - that.z, this->w - that.w);
     }
 
     // Operator : Scalarproduct (dotproduct)
-    T operator*(const v4& that) override {
-        return (this->x * that.x) + (this->y * that.y) + (this->z * that.z) + (this->w * that->w);
-    }
-
-    v4 operator*(const double k) {
-        return v4<T>(static_cast<T>(k * this->x), static_cast<T>(k * this->y), static_cast<T>(k * this->z), static_cast<T>(k * this->w));
-    }
-
-    T len() const override {
-        return abs(sqrt(this->x * this->x + this->y * this->y + this->z * this->z));
-    }
-
-    v4 cross(const v4& that) {
-        return v4<T>(this->y * that.z - this->z * this->y, this->z * that.x - this->x * that.z, this->x * that.y - that.y - this->x);
+    T operator*(const v4& that) const {
+        return (this->x * that.x) + (this->y * that.y) + (this->z * that.z) + (this->w * that.w);
     }
 
-    T parallelogram_area(const v4& that) {
-        return abs(cross(that).len());
+    v4 operator*(const double k) const {
+        return v4(static_cast<T>(k * this->x), static_cast<T>(k * this->y), static_cast<T>(k * this->z), static_cast<T>(k * this->w));
     }
 
-    T angle(const v4& that) {
-        return v4<T>(this->x, this->y, this->z) * that / (len() * that.len());
+    T len() const {
+        return static_cast<T>(std::sqrt(this->x * this->x + this->y * this->y + this->z * this->z + this->w * this->w));
     }
 
-    bool real() override {
+    bool real() const {
         return this->x == 0 || this->y == 0 || this->z == 0 || this->w == 0;
     }
 
     friend std::size_t hash_value(const v4& obj) {
         std::size_t seed = 0x021F39B2;
-        seed ^= (seed << 6) + (seed >> 2) + 0x0AB3178C + hash_value(static_cast<const v3<T>&>(obj));
-        seed ^= (seed << 6) + (seed >> 2) + 0x41691B84 + hash_value(obj.w);
+        seed ^= (seed << 6) + (seed >> 2) + 0x0AB3178C + hash_value(obj.xyz());
+        seed ^= (seed << 6) + (seed >> 2) + 0x41691B84 + std::hash<T>()(obj.w);
         return seed;
     }
 };
 
-template <class T>
-ostream& operator<<(ostream& stream, v4<T> v) {
+template <class T, std::size_t Align>
+ostream& operator<<(ostream& stream, const v4<T, Align>& v) {
     stream << '[' << v.x << ',' << v.y << ',' << v.z << ',' << v.w << ']';
     return stream;
 }
+
+/**
+ * \brief v4 aligned to 16 bytes, four floats fill one SSE register
+ */
+template <class T>
+using v4a = v4<T, 16>;
+
+static_assert(std::is_trivially_copyable<v2<float>>::value && std::is_standard_layout<v2<float>>::value, "v2 must stay a plain value.");
+static_assert(std::is_trivially_copyable<v3<float>>::value && std::is_standard_layout<v3<float>>::value, "v3 must stay a plain value.");
+static_assert(std::is_trivially_copyable<v4<float>>::value && std::is_standard_layout<v4<float>>::value, "v4 must stay a plain value.");
+static_assert(sizeof(v2<float>) == 2 * sizeof(float) && sizeof(v4<float>) == 4 * sizeof(float), "Vector types must not be padded.");
+static_assert(alignof(v2<float>) == alignof(float) && alignof(v3<float>) == alignof(float) && alignof(v4<float>) == alignof(float), "Vector types keep the alignment of their components by default.");
+static_assert(alignof(v4a<float>) == 16 && sizeof(v4a<float>) == 4 * sizeof(float), "v4a<float> must fill 16 aligned bytes without padding.");
+static_assert(alignof(v2<double, 16>) == 16 && sizeof(v2<double, 16>) == 2 * sizeof(double), "v2<double, 16> must fill 16 aligned bytes without padding.");
+static_assert(std::is_trivially_copyable<v4a<float>>::value && std::is_standard_layout<v4a<float>>::value, "v4a must stay a plain value.");
+
+/**
+ * \brief Bulk operations over contiguous arrays of v2, v3 or v4.
+ * The arrays are processed as flat arrays of components in a single loop without branches,
+ * which the compiler vectorizes. out may be the same array as an input.
+ */
+namespace span {
+
+    template <typename V>
+    struct traits;
+
+    template <typename T, std::size_t Align>
+    struct traits<v2<T, Align>> {
+        using type = T;
+        static const size_t components = 2;
+    };
+
+    template <typename T, std::size_t Align>
+    struct traits<v3<T, Align>> {
+        using type = T;
+        static const size_t components = 3;
+    };
+
+    template <typename T, std::size_t Align>
+    struct traits<v4<T, Align>> {
+        using type = T;
+        static const size_t components = 4;
+    };
+
+    template <typename V>
+    const typename traits<V>::type* components(const V* v) {
+        static_assert(sizeof(V) == traits<V>::components * sizeof(typename traits<V>::type), "Vector type is padded.");
+        return &v->x;
+    }
+
+    template <typename V>
+    typename traits<V>::type* components(V* v) {
+        static_assert(sizeof(V) == traits<V>::components * sizeof(typename traits<V>::type), "Vector type is padded.");
+        return &v->x;
+    }
+
+    /**
+     * \brief out[i] = a[i] + b[i]
+     */
+    template <typename V>
+    void add(const V* a, const V* b, V* out, size_t count) {
+        auto pa = components(a);
+        auto pb = components(b);
+        auto po = components(out);
+        const auto n = count * traits<V>::components;
+        for (size_t i = 0; i < n; i++)
+            po[i] = pa[i] + pb[i];
+    }
+
+    /**
+     * \brief v[i] *= k
+     */
+    template <typename V>
+    void scale(V* v, size_t count, typename traits<V>::type k) {
+        auto p = components(v);
+        const auto n = count * traits<V>::components;
+        for (size_t i = 0; i < n; i++)
+            p[i] *= k;
+    }
+
+    /**
+     * \brief out[i] = a[i] * b[i] (dot product)
+     */
+    template <typename V>
+    void dot(const V* a, const V* b, typename traits<V>::type* out, size_t count) {
+        const auto c = traits<V>::components;
+        auto pa = components(a);
+        auto pb = components(b);
+        for (size_t i = 0; i < count; i++) {
+            typename traits<V>::type sum = 0;
+            for (size_t j = 0; j < c; j++)
+                sum += pa[i * c + j] * pb[i * c + j];
+            out[i] = sum;
+        }
+    }
+
+    /**
+     * \brief The sum of the dot products a[i] * b[i]
+     */
+    template <typename V>
+    double dot(const V* a, const V* b, size_t count) {
+        auto pa = components(a);
+        auto pb = components(b);
+        const auto n = count * traits<V>::components;
+        auto sum = 0.0;
+        for (size_t i = 0; i < n; i++)
+            sum += static_cast<double>(pa[i]) * pb[i];
+        return sum;
+    }
+
+}
@@ -86,18 +86,18 @@ bool CaptureAVTCamera::Open(int device) {
     unsigned long long t1 = get_now_us();
     int frameCount = 0;
     while (1) {
-        if (vimbaApiController.FrameAvailable()) {
-            unsigned char* buffer;
-            AVT::VmbAPI::FramePtr pFrame = vimbaApiController.GetFrame();
-            VmbErrorType err = SP_ACCESS( pFrame )->GetImage(buffer);
-            if (err == VmbErrorSuccess)
-                frameCount++;
-            vimbaApiController.QueueFrame(pFrame);
-
-            if (frameCount == 20)
-                break;
-        }
-        std::this_thread::sleep_for(std::chrono::microseconds(10));
+        AVT::VmbAPI::FramePtr pFrame = vimbaApiController.WaitFrame(std::chrono::seconds(1));
+        if (SP_ISNULL( pFrame ))
+            continue;
+
+        unsigned char* buffer;
+        VmbErrorType err = SP_ACCESS( pFrame )->GetImage(buffer);
+        if (err == VmbErrorSuccess)
+            frameCount++;
+        vimbaApiController.QueueFrame(pFrame);
+
+        if (frameCount == 20)
+            break;
     }
     unsigned long long t2 = get_now_us();
     double delay = (t2 - t1) / 1000000.0;
@@ -121,25 +121,9 @@ void CaptureAVTCamera::Close() {
 }
 
 bool CaptureAVTCamera::GetNextFrame() {
-    bool gotFrame = false;
-    unsigned long long startTime = get_now_us();
-
-    // try to get a frame during x useconds
-    while (1) {
-        if (vimbaApiController.FrameAvailable()) {
-            gotFrame = vimbaApiController.GetFrame(frame);
-        }
-
-        if (gotFrame)
-            break;
-        else if (get_now_us() - startTime > 1000000) {
-            return false;
-        }
-
-        // did not get a frame, wait a bit before retrying
-        std::this_thread::sleep_for(std::chrono::microseconds(100));
-        //	std::cout << "Waiting for a frame... " << startTime << "\t" << wxGetUTCTimeUSec() << std::endl;
-    }
+    // sleep until a frame arrives, for at most a second
+    if (!vimbaApiController.WaitFrame(frame, std::chrono::seconds(1)))
+        return false;
 
     frameNumber++;
     lastFrameTime = InternalGetTime();
@@ -182,12 +166,14 @@ void CaptureAVTCamera::Play() {
 
 bool CaptureAVTCamera::GetFrame(double time) {
     time *= 1000000.0;
-    while (InternalGetTime() < time)
-        this_thread::sleep_for(chrono::milliseconds(10));
 
-    if (vimbaApiController.FrameAvailable())
-        vimbaApiController.GetFrame(frame);
-    else
+    // sleep for the remaining time at once, it only has to be checked again while paused
+    unsigned long long now;
+    while ((now = InternalGetTime()) < time)
+        this_thread::sleep_for(chrono::microseconds(static_cast<long long>(time - now)));
+
+    // a frame still in flight is waited for up to one frame period
+    if (!vimbaApiController.WaitFrame(frame, chrono::microseconds(playTimestep)))
         return false;
 
     frameNumber++;
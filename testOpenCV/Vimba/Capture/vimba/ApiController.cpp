@@ -125,7 +125,8 @@ namespace AVT {
 
                             if (VmbErrorSuccess == res) {
                                 // Create a frame observer for this camera (This will be wrapped in a shared_ptr so we don't delete it)
-                                SP_SET( m_pFrameObserver , new FrameObserver( m_pCamera ) );
+                                // The camera never holds more than NUM_FRAMES frames, so the ring can not run full
+                                SP_SET( m_pFrameObserver , new FrameObserver( m_pCamera, NUM_FRAMES ) );
                                 // Start streaming
                                 res = SP_ACCESS( m_pCamera )->StartContinuousImageAcquisition(NUM_FRAMES, m_pFrameObserver);
                             }
@@ -172,11 +173,26 @@ namespace AVT {
             return SP_DYN_CAST( m_pFrameObserver, FrameObserver )->GetFrame();
         }
 
+        // Waits for the oldest frame that has not been picked up yet
+        FramePtr ApiController::WaitFrame(std::chrono::microseconds timeout) {
+            return SP_DYN_CAST( m_pFrameObserver, FrameObserver )->WaitFrame(timeout);
+        }
+
         // Get the oldest frame and encode data in the given Mat
         bool ApiController::GetFrame(cv::Mat& m) {
+            return CopyFrame(GetFrame(), m);
+        }
+
+        // Wait for the oldest frame and encode data in the given Mat
+        bool ApiController::WaitFrame(cv::Mat& m, std::chrono::microseconds timeout) {
+            return CopyFrame(WaitFrame(timeout), m);
+        }
+
+        bool ApiController::CopyFrame(FramePtr frame, cv::Mat& m) {
             bool success = false;
 
-            FramePtr frame = SP_DYN_CAST( m_pFrameObserver, FrameObserver )->GetFrame();
+            if (SP_ISNULL( frame ))
+                return false;
 
             VmbFrameStatusType status;
             frame->GetReceiveStatus(status);
@@ -30,6 +30,7 @@
 #ifndef AVT_VMBAPI_EXAMPLES_APICONTROLLER
 #define AVT_VMBAPI_EXAMPLES_APICONTROLLER
 
+#include <chrono>
 #include <string>
 
 #include <VimbaCPP/Include/VimbaCPP.h>
@@ -59,6 +60,8 @@ namespace AVT {
             CameraPtrVector GetCameraList();
             FramePtr GetFrame();
             bool GetFrame(cv::Mat& m);
+            FramePtr WaitFrame(std::chrono::microseconds timeout);
+            bool WaitFrame(cv::Mat& m, std::chrono::microseconds timeout);
             bool FrameAvailable();
             unsigned int GetQueueFrameSize();
             VmbErrorType QueueFrame(FramePtr pFrame);
@@ -71,6 +74,8 @@ namespace AVT {
             std::string GetVersion() const;
 
         private:
+            bool CopyFrame(FramePtr frame, cv::Mat& m);
+
             // A reference to our Vimba singleton
             VimbaSystem& m_system;
             // The currently streaming camera
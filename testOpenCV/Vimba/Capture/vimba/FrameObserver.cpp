@@ -39,15 +39,19 @@ namespace AVT {
 
             //    if( pFrame->GetReceiveStatus( eReceiveStatus ) == VmbFrameStatusComplete )
             if (pFrame->GetReceiveStatus(eReceiveStatus) == VmbErrorSuccess) {
-                // Lock the frame queue
-                m_FramesMutex.lock();
-                // Add frame to queue
-                m_Frames.push(pFrame);
-                // Unlock frame queue
-                m_FramesMutex.unlock();
-                // Emit the frame received signal
-                //        emit FrameReceivedSignal( eReceiveStatus );
-                bQueueDirectly = false;
+                // Add frame to the ring, a full ring hands the frame straight back to the camera
+                FramePtr frame = pFrame;
+                if (m_Frames.try_push(std::move(frame))) {
+                    // Pairs with the fence in WaitFrame, either the consumer sees the frame or we see it waiting
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (m_Waiting.load(std::memory_order_relaxed)) {
+                        std::lock_guard<std::mutex> lock(m_WaitMutex);
+                        m_FrameArrived.notify_one();
+                    }
+                    // Emit the frame received signal
+                    //        emit FrameReceivedSignal( eReceiveStatus );
+                    bQueueDirectly = false;
+                }
 
                 //	std::cout << "Received a frame, pushing to queue, size " << m_Frames.size() << std::endl;
             }
@@ -60,37 +64,39 @@ namespace AVT {
 
         // Returns the oldest frame that has not been picked up yet
         FramePtr FrameObserver::GetFrame() {
-            // Lock the frame queue
-            m_FramesMutex.lock();
+            FramePtr res;
+            m_Frames.try_pop(res);
+            return res;
+        }
 
+        // Returns the oldest frame, sleeping until one arrives if there is none yet
+        FramePtr FrameObserver::WaitFrame(std::chrono::microseconds timeout) {
             FramePtr res;
-            if (!m_Frames.empty()) {
-                // Pop frame from queue
-                res = m_Frames.front();
-                m_Frames.pop();
-            }
+            if (m_Frames.try_pop(res))
+                return res;
+
+            std::unique_lock<std::mutex> lock(m_WaitMutex);
+            m_Waiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            m_FrameArrived.wait_for(lock, timeout, [&] { return m_Frames.try_pop(res); });
 
-            // Unlock frame queue
-            m_FramesMutex.unlock();
+            m_Waiting.store(false, std::memory_order_relaxed);
             return res;
         }
 
         bool FrameObserver::FrameAvailable() {
-            return (m_Frames.size() > 0);
+            return !m_Frames.empty();
         }
 
         unsigned int FrameObserver::GetQueueFrameSize() {
-            return m_Frames.size();
+            return static_cast<unsigned int>(m_Frames.size());
         }
 
         void FrameObserver::ClearFrameQueue() {
-            // Lock the frame queue
-            m_FramesMutex.lock();
-            // Clear the frame queue and release the memory
-            std::queue<FramePtr> empty;
-            std::swap(m_Frames, empty);
-            // Unlock the frame queue
-            m_FramesMutex.unlock();
+            // Drop the frames that have not been picked up and release the memory
+            FramePtr frame;
+            while (m_Frames.try_pop(frame)) { }
         }
 
     }
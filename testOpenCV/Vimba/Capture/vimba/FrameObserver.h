@@ -29,9 +29,13 @@
 #ifndef AVT_VMBAPI_EXAMPLES_FRAMEOBSERVER
 #define AVT_VMBAPI_EXAMPLES_FRAMEOBSERVER
 
-#include <queue>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 
+#include "Util/SpscRing.h"
+
 //#include <QObject>
 //#include <QMutex>
 
@@ -40,13 +44,18 @@
 namespace AVT {
     namespace VmbAPI {
 
+        // Hands the received frames from the Vimba callback thread to one consumer thread
+        // through a lock-free ring, the consumer can block until a frame arrives
         class FrameObserver : virtual public IFrameObserver {
             //    Q_OBJECT
 
         public:
-            // We pass the camera that will deliver the frames to the constructor
-            FrameObserver(CameraPtr pCamera)
-                : IFrameObserver(pCamera) { ; }
+            // We pass the camera that will deliver the frames to the constructor,
+            // the ring should hold at least as many frames as are announced to the camera
+            FrameObserver(CameraPtr pCamera, size_t capacity = 8)
+                : IFrameObserver(pCamera)
+                  , m_Frames(capacity)
+                  , m_Waiting(false) { ; }
 
             // This is our callback routine that will be executed on every received frame
             virtual void FrameReceived(const FramePtr pFrame);
@@ -54,6 +63,9 @@ namespace AVT {
             // After the view has been notified about a new frame it can pick it up
             FramePtr GetFrame();
 
+            // Waits for the next frame, returns an empty FramePtr if none arrived within the timeout
+            FramePtr WaitFrame(std::chrono::microseconds timeout);
+
             bool FrameAvailable();
             unsigned int GetQueueFrameSize();
 
@@ -63,9 +75,14 @@ namespace AVT {
         private:
             // Since a Qt signal cannot contain a whole frame
             // the frame observer stores all FramePtr
-            std::queue<FramePtr> m_Frames;
-            std::mutex m_FramesMutex;
-            //    QMutex m_FramesMutex;
+            SpscRing<FramePtr> m_Frames;
+
+            // Only taken to sleep and to wake a sleeping consumer, never to pass a frame
+            std::mutex m_WaitMutex;
+            std::condition_variable m_FrameArrived;
+
+            // Set while the consumer is about to sleep, the callback only notifies then
+            std::atomic<bool> m_Waiting;
 
             //  signals:
             // The frame received event that passes the frame directly
@@ -1,20 +1,13 @@
 @echo off
-set /a "x = 1"
 set /p mm="Enter mm for this run : "
 set /p fram="Enter runs : "
 
-:while1
-
-if %x% leq %fram% (
-
-    echo Running frame test %x% of %fram%..
-    ThicknessGauge.exe -d --glob_name=camera --show_windows=0 >> mm_%mm%_runs_%fram%_.txt
-	REM | type mm_%mm%_runs_%fram%_.txt
-    set /a "x = x + 1"
-    goto :while1
-)
+REM one process keeps the camera open and measures once per line
+echo Running %fram% frame tests..
+(for /l %%x in (1,1,%fram%) do @echo measure) | ThicknessGauge.exe -d --glob_name=camera --show_windows=0 --session=1 >> mm_%mm%_runs_%fram%_.txt
 
 find "diff from baseline" mm_%mm%_runs_%fram%_.txt >> mm_%mm%_runs_%fram%_results.txt
 find "near_height" mm_%mm%_runs_%fram%_.txt >> mm_%mm%_runs_%fram%_results.txt
+find "Session :" mm_%mm%_runs_%fram%_.txt >> mm_%mm%_runs_%fram%_results.txt
 
 endlocal
\ No newline at end of file
@@ -8,6 +8,11 @@
 
 namespace cvr {
 
+    cv::Mat copy_counted(const cv::Mat& image, size_t& bytes_copied) {
+        bytes_copied += image.total() * image.elemSize();
+        return image.clone();
+    }
+
     void split_frames(std::vector<cv::Mat>& frames, std::vector<cv::Mat>& left_out, std::vector<cv::Mat>& right_out) {
 
         cv::Point top_left(0, 0);
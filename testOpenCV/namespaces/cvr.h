@@ -461,6 +461,14 @@ namespace cvr {
         return sum / static_cast<double>(count);
     }
 
+    /**
+     * \brief Deep copies an image that is about to be written to, and accounts for the copied bytes
+     * \param image The image to copy
+     * \param bytes_copied Incremented by the number of pixel bytes copied
+     * \return The copy
+     */
+    cv::Mat copy_counted(const cv::Mat& image, size_t& bytes_copied);
+
     /**
      * \brief Converts an image type to string
      * \param type The type to convert
@@ -2,42 +2,81 @@
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgproc/imgproc_c.h>
 #include <opencv2/videostab/ring_buffer.hpp>
+#ifndef TG_HEADLESS
 #include <opencv2/highgui/highgui.hpp>
+#endif
 
 #include "tg.h"
 
+/**
+ * Defining TG_HEADLESS compiles out all visualization. Window, trackbar and key functions
+ * become no-ops and the processing classes never touch HighGUI.
+ * The project defines it when built with the Headless property, msbuild /p:Headless=true.
+ */
 namespace draw {
 
+#ifdef TG_HEADLESS
+    constexpr bool headless = true;
+#else
+    constexpr bool headless = false;
+#endif
+
     constexpr int ESC = 27;
 
     const cv::Scalar colour = cv::Scalar(255, 255, 255);
 
+    using trackbar_callback = void (*)(int, void*);
+
     inline char get_key(const int delay) {
+#ifdef TG_HEADLESS
+        return -1;
+#else
         return static_cast<char>(cv::waitKey(delay));
+#endif
     }
 
     inline bool is_escape_pressed(const int delay) {
         return get_key(delay) == ESC;
     }
 
+    template <typename T>
+    void makeWindow(T name, bool keep_ratio) {
+#ifndef TG_HEADLESS
+        cv::namedWindow(name, keep_ratio ? cv::WINDOW_KEEPRATIO : cv::WINDOW_FREERATIO | cv::WINDOW_GUI_EXPANDED);
+#endif
+    }
+
     template <typename T>
     void makeWindow(T name) {
-        cv::namedWindow(name, cv::WINDOW_FREERATIO | cv::WINDOW_GUI_EXPANDED);
+        makeWindow(name, false);
+    }
+
+    template <typename T>
+    void makeTrackbar(const std::string& name, T windowName, int* value, int count, trackbar_callback callback, void* user_data) {
+#ifndef TG_HEADLESS
+        cv::createTrackbar(name, windowName, value, count, callback, user_data);
+#endif
     }
 
     template <typename T>
     void removeWindow(T name) {
+#ifndef TG_HEADLESS
         cv::destroyWindow(name);
         cv::waitKey(1);
+#endif
     }
 
     inline void removeAllWindows() {
+#ifndef TG_HEADLESS
         cv::destroyAllWindows();
+#endif
     }
 
     template <typename T>
-    void showImage(T windowName, cv::Mat& image) {
+    void showImage(T windowName, const cv::Mat& image) {
+#ifndef TG_HEADLESS
         cv::imshow(windowName, image);
+#endif
     }
 
     template <typename T>
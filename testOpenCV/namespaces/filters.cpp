@@ -0,0 +1,158 @@
+//          Copyright Rudy Alex Kohn 2017.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "filters.h"
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace filters {
+
+    namespace {
+
+        /**
+         * \brief Horizontal pass, each output value is the sum of kw consecutive source values
+         * \param padded The border padded source
+         * \param sums The row sums, padded.rows x (padded.cols - kw + 1)
+         * \param kw The kernel width
+         */
+        template <typename Tsrc, typename Tacc>
+        void box_rows(const cv::Mat& padded, cv::Mat& sums, int kw) {
+            const auto width = sums.cols;
+            for (auto y = 0; y < padded.rows; y++) {
+                auto src = padded.ptr<Tsrc>(y);
+                auto dst = sums.ptr<Tacc>(y);
+                Tacc sum = 0;
+                for (auto x = 0; x < kw; x++)
+                    sum += static_cast<Tacc>(src[x]);
+                dst[0] = sum;
+                for (auto x = 1; x < width; x++) {
+                    sum += static_cast<Tacc>(src[x + kw - 1]) - static_cast<Tacc>(src[x - 1]);
+                    dst[x] = sum;
+                }
+            }
+        }
+
+        /**
+         * \brief Vertical pass, keeps a running column sum over kh rows of the row sums
+         * \param sums The row sums from box_rows()
+         * \param dst The destination, (sums.rows - kh + 1) x sums.cols
+         * \param kh The kernel height
+         * \param scale The kernel element value
+         * \param delta The value to add to each result
+         */
+        template <typename Tacc, typename Tdst>
+        void box_cols(const cv::Mat& sums, cv::Mat& dst, int kh, double scale, double delta) {
+            const auto width = sums.cols;
+            std::vector<Tacc> column(width, 0);
+
+            for (auto y = 0; y < kh; y++) {
+                auto s = sums.ptr<Tacc>(y);
+                for (auto x = 0; x < width; x++)
+                    column[x] += s[x];
+            }
+
+            for (auto y = 0; y < dst.rows; y++) {
+                auto out = dst.ptr<Tdst>(y);
+                for (auto x = 0; x < width; x++)
+                    out[x] = cv::saturate_cast<Tdst>(column[x] * scale + delta);
+
+                if (y + 1 == dst.rows)
+                    break;
+
+                auto add = sums.ptr<Tacc>(y + kh);
+                auto sub = sums.ptr<Tacc>(y);
+                for (auto x = 0; x < width; x++)
+                    column[x] += add[x] - sub[x];
+            }
+        }
+
+        template <typename Tacc>
+        void box_cols_dispatch(const cv::Mat& sums, cv::Mat& dst, int kh, double scale, double delta) {
+            switch (dst.depth()) {
+            case CV_8U:
+                box_cols<Tacc, uchar>(sums, dst, kh, scale, delta);
+                break;
+            case CV_16U:
+                box_cols<Tacc, ushort>(sums, dst, kh, scale, delta);
+                break;
+            case CV_16S:
+                box_cols<Tacc, short>(sums, dst, kh, scale, delta);
+                break;
+            case CV_32F:
+                box_cols<Tacc, float>(sums, dst, kh, scale, delta);
+                break;
+            case CV_64F:
+                box_cols<Tacc, double>(sums, dst, kh, scale, delta);
+                break;
+            default:
+                CV_Error(cv::Error::StsUnsupportedFormat, "Unsupported destination depth for box filter.");
+            }
+        }
+
+        template <typename Tsrc, typename Tacc>
+        void box_filter(const cv::Mat& padded, cv::Mat& dst, int acc_type, cv::Size ksize, double scale, double delta) {
+            cv::Mat sums(padded.rows, dst.cols, acc_type);
+            box_rows<Tsrc, Tacc>(padded, sums, ksize.width);
+            box_cols_dispatch<Tacc>(sums, dst, ksize.height, scale, delta);
+        }
+
+    }
+
+    bool is_box_kernel(const cv::Mat& kernel, double& scale) {
+        if (kernel.empty() || kernel.channels() != 1)
+            return false;
+
+        double min_val;
+        double max_val;
+        cv::minMaxLoc(kernel, &min_val, &max_val);
+
+        if (min_val != max_val || min_val == 0.0)
+            return false;
+
+        scale = min_val;
+        return true;
+    }
+
+    void box_filter(const cv::Mat& src, cv::Mat& dst, int ddepth, cv::Size ksize, cv::Point anchor, double scale, double delta, int border) {
+        CV_Assert(src.channels() == 1 && ksize.width > 0 && ksize.height > 0);
+
+        if (anchor.x < 0)
+            anchor.x = ksize.width / 2;
+        if (anchor.y < 0)
+            anchor.y = ksize.height / 2;
+
+        if (ddepth < 0)
+            ddepth = src.depth();
+
+        // extrapolate the border exactly as filter2D would
+        cv::Mat padded;
+        cv::copyMakeBorder(src, padded, anchor.y, ksize.height - anchor.y - 1, anchor.x, ksize.width - anchor.x - 1, border);
+
+        // the destination may alias the source, the padded copy keeps the source data alive
+        dst.create(src.size(), CV_MAKETYPE(ddepth, 1));
+
+        // integer sums are exact for 8 bit input, everything else uses double to avoid overflow
+        switch (src.depth()) {
+        case CV_8U:
+            box_filter<uchar, int>(padded, dst, CV_32S, ksize, scale, delta);
+            break;
+        case CV_16U:
+            box_filter<ushort, double>(padded, dst, CV_64F, ksize, scale, delta);
+            break;
+        case CV_16S:
+            box_filter<short, double>(padded, dst, CV_64F, ksize, scale, delta);
+            break;
+        case CV_32F:
+            box_filter<float, double>(padded, dst, CV_64F, ksize, scale, delta);
+            break;
+        case CV_64F:
+            box_filter<double, double>(padded, dst, CV_64F, ksize, scale, delta);
+            break;
+        default:
+            CV_Error(cv::Error::StsUnsupportedFormat, "Unsupported source depth for box filter.");
+        }
+    }
+
+}
@@ -29,4 +29,27 @@ namespace filters {
         0
     );
 
+    /**
+     * \brief Determine if a kernel is a box kernel, i.e. all values are equal and non-zero
+     * \param kernel The kernel to check (single channel)
+     * \param scale Receives the value of each kernel element if it is a box kernel
+     * \return true if the kernel can be applied with box_filter(), otherwise false
+     */
+    bool is_box_kernel(const cv::Mat& kernel, double& scale);
+
+    /**
+     * \brief Applies a box kernel using separable running sums, O(1) per pixel regardless of kernel size.
+     * The output matches cv::filter2D() with a kernel of ksize where every element is scale, to within rounding.
+     * Border pixels are extrapolated the same way as filter2D (including use of pixels outside a ROI).
+     * \param src The single channel source image (8U, 16U, 16S, 32F or 64F)
+     * \param dst The destination image
+     * \param ddepth The depth of dst, a negative value means the same as src
+     * \param ksize The size of the kernel
+     * \param anchor The kernel anchor, (-1, -1) indicates the center
+     * \param scale The value of each kernel element
+     * \param delta The value added to each filtered pixel
+     * \param border The border type
+     */
+    void box_filter(const cv::Mat& src, cv::Mat& dst, int ddepth, cv::Size ksize, cv::Point anchor, double scale, double delta, int border);
+
 }
@@ -12,6 +12,10 @@
  */
 namespace stl {
 
+    /**
+     * \brief Inserts the source at the front of the destination.
+     * Every call moves the existing elements, use ChunkedVector (Util/ChunkedVector.h) to accumulate many ranges.
+     */
     template <typename T1, typename T2>
     void copy_vector(T1& source, T2& destination) {
         static_assert(std::is_convertible<T1, T2>::value, "Types are not convertible.");
@@ -34,8 +38,8 @@ namespace stl {
      * \param vec The vector to fill
      * \param limit The limit for X
      */
-    template <typename T>
-    void populate_x(std::vector<cv::Point_<T>>& vec, const size_t limit) {
+    template <typename T, typename Alloc>
+    void populate_x(std::vector<cv::Point_<T>, Alloc>& vec, const size_t limit) {
         static_assert(std::is_arithmetic<T>::value, "type is only possible for arithmetic types.");
         vec.clear();
         vec.reserve(limit);
@@ -51,8 +55,8 @@ namespace stl {
      * \tparam T The type
      * \param vec The vector to reset all Y values in
      */
-    template <typename T>
-    void reset_point_y(std::vector<cv::Point_<T>>& vec) {
+    template <typename T, typename Alloc>
+    void reset_point_y(std::vector<cv::Point_<T>, Alloc>& vec) {
         static_assert(std::is_arithmetic<T>::value, "type is only possible for arithmetic types.");
         T zero = static_cast<T>(0);
         std::for_each(vec.begin(), vec.end(), [zero](cv::Point_<T>& p) {